@@ -0,0 +1,69 @@
+#ifndef MEMOIR_EXPRESSIONARENA_H
+#define MEMOIR_EXPRESSIONARENA_H
+#pragma once
+
+// LLVM
+#include "llvm/Support/Allocator.h"
+
+// MemOIR
+#include "memoir/analysis/ValueExpression.hpp"
+
+#include "memoir/support/InternalDatatypes.hpp"
+
+/*
+ * This file contains an arena for ValueExpressions.
+ *
+ * Expressions are bump allocated and freed in bulk when the arena is
+ * destroyed. Interned expressions are hash-consed, so two interned expressions
+ * are structurally equal iff they are the same pointer.
+ */
+
+namespace llvm::memoir {
+
+class ExpressionArena {
+public:
+  ExpressionArena() {}
+
+  ~ExpressionArena();
+
+  // This class is not cloneable nor assignable.
+  ExpressionArena(ExpressionArena &other) = delete;
+  void operator=(const ExpressionArena &) = delete;
+
+  /**
+   * Allocate a new expression in the arena, without interning it.
+   * Use this for expressions whose arguments are not yet known.
+   */
+  template <typename ExprTy, typename... ArgTys>
+  ExprTy &create(ArgTys &&... args) {
+    auto *memory = this->allocator.Allocate<ExprTy>();
+    auto *expr = new (memory) ExprTy(std::forward<ArgTys>(args)...);
+    this->expressions.push_back(expr);
+    return *expr;
+  }
+
+  /**
+   * Allocate a new expression in the arena and intern it.
+   * Returns the canonical expression.
+   */
+  template <typename ExprTy, typename... ArgTys>
+  ValueExpression &get(ArgTys &&... args) {
+    return this->intern(this->create<ExprTy>(std::forward<ArgTys>(args)...));
+  }
+
+  /**
+   * Intern the expression @E, whose arguments must already be interned.
+   * Returns the canonical expression structurally equal to @E.
+   */
+  ValueExpression &intern(ValueExpression &E);
+
+protected:
+  // Owned state.
+  llvm::BumpPtrAllocator allocator;
+  vector<ValueExpression *> expressions;
+  map<size_t, vector<ValueExpression *>> interned;
+};
+
+} // namespace llvm::memoir
+
+#endif
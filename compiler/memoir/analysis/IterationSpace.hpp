@@ -0,0 +1,59 @@
+#ifndef MEMOIR_ITERATIONSPACE_H
+#define MEMOIR_ITERATIONSPACE_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/InstrTypes.h"
+#include "llvm/IR/Instructions.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/support/InternalDatatypes.hpp"
+
+/*
+ * This file provides an analysis of the iteration space of simple counted
+ * loops, found with NOELLE's loop-governing induction variable.
+ */
+
+namespace llvm::memoir {
+
+/**
+ * The iteration space of a loop, [start, end) stepping by one.
+ */
+struct IterationSpace {
+  llvm::BasicBlock *preheader;
+  llvm::BasicBlock *header;
+  llvm::BasicBlock *latch;
+
+  llvm::PHINode *induction_variable;
+  llvm::Value *start;
+  llvm::Value *end;
+
+  // The condition to stay in the loop, either ICMP_SLT or ICMP_ULT.
+  llvm::CmpInst::Predicate predicate;
+};
+
+/**
+ * Analyzes the iteration space of loop @L, whose loop structure is @LS and
+ * whose induction variables are managed by @IVM.
+ *
+ * The loop must exit only from its header, and its governing induction
+ * variable must step by one and be compared against a loop-invariant bound
+ * by a less-than comparison.
+ *
+ * @returns The iteration space of @L, or nothing if it is not a simple
+ *          counted loop.
+ */
+opt<IterationSpace> analyze_iteration_space(
+    llvm::Loop &L,
+    arcana::noelle::LoopStructure &LS,
+    arcana::noelle::InductionVariableManager &IVM);
+
+} // namespace llvm::memoir
+
+#endif
@@ -1,7 +1,11 @@
 #ifndef MEMOIR_ANALYSIS_LIVERANGEANALYSIS_H
 #define MEMOIR_ANALYSIS_LIVERANGEANALYSIS_H
 
+#include <functional>
+
 // LLVM
+#include "llvm/ADT/ArrayRef.h"
+
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
@@ -10,9 +14,9 @@
 #include "noelle/core/Noelle.hpp"
 
 // MEMOIR
+#include "memoir/analysis/ExpressionArena.hpp"
 #include "memoir/analysis/RangeAnalysis.hpp"
 
-#include "memoir/support/Graph.hpp"
 #include "memoir/support/InternalDatatypes.hpp"
 
 namespace llvm::memoir {
@@ -70,13 +74,13 @@ public:
    * Perform the disjunctive merge of two value ranges, range1 and range2.
    * Returns the resultant value range.
    */
-  static ValueRange *disjunctive_merge(ValueRange *range1, ValueRange *range2);
+  ValueRange *disjunctive_merge(ValueRange *range1, ValueRange *range2);
 
   /**
    * Perform the conjunctive merge of two value ranges, range1 and range2.
    * Returns the resultant value range.
    */
-  static ValueRange *conjunctive_merge(ValueRange *range1, ValueRange *range2);
+  ValueRange *conjunctive_merge(ValueRange *range1, ValueRange *range2);
 
 protected:
   // Analysis driver.
@@ -87,12 +91,24 @@ protected:
   void evaluate(LiveRangeConstraintGraph &graph);
 
   // Analysis helpers.
+  void summarize_calls();
+  ValueRange &create_value_range(ValueExpression &lower,
+                                 ValueExpression &upper);
+  ValueRange &create_overdefined_range();
+  ValueExpression &create_min(ValueExpression &expr1, ValueExpression &expr2);
+  ValueExpression &create_max(ValueExpression &expr1, ValueExpression &expr2);
 
   // Query helpers.
   ValueRange *lookup_live_range(llvm::Value &V, llvm::CallBase *C) const;
 
+  // The number of times a node may change before it is widened.
+  static constexpr unsigned max_node_updates = 8;
+
   // Owned state.
   map<llvm::Function *, RangeAnalysis *> intraprocedural_range_analyses;
+  ExpressionArena arena;
+  set<ValueRange *> ranges;
+  ValueRange *overdefined_range = nullptr;
 
   // Borrowed state.
   map<llvm::Value *, map<llvm::CallBase *, ValueRange *>> live_ranges;
@@ -107,13 +123,25 @@ public:
 
 using Constraint = std::function<ValueRange *(ValueRange *)>;
 
-struct LiveRangeConstraintGraph
-  : public DirectedGraph<llvm::Value *, Constraint, ValueRange *> {
+/**
+ * The live range constraint graph.
+ * Nodes are sequence variables and index values, an edge propagates the range
+ * of its source to its destination through a constraint. Once constructed, the
+ * graph is finalized into a compressed sparse row (CSR) adjacency.
+ */
+struct LiveRangeConstraintGraph {
 public:
+  using NodeID = unsigned;
+  using EdgeID = unsigned;
+
+  struct Edge {
+    NodeID from;
+    NodeID to;
+    Constraint constraint;
+  };
+
   // Constraints.
-  ValueRange *propagate_edge(llvm::Value *from,
-                             llvm::Value *to,
-                             Constraint constraint);
+  ValueRange *propagate_edge(EdgeID edge);
 
   // Construction.
   void add_uses_to_graph(RangeAnalysis &RA, llvm::Instruction &I);
@@ -121,6 +149,44 @@ public:
   void add_index_use_to_graph(llvm::Use &U, llvm::Value &C);
   void add_index_to_graph(llvm::Value &V, ValueRange &VR);
   void add_seq_to_graph(llvm::Value &V);
+
+  /**
+   * Build the CSR adjacency, no edges may be added afterwards.
+   */
+  void finalize();
+
+  // Queries.
+  unsigned size() const;
+  llvm::Value &get_node(NodeID node) const;
+  ValueRange *&node_prop(NodeID node);
+  const Edge &get_edge(EdgeID edge) const;
+  llvm::ArrayRef<EdgeID> incoming(NodeID node) const;
+  llvm::ArrayRef<EdgeID> outgoing(NodeID node) const;
+
+  /**
+   * Computes the strongly connected components of the graph, returned in
+   * topological order.
+   */
+  vector<vector<NodeID>> strongly_connected_components() const;
+
+protected:
+  NodeID add_node(llvm::Value &V, ValueRange *VR);
+  void add_edge(llvm::Value &from, llvm::Value &to, Constraint constraint);
+
+  // Nodes.
+  map<llvm::Value *, NodeID> node_ids;
+  vector<llvm::Value *> nodes;
+  vector<ValueRange *> node_props;
+
+  // Edges, in insertion order.
+  vector<Edge> edges;
+
+  // CSR adjacency, the edges of node N are [offsets[N], offsets[N+1]).
+  vector<unsigned> incoming_offsets;
+  vector<EdgeID> incoming_edges;
+  vector<unsigned> outgoing_offsets;
+  vector<EdgeID> outgoing_edges;
+  bool finalized = false;
 };
 
 } // namespace llvm::memoir
@@ -2,18 +2,28 @@
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
 
-#include "noelle/core/DataFlow.hpp"
+#include "llvm/ADT/SparseBitVector.h"
 
 #include "memoir/support/InternalDatatypes.hpp"
 
 #include "memoir/ir/InstVisitor.hpp"
 #include "memoir/ir/Instructions.hpp"
 
+/*
+ * This file contains a liveness analysis for MEMOIR collection variables.
+ *
+ * Collection values are numbered densely, so that the live sets of each basic
+ * block are sparse bit vectors, solved for with a worklist. The live sets of
+ * each instruction are materialized on demand, one basic block at a time.
+ */
+
 namespace llvm::memoir {
 class LivenessAnalysis {
 public:
+  using LiveSetTy = llvm::SparseBitVector<>;
+
   // Construction and analysis invocation.
-  LivenessAnalysis(llvm::Function &F, arcana::noelle::DataFlowEngine DFE);
+  LivenessAnalysis(llvm::Function &F);
 
   // Queries.
   bool is_live(llvm::Value &V, MemOIRInst &I, bool after = true);
@@ -23,9 +33,31 @@ public:
                                            bool after = true);
 
 protected:
+  // Numbering.
+  opt<unsigned> get_id(llvm::Value &V) const;
+  unsigned number(llvm::Value &V);
+
+  // Analysis.
+  void analyze();
+  void materialize(llvm::BasicBlock &BB);
+
+  // Per-block results.
+  struct BlockSets {
+    LiveSetTy uses;
+    LiveSetTy defs;
+    LiveSetTy live_in;
+    LiveSetTy live_out;
+  };
+
   llvm::Function &F;
-  arcana::noelle::DataFlowEngine DFE;
-  arcana::noelle::DataFlowResult *DFR;
+  map<llvm::Value *, unsigned> value_ids;
+  vector<llvm::Value *> values;
+  map<llvm::BasicBlock *, BlockSets> block_sets;
+
+  // Per-instruction results, materialized on demand.
+  set<llvm::BasicBlock *> materialized;
+  map<llvm::Instruction *, std::set<llvm::Value *>> live_before;
+  map<llvm::Instruction *, std::set<llvm::Value *>> live_after;
 };
 
 } // namespace llvm::memoir
@@ -11,6 +11,7 @@
 #include "noelle/core/Noelle.hpp"
 
 // MemOIR
+#include "memoir/analysis/ExpressionArena.hpp"
 #include "memoir/analysis/ValueExpression.hpp"
 #include "memoir/support/InternalDatatypes.hpp"
 
@@ -43,6 +44,12 @@ public:
    */
   ValueRange &get_value_range(llvm::Use &use);
 
+  /**
+   * Queries the value range for the given LLVM Use @use, returning NULL if the
+   * use has no range.
+   */
+  ValueRange *find_value_range(llvm::Use &use);
+
   /**
    * Prints the results of the Range Analysis.
    */
@@ -68,6 +75,7 @@ protected:
   ValueRange &create_overdefined_range();
 
   // Owned state.
+  ExpressionArena arena;
   set<ValueRange *> ranges;
   map<llvm::Use *, ValueRange *> use_to_range;
 
@@ -8,6 +8,7 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/ValueMap.h"
 
 #include "memoir/ir/InstVisitor.hpp"
 #include "memoir/ir/Types.hpp"
@@ -44,7 +45,17 @@ public:
 
   static Type *analyze(llvm::Value &V);
 
+  /*
+   * Invalidation
+   *
+   * Results are cached across passes, and entries for deleted values are
+   * dropped automatically. A pass that rewrites the values of a function
+   * should invalidate that function, or the values it changed. A pass that
+   * changes the type of a value must invalidate the whole analysis.
+   */
   static void invalidate();
+  static void invalidate(llvm::Function &F);
+  static void invalidate(llvm::Value &V);
 
   /*
    * Query the Type Summary for the given LLVM Value
@@ -66,8 +77,13 @@ protected:
   // Owned state
 
   // Borrowed state
-  map<llvm::Value *, Type *> value_to_type;
-  map<llvm::Instruction *, set<Type *>> edge_types;
+  struct CacheConfig : public llvm::ValueMapConfig<llvm::Value *> {
+    // Entries are dropped when their value is deleted, but are not moved over
+    // to the replacement, whose type may differ.
+    enum { FollowRAUW = false };
+  };
+  llvm::ValueMap<llvm::Value *, Type *, CacheConfig> value_to_type;
+  llvm::ValueMap<llvm::Value *, set<Type *>, CacheConfig> edge_types;
   map<llvm::Instruction *, set<llvm::Value *>> visited_edges;
   set<llvm::Value *> visited;
 
@@ -131,11 +147,14 @@ protected:
   //// SSA collection operations
   Type *visitInsertInst(InsertInst &I);
   Type *visitRemoveInst(RemoveInst &I);
+  Type *visitSeqFillInst(SeqFillInst &I);
   Type *visitSwapInst(SwapInst &I);
   Type *visitCopyInst(CopyInst &I);
+  Type *visitClearInst(ClearInst &I);
   //// Mut sequence operations
   Type *visitMutSeqInsertInst(MutSeqInsertInst &I);
   Type *visitMutSeqRemoveInst(MutSeqRemoveInst &I);
+  Type *visitMutSeqFillInst(MutSeqFillInst &I);
   Type *visitMutSeqAppendInst(MutSeqAppendInst &I);
   Type *visitMutSeqSwapInst(MutSeqSwapInst &I);
   Type *visitMutSeqSwapWithinInst(MutSeqSwapWithinInst &I);
@@ -150,6 +169,8 @@ protected:
   //// Mut assoc operations
   Type *visitMutAssocInsertInst(MutAssocInsertInst &I);
   Type *visitMutAssocRemoveInst(MutAssocRemoveInst &I);
+  //// Mut collection operations
+  Type *visitMutClearInst(MutClearInst &I);
   //// Type checking
   Type *visitAssertStructTypeInst(AssertStructTypeInst &I);
   Type *visitAssertCollectionTypeInst(AssertCollectionTypeInst &I);
@@ -159,6 +180,8 @@ protected:
   TypeAnalysis();
 
   void _invalidate();
+  void _invalidate(llvm::Function &F);
+  void _invalidate(llvm::Value &V);
 
   static TypeAnalysis *TA;
 };
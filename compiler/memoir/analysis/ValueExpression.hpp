@@ -3,6 +3,8 @@
 #pragma once
 
 // LLVM
+#include "llvm/ADT/Hashing.h"
+
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
@@ -65,11 +67,17 @@ public:
       commutative(commutative),
       is_memoir(is_memoir) {}
 
+  virtual ~ValueExpression() = default;
+
   ExpressionKind getKind() const;
 
   // Equality.
   virtual bool equals(const ValueExpression &E) const = 0;
 
+  // Structural hashing, arguments are hashed by identity.
+  virtual llvm::hash_code hash() const;
+  size_t getHash() const;
+
   // Accessors.
   llvm::Value *getValue() const;
   virtual llvm::Type *getLLVMType() const;
@@ -118,6 +126,10 @@ public:
   bool is_memoir;
   bool commutative;
 
+  // Interning state, the hash is precomputed when the expression is interned.
+  bool interned = false;
+  size_t hash_value = 0;
+
   // Materialization state.
   llvm::Function *function_version;
   llvm::ValueToValueMapTy *version_mapping;
@@ -214,6 +226,7 @@ public:
   }
 
   bool equals(const ValueExpression &E) const override;
+  llvm::hash_code hash() const override;
 
   bool isAvailable(llvm::Instruction &IP,
                    const llvm::DominatorTree *DT = nullptr,
@@ -254,6 +267,7 @@ public:
   };
 
   bool equals(const ValueExpression &E) const override;
+  llvm::hash_code hash() const override;
 
   bool isAvailable(llvm::Instruction &IP,
                    const llvm::DominatorTree *DT = nullptr,
@@ -281,6 +295,13 @@ public:
     this->arguments.push_back(&expr);
   }
 
+  static bool classof(const ValueExpression *E) {
+    return (E->getKind() == EK_Cast);
+  }
+
+  bool equals(const ValueExpression &E) const override;
+  llvm::hash_code hash() const override;
+
   ValueExpression &getOperand() const;
 
   llvm::Type &getDestType() const;
@@ -310,6 +331,13 @@ public:
     this->arguments.push_back(&RHS);
   }
 
+  static bool classof(const ValueExpression *E) {
+    return (E->getKind() == EK_ICmp);
+  }
+
+  bool equals(const ValueExpression &E) const override;
+  llvm::hash_code hash() const override;
+
   llvm::CmpInst::Predicate getPredicate() const;
   ValueExpression *getLHS() const;
   ValueExpression *getRHS() const;
@@ -343,6 +371,7 @@ public:
   }
 
   bool equals(const ValueExpression &E) const override;
+  llvm::hash_code hash() const override;
 
   llvm::BasicBlock &getIncomingBlock(unsigned index) const;
 
@@ -429,6 +458,7 @@ public:
   SizeExpression() : SizeExpression(nullptr) {}
 
   bool equals(const ValueExpression &E) const override;
+  llvm::hash_code hash() const override;
 
   bool isAvailable(llvm::Instruction &IP,
                    const llvm::DominatorTree *DT = nullptr,
@@ -488,6 +518,12 @@ LLVMTy *as(ValueExpression &E) {
   return dyn_cast_or_null<LLVMTy>(E.getValue());
 };
 
+/**
+ * Checks that @E1 and @E2 are different integer constants of the same type,
+ * such that they never hold the same value.
+ */
+bool is_distinct(ValueExpression &E1, ValueExpression &E2);
+
 } // namespace llvm::memoir
 
 #endif
@@ -18,6 +18,7 @@
 #include "memoir/ir/InstVisitor.hpp"
 #include "memoir/ir/Instructions.hpp"
 
+#include "memoir/analysis/ExpressionArena.hpp"
 #include "memoir/analysis/ValueExpression.hpp"
 
 namespace llvm::memoir {
@@ -57,6 +58,7 @@ public:
 protected:
   // Owned state.
   ValueTable VT;
+  ExpressionArena arena;
 
   // Borrowed state.
   llvm::Module &M;
@@ -70,6 +72,7 @@ protected:
   void insert(MemOIRInst &I, ValueExpression *expr);
   ValueExpression *lookupOrInsert(llvm::Value &V, ValueExpression *expr);
   ValueExpression *lookupOrInsert(llvm::Use &U, ValueExpression *expr);
+  ValueExpression *intern(llvm::Value &V, ValueExpression *expr);
 
   // Value visitor methods.
   ValueExpression *visitUse(llvm::Use &U);
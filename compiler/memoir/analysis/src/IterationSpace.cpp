@@ -0,0 +1,86 @@
+// LLVM
+#include "llvm/IR/Constants.h"
+
+// MemOIR
+#include "memoir/analysis/IterationSpace.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+
+namespace llvm::memoir {
+
+opt<IterationSpace> analyze_iteration_space(
+    llvm::Loop &L,
+    arcana::noelle::LoopStructure &LS,
+    arcana::noelle::InductionVariableManager &IVM) {
+  IterationSpace space;
+  space.header = L.getHeader();
+  space.preheader = L.getLoopPreheader();
+  space.latch = L.getLoopLatch();
+
+  // The header must be the only way out of the loop, so that every other
+  // block dominating the latch executes once per iteration.
+  if (space.preheader == nullptr || space.latch == nullptr
+      || L.getExitingBlock() != space.header) {
+    return {};
+  }
+
+  auto *LGIV = IVM.getLoopGoverningInductionVariable(LS);
+  if (LGIV == nullptr) {
+    return {};
+  }
+  auto &IV = MEMOIR_SANITIZE(
+      LGIV->getInductionVariable(),
+      "Loop-Governing Induction Variable has NULL Induction Variable!");
+
+  // The induction variable must step by one.
+  auto *step =
+      dyn_cast_or_null<llvm::ConstantInt>(IV.getSingleComputedStepValue());
+  if (step == nullptr || !step->isOne()) {
+    return {};
+  }
+
+  space.induction_variable = IV.getLoopEntryPHI();
+  space.start = IV.getStartValue();
+  if (space.induction_variable == nullptr || space.start == nullptr
+      || space.induction_variable->getParent() != space.header) {
+    return {};
+  }
+
+  // The exit condition must compare the induction variable itself against
+  // a loop-invariant bound in the header.
+  auto *compare = dyn_cast_or_null<llvm::ICmpInst>(
+      LGIV->getHeaderCompareInstructionToComputeExitCondition());
+  auto *branch = dyn_cast<llvm::BranchInst>(space.header->getTerminator());
+  if (compare == nullptr || branch == nullptr || !branch->isConditional()
+      || branch->getCondition() != compare) {
+    return {};
+  }
+
+  auto predicate = compare->getPredicate();
+  space.end = compare->getOperand(1);
+  if (compare->getOperand(0) != space.induction_variable) {
+    if (compare->getOperand(1) != space.induction_variable) {
+      return {};
+    }
+    predicate = compare->getSwappedPredicate();
+    space.end = compare->getOperand(0);
+  }
+  if (!L.isLoopInvariant(space.end)) {
+    return {};
+  }
+
+  // Normalize the predicate to the condition for staying in the loop.
+  if (!L.contains(branch->getSuccessor(0))) {
+    predicate = llvm::CmpInst::getInversePredicate(predicate);
+  }
+  if (predicate != llvm::CmpInst::ICMP_SLT
+      && predicate != llvm::CmpInst::ICMP_ULT) {
+    return {};
+  }
+  space.predicate = predicate;
+
+  return space;
+}
+
+} // namespace llvm::memoir
@@ -87,17 +87,20 @@ LiveRangeConstraintGraph LiveRangeAnalysis::construct() {
     }
   }
 
+  // Build the adjacency of the graph.
+  graph.finalize();
+
   debugln("Constraint graph:");
-  for (auto *node : graph) {
-    debugln(" ├─┬─╸ ", *node);
+  for (unsigned node = 0; node < graph.size(); ++node) {
+    debugln(" ├─┬─╸ ", graph.get_node(node));
     debugln(" │ ├─┬─╸ outgoing: ");
-    for (auto [out, _] : graph.outgoing(node)) {
-      debugln(" │ │ ├─╸ ", *out);
+    for (auto edge : graph.outgoing(node)) {
+      debugln(" │ │ ├─╸ ", graph.get_node(graph.get_edge(edge).to));
     }
     debugln(" │ │ ╹ ");
     debugln(" │ ├─┬─╸ incoming: ");
-    for (auto [in, _] : graph.incoming(node)) {
-      debugln(" │ │ ├─╸ ", *in);
+    for (auto edge : graph.incoming(node)) {
+      debugln(" │ │ ├─╸ ", graph.get_node(graph.get_edge(edge).from));
     }
     debugln(" │ ╹ ╹ ");
   }
@@ -108,97 +111,102 @@ LiveRangeConstraintGraph LiveRangeAnalysis::construct() {
 }
 
 void LiveRangeAnalysis::evaluate(LiveRangeConstraintGraph &graph) {
-  // Compute the condensation of the constraint graph.
-  auto condensation = graph.condense();
+  using NodeID = LiveRangeConstraintGraph::NodeID;
 
-  debugln("Condensation graph:");
-  for (auto *node : condensation) {
-    debugln(" ├─┬─╸ ", *node);
-    debugln(" │ ├─┬─╸ outgoing: ");
-    for (auto [out, _] : condensation.outgoing(node)) {
-      debugln(" │ │ ├─╸ ", *out);
-    }
-    debugln(" │ │ ╹ ");
-    debugln(" │ ├─┬─╸ incoming: ");
-    for (auto [in, _] : condensation.incoming(node)) {
-      debugln(" │ │ ├─╸ ", *in);
-    }
-    debugln(" │ │ ╹ ");
-    debugln(" │ ├─┬─╸ : ");
-    for (auto *component : condensation.node_prop(node)) {
-      debugln(" │ │ ├─╸ ", *component);
+  // Compute the strongly connected components, in topological order.
+  auto components = graph.strongly_connected_components();
+
+  auto num_nodes = graph.size();
+  vector<unsigned> component_of(num_nodes, 0);
+  for (unsigned component = 0; component < components.size(); ++component) {
+    for (auto node : components[component]) {
+      component_of[node] = component;
     }
-    debugln(" │ ╹ ╹ ");
   }
-  debugln(" ╹ ");
-
-  // Compute the topographical order of the components.
-  auto topological_order = *condensation.topological_order();
 
   debugln("Topological order: ");
-  for (auto *value : topological_order) {
-    debugln(" ├─┬─╸ ", *value);
-    for (auto *component : condensation.node_prop(value)) {
-      if (component != value) {
-        debugln(" │ ├─╸ ", *component);
+  for (auto &component : components) {
+    debugln(" ├─┬─╸ ", graph.get_node(component.front()));
+    for (auto node : component) {
+      if (node != component.front()) {
+        debugln(" │ ├─╸ ", graph.get_node(node));
       }
     }
     debugln(" │ ╹ ");
   }
   debugln(" ╹");
 
-  // For each SCC in the condensation graph, in topological order:
-  for (auto *root : topological_order) {
-
-    // Evaluate the root of the SCC.
-    auto &merged_range = graph.node_prop(root);
-    for (auto [in, e] : condensation.incoming(root)) {
+  // The initial ranges are those of the index values, they stay fixed.
+  vector<ValueRange *> initial_ranges(num_nodes, nullptr);
+  vector<bool> changed(num_nodes, false);
+  for (NodeID node = 0; node < num_nodes; ++node) {
+    initial_ranges[node] = graph.node_prop(node);
+    changed[node] = (initial_ranges[node] != nullptr);
+  }
+  vector<unsigned> num_updates(num_nodes, 0);
+
+  // For each SCC, in topological order, solve for its nodes with a worklist.
+  // Only nodes with a changed predecessor are visited.
+  for (unsigned component = 0; component < components.size(); ++component) {
+    vector<NodeID> worklist = {};
+    set<NodeID> in_worklist = {};
+    for (auto node : components[component]) {
+      for (auto edge : graph.incoming(node)) {
+        if (changed[graph.get_edge(edge).from]) {
+          worklist.push_back(node);
+          in_worklist.insert(node);
+          break;
+        }
+      }
+    }
 
-      // Get the incoming live range.
-      auto *range = graph.propagate_edge(in, root, e.prop());
+    while (!worklist.empty()) {
+      auto node = worklist.back();
+      worklist.pop_back();
+      in_worklist.erase(node);
 
-      // If the range is underdefined, skip it.
-      if (range == nullptr) {
-        continue;
-      }
+      // Merge the incoming ranges.
+      auto *merged_range = initial_ranges[node];
+      for (auto edge : graph.incoming(node)) {
+        // If the range is underdefined, skip it.
+        auto *range = graph.propagate_edge(edge);
+        if (range == nullptr) {
+          continue;
+        }
 
-      // Merge the range with the current range.
-      // TODO: flesh this out.
-      if (merged_range == nullptr) {
-        merged_range = range;
-      } else {
-        MEMOIR_UNREACHABLE("Range merging is unimplemented!");
+        merged_range = this->disjunctive_merge(merged_range, range);
       }
-    }
 
-    // TODO: handle context-sensitivity.
-
-    // Propagate root evaluation along all edges within the SCC.
-    auto &scc = condensation.node_prop(root);
-    for (auto *node : scc) {
-      if (node == root) {
+      // If the range is unchanged, there is nothing to propagate.
+      // Expressions are interned, so equal ranges have the same bounds.
+      auto *&current_range = graph.node_prop(node);
+      if (merged_range == current_range
+          || (merged_range != nullptr && current_range != nullptr
+              && &merged_range->get_lower() == &current_range->get_lower()
+              && &merged_range->get_upper() == &current_range->get_upper())) {
         continue;
       }
 
-      auto &merged_range = graph.node_prop(node);
-      for (auto [in, e] : graph.incoming(node)) {
+      // If the node keeps changing, widen it to the whole sequence.
+      if (++num_updates[node] > max_node_updates) {
+        merged_range = &this->create_overdefined_range();
+        if (current_range == merged_range) {
+          continue;
+        }
+      }
 
-        // Get the incoming live range.
-        auto *range = graph.propagate_edge(in, node, e.prop());
+      current_range = merged_range;
+      changed[node] = true;
 
-        // If the range is underdefined, skip it.
-        if (range == nullptr) {
+      // Revisit the successors within this SCC, later SCCs will see the
+      // change when they are solved.
+      for (auto edge : graph.outgoing(node)) {
+        auto succ = graph.get_edge(edge).to;
+        if (component_of[succ] != component) {
           continue;
         }
-
-        // Merge the range with the current range.
-        // TODO: handle different use types.
-        if (merged_range == nullptr) {
-          merged_range = range;
-        } else if (merged_range == range) {
-          // Do nothing.
-        } else {
-          MEMOIR_UNREACHABLE("Range merging is unimplemented!");
+        if (in_worklist.insert(succ).second) {
+          worklist.push_back(succ);
         }
       }
     }
@@ -206,12 +214,13 @@ void LiveRangeAnalysis::evaluate(LiveRangeConstraintGraph &graph) {
 
   // Print the results.
   debugln("Valuation:");
-  for (auto *node : graph) {
+  for (NodeID node = 0; node < num_nodes; ++node) {
+    auto &value = graph.get_node(node);
     auto *range = graph.node_prop(node);
 
-    this->live_ranges[node][nullptr] = range;
+    this->live_ranges[&value][nullptr] = range;
 
-    debugln(*node);
+    debugln(value);
     if (range) {
       debugln("    ==  ", *range);
     } else {
@@ -222,6 +231,36 @@ void LiveRangeAnalysis::evaluate(LiveRangeConstraintGraph &graph) {
   return;
 }
 
+void LiveRangeAnalysis::summarize_calls() {
+  // The live range of a function argument is a summary over the function's
+  // arguments. Rather than re-solving the callee for each call site, reuse the
+  // summary in every calling context. Its expressions are materialized in the
+  // calling context by the client.
+  for (auto &F : this->M) {
+    if (F.empty()) {
+      continue;
+    }
+
+    for (auto &A : F.args()) {
+      auto *summary = this->lookup_live_range(A, nullptr);
+      if (summary == nullptr) {
+        continue;
+      }
+
+      for (auto *user : F.users()) {
+        auto *call = dyn_cast<llvm::CallBase>(user);
+        if (call == nullptr || call->getCalledFunction() != &F) {
+          continue;
+        }
+
+        this->live_ranges[&A][call] = summary;
+      }
+    }
+  }
+
+  return;
+}
+
 // Analysis driver.
 void LiveRangeAnalysis::run() {
   // Construct the constraints graph.
@@ -229,6 +268,11 @@ void LiveRangeAnalysis::run() {
 
   // Evaluate the constraints graph.
   evaluate(graph);
+
+  // Share the callee summaries with each calling context.
+  if (this->context_sensitive) {
+    summarize_calls();
+  }
 }
 
 // Logistics.
@@ -237,24 +281,65 @@ LiveRangeAnalysis::~LiveRangeAnalysis() {
        intraprocedural_range_analyses) {
     delete range_analysis;
   }
+  for (auto *range : this->ranges) {
+    delete range;
+  }
 }
 
 // Operators.
 
-static ValueExpression &create_min(ValueExpression &expr1,
-                                   ValueExpression &expr2) {
-  return *(new SelectExpression(
-      new ICmpExpression(llvm::CmpInst::Predicate::ICMP_ULE, expr1, expr2),
-      &expr1,
-      &expr2));
+ValueExpression &LiveRangeAnalysis::create_min(ValueExpression &expr1,
+                                               ValueExpression &expr2) {
+  if (&expr1 == &expr2) {
+    return expr1;
+  }
+  auto &cmp = this->arena.get<ICmpExpression>(
+      llvm::CmpInst::Predicate::ICMP_ULE,
+      expr1,
+      expr2);
+  return this->arena.get<SelectExpression>(&cmp, &expr1, &expr2);
+}
+
+ValueExpression &LiveRangeAnalysis::create_max(ValueExpression &expr1,
+                                               ValueExpression &expr2) {
+  if (&expr1 == &expr2) {
+    return expr1;
+  }
+  auto &cmp = this->arena.get<ICmpExpression>(
+      llvm::CmpInst::Predicate::ICMP_UGE,
+      expr1,
+      expr2);
+  return this->arena.get<SelectExpression>(&cmp, &expr1, &expr2);
 }
 
-static ValueExpression &create_max(ValueExpression &expr1,
-                                   ValueExpression &expr2) {
-  return *(new SelectExpression(
-      new ICmpExpression(llvm::CmpInst::Predicate::ICMP_UGE, expr1, expr2),
-      &expr1,
-      &expr2));
+ValueRange &LiveRangeAnalysis::create_value_range(ValueExpression &lower,
+                                                  ValueExpression &upper) {
+  auto &range = MEMOIR_SANITIZE(new ValueRange(lower, upper),
+                                "Failed to allocate ValueRange!");
+  this->ranges.insert(&range);
+
+  return range;
+}
+
+ValueRange &LiveRangeAnalysis::create_overdefined_range() {
+  // Reuse the overdefined range, so that widened nodes stop changing.
+  if (this->overdefined_range != nullptr) {
+    return *this->overdefined_range;
+  }
+
+  // TODO: make this get the size_t from a MemOIRContext.
+  auto &size_type = MEMOIR_SANITIZE(
+      llvm::IntegerType::get(this->M.getContext(), 64),
+      "Failed to get LLVM 64-bit integer type!");
+  auto &zero_value = MEMOIR_SANITIZE(llvm::ConstantInt::get(&size_type, 0),
+                                     "Failed to get LLVM constant zero!");
+
+  auto &lower = this->arena.get<ConstantExpression>(zero_value);
+  auto &upper = this->arena.get<EndExpression>();
+
+  this->overdefined_range = &this->create_value_range(lower, upper);
+
+  return *this->overdefined_range;
 }
 
 ValueRange *LiveRangeAnalysis::disjunctive_merge(ValueRange *range1,
@@ -279,8 +364,13 @@ ValueRange *LiveRangeAnalysis::disjunctive_merge(ValueRange *range1,
 
   auto &upper_max = create_max(upper1, upper2);
 
+  // If the merge is one of the ranges, reuse it.
+  if (&lower_min == &lower1 && &upper_max == &upper1) {
+    return range1;
+  }
+
   // Construct the new value range.
-  auto *new_range = new ValueRange(lower_min, upper_max);
+  auto *new_range = &this->create_value_range(lower_min, upper_max);
 
   // Return.
   return new_range;
@@ -307,8 +397,13 @@ ValueRange *LiveRangeAnalysis::conjunctive_merge(ValueRange *range1,
 
   auto &upper_min = create_min(upper1, upper2);
 
+  // If the merge is one of the ranges, reuse it.
+  if (&lower_max == &lower1 && &upper_min == &upper1) {
+    return range1;
+  }
+
   // Construct the new value range.
-  auto *new_range = new ValueRange(lower_max, upper_min);
+  auto *new_range = &this->create_value_range(lower_max, upper_min);
 
   // Return.
   return new_range;
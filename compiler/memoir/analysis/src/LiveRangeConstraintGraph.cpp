@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "memoir/analysis/LiveRangeAnalysis.hpp"
 
 #include "memoir/support/Assert.hpp"
@@ -12,28 +14,64 @@ static ValueRange *propagate_range(ValueRange *range) {
 }
 
 // Constraint application.
-ValueRange *LiveRangeConstraintGraph::propagate_edge(llvm::Value *from,
-                                                     llvm::Value *to,
-                                                     Constraint constraint) {
+ValueRange *LiveRangeConstraintGraph::propagate_edge(EdgeID edge) {
+  auto &[from, to, constraint] = this->edges[edge];
+
   // Get the value range of @from.
-  auto *from_range = this->node_prop(from);
+  auto *from_range = this->node_props[from];
 
   // Apply the constraint and return.
   return constraint(from_range);
 }
 
 // Graph construction.
+LiveRangeConstraintGraph::NodeID LiveRangeConstraintGraph::add_node(
+    llvm::Value &V,
+    ValueRange *VR) {
+  // If the node already exists, fill in its range if it is unspecified.
+  auto found = this->node_ids.find(&V);
+  if (found != this->node_ids.end()) {
+    auto id = found->second;
+    if (this->node_props[id] == nullptr) {
+      this->node_props[id] = VR;
+    }
+    return id;
+  }
+
+  // Otherwise, create a new node.
+  auto id = this->nodes.size();
+  this->node_ids[&V] = id;
+  this->nodes.push_back(&V);
+  this->node_props.push_back(VR);
+
+  return id;
+}
+
+void LiveRangeConstraintGraph::add_edge(llvm::Value &from,
+                                        llvm::Value &to,
+                                        Constraint constraint) {
+  MEMOIR_ASSERT(!this->finalized,
+                "Cannot add an edge to a finalized constraint graph!");
+
+  auto from_id = this->add_node(from, nullptr);
+  auto to_id = this->add_node(to, nullptr);
+
+  this->edges.push_back({ from_id, to_id, constraint });
+
+  return;
+}
+
 void LiveRangeConstraintGraph::add_index_to_graph(llvm::Value &V,
                                                   ValueRange &VR) {
   // Add the node to the graph with its node property set to its value range.
-  this->add_node_with_prop(&V, &VR);
+  this->add_node(V, &VR);
 
   return;
 }
 
 void LiveRangeConstraintGraph::add_seq_to_graph(llvm::Value &V) {
   // Add the node to the graph with an unspecified value range.
-  this->add_node_with_prop(&V, nullptr);
+  this->add_node(V, nullptr);
 
   return;
 }
@@ -41,37 +79,172 @@ void LiveRangeConstraintGraph::add_seq_to_graph(llvm::Value &V) {
 void LiveRangeConstraintGraph::add_use_to_graph(llvm::Use &U,
                                                 Constraint constraint) {
   // Get the value being used.
-  auto *used_value = U.get();
+  auto &used_value = MEMOIR_SANITIZE(U.get(), "Value being used is NULL!");
 
   // Get the user.
-  auto *user = U.getUser();
+  auto &user = MEMOIR_SANITIZE(U.getUser(), "User is NULL!");
 
-  // Add nodes to graph.
-  this->add_seq_to_graph(*used_value);
-  this->add_seq_to_graph(*user);
-
-  // Add an edge from the value being used to the user to the graph.
-  MEMOIR_ASSERT(this->add_edge_with_prop(user, used_value, constraint),
-                "Failed to add edge!");
+  // Add an edge from the user to the value being used to the graph.
+  this->add_edge(user, used_value, constraint);
 
   return;
 }
 
 void LiveRangeConstraintGraph::add_index_use_to_graph(llvm::Use &index_use,
                                                       llvm::Value &collection) {
-
-  // Add the collection to the graph if not already there.
-  this->add_seq_to_graph(collection);
-
   // Get the value being used.
-  auto *index_value = index_use.get();
+  auto &index_value =
+      MEMOIR_SANITIZE(index_use.get(), "Index being used is NULL!");
 
   // Add an edge from the value being used to the user to the graph.
-  this->add_edge_with_prop(index_value, &collection, propagate_range);
+  this->add_edge(index_value, collection, propagate_range);
 
   return;
 }
 
+void LiveRangeConstraintGraph::finalize() {
+  if (this->finalized) {
+    return;
+  }
+  this->finalized = true;
+
+  auto num_nodes = this->size();
+  auto num_edges = this->edges.size();
+
+  // Count the degree of each node.
+  this->incoming_offsets.assign(num_nodes + 1, 0);
+  this->outgoing_offsets.assign(num_nodes + 1, 0);
+  for (auto &edge : this->edges) {
+    ++this->incoming_offsets[edge.to + 1];
+    ++this->outgoing_offsets[edge.from + 1];
+  }
+
+  // Compute the offsets with a prefix sum.
+  for (NodeID node = 0; node < num_nodes; ++node) {
+    this->incoming_offsets[node + 1] += this->incoming_offsets[node];
+    this->outgoing_offsets[node + 1] += this->outgoing_offsets[node];
+  }
+
+  // Fill in the edges, keeping insertion order within each node.
+  this->incoming_edges.resize(num_edges);
+  this->outgoing_edges.resize(num_edges);
+  vector<unsigned> incoming_next(this->incoming_offsets.begin(),
+                                 this->incoming_offsets.end() - 1);
+  vector<unsigned> outgoing_next(this->outgoing_offsets.begin(),
+                                 this->outgoing_offsets.end() - 1);
+  for (EdgeID edge = 0; edge < num_edges; ++edge) {
+    auto &[from, to, _] = this->edges[edge];
+    this->incoming_edges[incoming_next[to]++] = edge;
+    this->outgoing_edges[outgoing_next[from]++] = edge;
+  }
+
+  return;
+}
+
+// Graph queries.
+unsigned LiveRangeConstraintGraph::size() const {
+  return this->nodes.size();
+}
+
+llvm::Value &LiveRangeConstraintGraph::get_node(NodeID node) const {
+  return *this->nodes[node];
+}
+
+ValueRange *&LiveRangeConstraintGraph::node_prop(NodeID node) {
+  return this->node_props[node];
+}
+
+const LiveRangeConstraintGraph::Edge &LiveRangeConstraintGraph::get_edge(
+    EdgeID edge) const {
+  return this->edges[edge];
+}
+
+llvm::ArrayRef<LiveRangeConstraintGraph::EdgeID> LiveRangeConstraintGraph::
+    incoming(NodeID node) const {
+  MEMOIR_ASSERT(this->finalized, "Constraint graph is not finalized!");
+  auto begin = this->incoming_offsets[node];
+  auto end = this->incoming_offsets[node + 1];
+  return llvm::makeArrayRef(this->incoming_edges).slice(begin, end - begin);
+}
+
+llvm::ArrayRef<LiveRangeConstraintGraph::EdgeID> LiveRangeConstraintGraph::
+    outgoing(NodeID node) const {
+  MEMOIR_ASSERT(this->finalized, "Constraint graph is not finalized!");
+  auto begin = this->outgoing_offsets[node];
+  auto end = this->outgoing_offsets[node + 1];
+  return llvm::makeArrayRef(this->outgoing_edges).slice(begin, end - begin);
+}
+
+vector<vector<LiveRangeConstraintGraph::NodeID>> LiveRangeConstraintGraph::
+    strongly_connected_components() const {
+  MEMOIR_ASSERT(this->finalized, "Constraint graph is not finalized!");
+
+  // Iterative Tarjan's algorithm, which finds the components in reverse
+  // topological order.
+  auto num_nodes = this->size();
+  const unsigned unvisited = -1;
+  vector<unsigned> index(num_nodes, unvisited);
+  vector<unsigned> lowlink(num_nodes, 0);
+  vector<bool> on_stack(num_nodes, false);
+  vector<NodeID> stack = {};
+  vector<std::pair<NodeID, unsigned>> call_stack = {};
+  vector<vector<NodeID>> components = {};
+  unsigned next_index = 0;
+
+  auto discover = [&](NodeID node) {
+    index[node] = lowlink[node] = next_index++;
+    stack.push_back(node);
+    on_stack[node] = true;
+    call_stack.push_back({ node, this->outgoing_offsets[node] });
+  };
+
+  for (NodeID start = 0; start < num_nodes; ++start) {
+    if (index[start] != unvisited) {
+      continue;
+    }
+    discover(start);
+
+    while (!call_stack.empty()) {
+      auto node = call_stack.back().first;
+      auto position = call_stack.back().second;
+
+      // Visit the next successor of the node.
+      if (position < this->outgoing_offsets[node + 1]) {
+        ++call_stack.back().second;
+        auto succ = this->edges[this->outgoing_edges[position]].to;
+        if (index[succ] == unvisited) {
+          discover(succ);
+        } else if (on_stack[succ]) {
+          lowlink[node] = std::min(lowlink[node], index[succ]);
+        }
+        continue;
+      }
+
+      // All successors are visited, pop the component if this is its root.
+      if (lowlink[node] == index[node]) {
+        auto &component = components.emplace_back();
+        NodeID member;
+        do {
+          member = stack.back();
+          stack.pop_back();
+          on_stack[member] = false;
+          component.push_back(member);
+        } while (member != node);
+      }
+
+      call_stack.pop_back();
+      if (!call_stack.empty()) {
+        auto parent = call_stack.back().first;
+        lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+      }
+    }
+  }
+
+  std::reverse(components.begin(), components.end());
+
+  return components;
+}
+
 void LiveRangeConstraintGraph::add_uses_to_graph(RangeAnalysis &RA,
                                                  llvm::Instruction &I) {
 
@@ -111,6 +284,11 @@ void LiveRangeConstraintGraph::add_uses_to_graph(RangeAnalysis &RA,
       this->add_use_to_graph(write_inst->getObjectOperandAsUse(),
                              propagate_range);
 
+    } else if (auto *fill_inst = dyn_cast<SeqFillInst>(memoir_inst)) {
+      // Add an edge from this value to its sequence operand.
+      this->add_use_to_graph(fill_inst->getBaseCollectionAsUse(),
+                             propagate_range);
+
     } else if (auto *get_inst = dyn_cast<IndexGetInst>(memoir_inst)) {
       if (get_inst->getNumberOfDimensions() > 1) {
         warnln(
@@ -1,109 +1,175 @@
-#include <functional>
+#include <algorithm>
 
+#include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/IR/CFG.h"
 
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Print.hpp"
+
 #include "memoir/analysis/LivenessAnalysis.hpp"
 
 namespace llvm::memoir {
 
-// Transfer functions.
-void compute_gen(llvm::Instruction *inst,
-                 arcana::noelle::DataFlowResult *result) {
-  // GEN = Use(I)
-  for (auto &operand : inst->operands()) {
-    auto *operand_value = operand.get();
-    if (Type::value_is_collection_type(*operand_value)) {
-      result->GEN(inst).insert(operand_value);
-    }
+// Constructor and analysis invocation. Liveness may be computed on a worker
+// thread of SSA destruction, so nothing is logged here.
+LivenessAnalysis::LivenessAnalysis(llvm::Function &F) : F(F) {
+  this->analyze();
+}
+
+// Numbering.
+opt<unsigned> LivenessAnalysis::get_id(llvm::Value &V) const {
+  auto found = this->value_ids.find(&V);
+  if (found == this->value_ids.end()) {
+    return {};
   }
+  return found->second;
 }
 
-void compute_kill(llvm::Instruction *inst,
-                  arcana::noelle::DataFlowResult *result) {
-  // KILL = Def(I)
-  if (Type::value_is_collection_type(*inst)) {
-    result->KILL(inst).insert(inst);
+unsigned LivenessAnalysis::number(llvm::Value &V) {
+  auto found = this->value_ids.find(&V);
+  if (found != this->value_ids.end()) {
+    return found->second;
   }
+
+  auto id = this->values.size();
+  this->values.push_back(&V);
+  this->value_ids[&V] = id;
+  return id;
 }
 
-void compute_in(std::set<llvm::Value *> &in,
-                llvm::Instruction *inst,
-                arcana::noelle::DataFlowResult *result) {
-  auto &gen = result->GEN(inst);
-  auto &kill = result->KILL(inst);
-  auto &out = result->OUT(inst);
-  // IN = (OUT-KILL) U GEN
-  in.insert(out.begin(), out.end());
-  for (auto *kill_value : kill) {
-    auto found = in.find(kill_value);
-    if (found != in.end()) {
-      in.erase(found);
+// Analysis driver.
+void LivenessAnalysis::analyze() {
+  // Number the collection values of the function.
+  for (auto &A : this->F.args()) {
+    if (Type::value_is_collection_type(A)) {
+      this->number(A);
+    }
+  }
+  for (auto &BB : this->F) {
+    for (auto &I : BB) {
+      if (Type::value_is_collection_type(I)) {
+        this->number(I);
+      }
+      for (auto &operand : I.operands()) {
+        auto *operand_value = operand.get();
+        if (isa<llvm::Instruction>(operand_value)
+            || isa<llvm::Argument>(operand_value)) {
+          continue;
+        }
+        if (Type::value_is_collection_type(*operand_value)) {
+          this->number(*operand_value);
+        }
+      }
+    }
+  }
+
+  // Compute the upward-exposed uses and definitions of each basic block.
+  // The incoming values of PHIs are live out of the incoming block, not into
+  // the block of the PHI.
+  for (auto &BB : this->F) {
+    auto &sets = this->block_sets[&BB];
+    for (auto it = BB.rbegin(); it != BB.rend(); ++it) {
+      auto &I = *it;
+      if (auto id = this->get_id(I)) {
+        sets.defs.set(*id);
+        sets.uses.reset(*id);
+      }
+      if (isa<llvm::PHINode>(&I)) {
+        continue;
+      }
+      for (auto &operand : I.operands()) {
+        if (auto id = this->get_id(*operand.get())) {
+          sets.uses.set(*id);
+        }
+      }
     }
   }
-  in.insert(gen.begin(), gen.end());
-}
 
-void compute_out(std::set<llvm::Value *> &out,
-                 llvm::Instruction *successor,
-                 arcana::noelle::DataFlowResult *result) {
-  if (isa<llvm::PHINode>(successor)
-      && successor == &*successor->getParent()->begin()) {
-    auto *successor_bb = successor->getParent();
-    auto *first_non_phi = successor_bb->getFirstNonPHI();
-    auto &in = result->OUT(first_non_phi);
-
-    // Find which basic block we are coming from.
-    // NOTE: this should be fixed in NOELLE by having an option to use a
-    //        BasicBlockEdge as successor.
-    llvm::BasicBlock *incoming_bb = nullptr;
-    for (auto *pred_bb : llvm::predecessors(successor_bb)) {
-      auto *pred_term = pred_bb->getTerminator();
-      // Check if @out == result->OUT(pred_term)
-      if (&out == &result->OUT(pred_term)) {
-        incoming_bb = pred_bb;
-        break;
+  // Solve for the live sets with a worklist, seeded in post order so that
+  // most successors are visited before their predecessors.
+  vector<llvm::BasicBlock *> worklist = {};
+  set<llvm::BasicBlock *> in_worklist = {};
+  for (auto *BB : llvm::post_order(&this->F)) {
+    worklist.push_back(BB);
+    in_worklist.insert(BB);
+  }
+  std::reverse(worklist.begin(), worklist.end());
+
+  while (!worklist.empty()) {
+    auto *BB = worklist.back();
+    worklist.pop_back();
+    in_worklist.erase(BB);
+
+    auto &sets = this->block_sets[BB];
+
+    // OUT = U_succ (IN(succ) - PHIs(succ)) U PHI uses along the edge
+    for (auto *succ_bb : llvm::successors(BB)) {
+      auto &succ_sets = this->block_sets[succ_bb];
+      sets.live_out |= succ_sets.live_in;
+      for (auto &phi : succ_bb->phis()) {
+        auto *incoming_value = phi.getIncomingValueForBlock(BB);
+        if (incoming_value == nullptr) {
+          continue;
+        }
+        if (auto id = this->get_id(*incoming_value)) {
+          sets.live_out.set(*id);
+        }
       }
     }
 
-    MEMOIR_NULL_CHECK(
-        incoming_bb,
-        "Couldn't find the out set matching the predecessor. "
-        "Blame NOELLE, then go fix its data flow engine with the aforementioned fix.");
+    // IN = (OUT - DEF) U USE
+    LiveSetTy live_in = sets.live_out;
+    live_in.intersectWithComplement(sets.defs);
+    live_in |= sets.uses;
 
-    // Compute the IN set for this basic block edge.
-    std::set<llvm::Value *> path_sensitive_in(in.begin(), in.end());
-    for (auto &phi : successor_bb->phis()) {
-      auto *incoming_value = phi.getIncomingValueForBlock(incoming_bb);
-      path_sensitive_in.insert(incoming_value);
+    // If the IN set grew, the predecessors need to be revisited.
+    if (live_in == sets.live_in) {
+      continue;
+    }
+    sets.live_in = std::move(live_in);
 
-      auto found_def = path_sensitive_in.find(&phi);
-      if (found_def != path_sensitive_in.end()) {
-        path_sensitive_in.erase(found_def);
+    for (auto *pred_bb : llvm::predecessors(BB)) {
+      if (in_worklist.insert(pred_bb).second) {
+        worklist.push_back(pred_bb);
       }
     }
-
-    // OUT = U_succ IN
-    out.insert(path_sensitive_in.begin(), path_sensitive_in.end());
-  } else {
-    auto &in = result->OUT(successor);
-    // OUT = U_succ IN
-    out.insert(in.begin(), in.end());
   }
 }
 
-// Constructor and analysis invocation.
-LivenessAnalysis::LivenessAnalysis(llvm::Function &F,
-                                   arcana::noelle::DataFlowEngine DFE)
-  : F(F),
-    DFE(std::move(DFE)) {
-  debugln("Start liveness analysis");
-  // this->DFR = this->DFE.applyBackward(&F,
-  //                                     compute_gen,
-  //                                     compute_kill,
-  //                                     compute_in,
-  //                                     compute_out);
-  this->DFR = nullptr; // TODO: update with new NOELLE API.
-  debugln("End liveness analysis");
+void LivenessAnalysis::materialize(llvm::BasicBlock &BB) {
+  if (!this->materialized.insert(&BB).second) {
+    return;
+  }
+
+  auto to_set = [this](const LiveSetTy &live) {
+    std::set<llvm::Value *> live_values = {};
+    for (auto id : live) {
+      live_values.insert(this->values[id]);
+    }
+    return live_values;
+  };
+
+  // Walk the block backwards from its OUT set.
+  auto &sets = this->block_sets[&BB];
+  LiveSetTy live = sets.live_out;
+  for (auto it = BB.rbegin(); it != BB.rend(); ++it) {
+    auto &I = *it;
+    this->live_after[&I] = to_set(live);
+
+    // IN = (OUT - KILL) U GEN
+    if (auto id = this->get_id(I)) {
+      live.reset(*id);
+    }
+    if (!isa<llvm::PHINode>(&I)) {
+      for (auto &operand : I.operands()) {
+        if (auto id = this->get_id(*operand.get())) {
+          live.set(*id);
+        }
+      }
+    }
+
+    this->live_before[&I] = to_set(live);
+  }
 }
 
 // Analysis queries.
@@ -126,9 +192,14 @@ std::set<llvm::Value *> &LivenessAnalysis::get_live_values(MemOIRInst &I,
 
 std::set<llvm::Value *> &LivenessAnalysis::get_live_values(llvm::Instruction &I,
                                                            bool after) {
-  MEMOIR_NULL_CHECK(this->DFR, "Data flow result not available!");
+  auto &BB = MEMOIR_SANITIZE(I.getParent(),
+                             "Instruction is not in a basic block!");
+  MEMOIR_ASSERT((BB.getParent() == &this->F),
+                "Instruction is not in the analyzed function!");
+
+  this->materialize(BB);
 
-  return after ? this->DFR->OUT(&I) : this->DFR->IN(&I);
+  return after ? this->live_after[&I] : this->live_before[&I];
 }
 
 } // namespace llvm::memoir
@@ -1,6 +1,7 @@
 #include "memoir/analysis/RangeAnalysis.hpp"
 
 #include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/MutOperations.hpp"
 
 #include "memoir/support/Assert.hpp"
 #include "memoir/support/Casting.hpp"
@@ -23,11 +24,12 @@ void RangeAnalysis::propagate_range_to_uses(ValueRange &range,
   }
 }
 
-static ValueExpression &llvm_value_to_expr(llvm::Value &V) {
+static ValueExpression &llvm_value_to_expr(ExpressionArena &arena,
+                                           llvm::Value &V) {
   if (auto *constant = dyn_cast<llvm::Constant>(&V)) {
-    return *(new ConstantExpression(*constant));
+    return arena.get<ConstantExpression>(*constant);
   } else {
-    return *(new VariableExpression(V));
+    return arena.get<VariableExpression>(V);
   }
 }
 
@@ -46,8 +48,8 @@ ValueRange &RangeAnalysis::induction_variable_to_range(
         // Create and return the range [start_value, exit_condition_value).
         // TODO: may need to inspect the compare instruction to handle all edge
         // cases.
-        auto *lower_expr = &llvm_value_to_expr(*start_value);
-        auto *upper_expr = &llvm_value_to_expr(*exit_value);
+        auto *lower_expr = &llvm_value_to_expr(this->arena, *start_value);
+        auto *upper_expr = &llvm_value_to_expr(this->arena, *exit_value);
         return this->create_value_range(*lower_expr, *upper_expr);
       }
     }
@@ -123,6 +125,49 @@ bool RangeAnalysis::analyze(llvm::Function &F, arcana::noelle::Noelle &noelle) {
       } else if (auto *copy_inst = dyn_cast<SeqCopyInst>(memoir_inst)) {
         add_index_use(index_value_to_uses, copy_inst->getBeginIndexAsUse());
         add_index_use(index_value_to_uses, copy_inst->getEndIndexAsUse());
+      } else if (auto *fill_inst = dyn_cast<SeqFillInst>(memoir_inst)) {
+        add_index_use(index_value_to_uses, fill_inst->getBeginIndexAsUse());
+        add_index_use(index_value_to_uses, fill_inst->getEndIndexAsUse());
+      }
+
+      // Collect the integer values written, so that their bounds can be
+      // queried as well.
+      llvm::Use *value_written_use = nullptr;
+      if (auto *write_inst = dyn_cast<WriteInst>(memoir_inst)) {
+        value_written_use = &write_inst->getValueWrittenAsUse();
+      } else if (auto *fill_inst = dyn_cast<SeqFillInst>(memoir_inst)) {
+        value_written_use = &fill_inst->getValueWrittenAsUse();
+      } else if (auto *mut_write_inst = dyn_cast<MutWriteInst>(memoir_inst)) {
+        value_written_use = &mut_write_inst->getValueWrittenAsUse();
+      }
+      if (value_written_use != nullptr
+          && value_written_use->get()->getType()->isIntegerTy()) {
+        add_index_use(index_value_to_uses, *value_written_use);
+      }
+
+      // Collect the integer keys of assoc accesses, so that dense key spaces
+      // can be found.
+      llvm::Use *key_use = nullptr;
+      if (auto *assoc_read = dyn_cast<AssocReadInst>(memoir_inst)) {
+        key_use = &assoc_read->getKeyOperandAsUse();
+      } else if (auto *assoc_write = dyn_cast<AssocWriteInst>(memoir_inst)) {
+        key_use = &assoc_write->getKeyOperandAsUse();
+      } else if (auto *assoc_get = dyn_cast<AssocGetInst>(memoir_inst)) {
+        key_use = &assoc_get->getKeyOperandAsUse();
+      } else if (auto *assoc_has = dyn_cast<AssocHasInst>(memoir_inst)) {
+        key_use = &assoc_has->getKeyOperandAsUse();
+      } else if (auto *mut_assoc_write =
+                     dyn_cast<MutAssocWriteInst>(memoir_inst)) {
+        key_use = &mut_assoc_write->getKeyOperandAsUse();
+      } else if (auto *mut_assoc_insert =
+                     dyn_cast<MutAssocInsertInst>(memoir_inst)) {
+        key_use = &mut_assoc_insert->getKeyOperandAsUse();
+      } else if (auto *mut_assoc_remove =
+                     dyn_cast<MutAssocRemoveInst>(memoir_inst)) {
+        key_use = &mut_assoc_remove->getKeyOperandAsUse();
+      }
+      if (key_use != nullptr && key_use->get()->getType()->isIntegerTy()) {
+        add_index_use(index_value_to_uses, *key_use);
       }
     }
   }
@@ -137,9 +182,7 @@ bool RangeAnalysis::analyze(llvm::Function &F, arcana::noelle::Noelle &noelle) {
 
     // If the value is a constant integer:
     if (auto *index_const = dyn_cast<llvm::ConstantInt>(index_value)) {
-      auto &const_expr =
-          MEMOIR_SANITIZE(new ConstantExpression(*index_const),
-                          "Failed to create ConstantExpression!");
+      auto &const_expr = this->arena.get<ConstantExpression>(*index_const);
       this->propagate_range_to_uses(
           this->create_value_range(const_expr, const_expr),
           index_uses);
@@ -148,8 +191,7 @@ bool RangeAnalysis::analyze(llvm::Function &F, arcana::noelle::Noelle &noelle) {
 
     // Otherwise, if the value is an argument:
     else if (auto *index_arg = dyn_cast<llvm::Argument>(index_value)) {
-      auto &arg_expr = MEMOIR_SANITIZE(new ArgumentExpression(*index_arg),
-                                       "Failed to create ArgumentExpression!");
+      auto &arg_expr = this->arena.get<ArgumentExpression>(*index_arg);
       this->propagate_range_to_uses(
           this->create_value_range(arg_expr, arg_expr),
           index_uses);
@@ -223,6 +265,14 @@ ValueRange &RangeAnalysis::get_value_range(llvm::Use &use) {
                      " for the function!");
 }
 
+ValueRange *RangeAnalysis::find_value_range(llvm::Use &use) {
+  auto found_range = this->use_to_range.find(&use);
+  if (found_range != this->use_to_range.end()) {
+    return found_range->second;
+  }
+  return nullptr;
+}
+
 ValueRange &RangeAnalysis::create_value_range(ValueExpression &lower,
                                               ValueExpression &upper) {
   auto &range = MEMOIR_SANITIZE(new ValueRange(lower, upper),
@@ -239,15 +289,13 @@ ValueExpression &RangeAnalysis::create_min_expr() {
                                     "Failed to get LLVM 64-bit integer type!");
   auto &zero_value = MEMOIR_SANITIZE(llvm::ConstantInt::get(&size_type, 0),
                                      "Failed to get LLVM constant zero!");
-  auto &zero_expr = MEMOIR_SANITIZE(new ConstantExpression(zero_value),
-                                    "Failed to create ConstantExpression!");
+  auto &zero_expr = this->arena.get<ConstantExpression>(zero_value);
 
   return zero_expr;
 }
 
 ValueExpression &RangeAnalysis::create_max_expr() {
-  auto &end_expr =
-      MEMOIR_SANITIZE(new EndExpression(), "Failed to create EndExpression!");
+  auto &end_expr = this->arena.get<EndExpression>();
 
   return end_expr;
 }
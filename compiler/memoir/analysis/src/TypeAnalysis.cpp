@@ -1,3 +1,5 @@
+#include "llvm/IR/InstIterator.h"
+
 #include "memoir/analysis/TypeAnalysis.hpp"
 
 #include "memoir/utility/Metadata.hpp"
@@ -426,6 +428,22 @@ Type *TypeAnalysis::visitRemoveInst(RemoveInst &I) {
   MEMOIZE_AND_RETURN(I, type);
 }
 
+Type *TypeAnalysis::visitSeqFillInst(SeqFillInst &I) {
+  CHECK_MEMOIZED(I);
+
+  auto *type = this->getType_helper(I.getBaseCollection());
+
+  MEMOIZE_AND_RETURN(I, type);
+}
+
+Type *TypeAnalysis::visitClearInst(ClearInst &I) {
+  CHECK_MEMOIZED(I);
+
+  auto *type = this->getType_helper(I.getBaseCollection());
+
+  MEMOIZE_AND_RETURN(I, type);
+}
+
 Type *TypeAnalysis::visitSwapInst(SwapInst &I) {
   CHECK_MEMOIZED(I);
 
@@ -461,6 +479,14 @@ Type *TypeAnalysis::visitMutSeqRemoveInst(MutSeqRemoveInst &I) {
   MEMOIZE_AND_RETURN(I, type);
 }
 
+Type *TypeAnalysis::visitMutSeqFillInst(MutSeqFillInst &I) {
+  CHECK_MEMOIZED(I);
+
+  auto *type = this->getType_helper(I.getCollection());
+
+  MEMOIZE_AND_RETURN(I, type);
+}
+
 Type *TypeAnalysis::visitMutSeqSwapInst(MutSeqSwapInst &I) {
   CHECK_MEMOIZED(I);
 
@@ -569,6 +595,15 @@ Type *TypeAnalysis::visitMutAssocRemoveInst(MutAssocRemoveInst &I) {
   MEMOIZE_AND_RETURN(I, type);
 }
 
+// Mutable collection operations.
+Type *TypeAnalysis::visitMutClearInst(MutClearInst &I) {
+  CHECK_MEMOIZED(I);
+
+  auto *type = this->getType_helper(I.getCollection());
+
+  MEMOIZE_AND_RETURN(I, type);
+}
+
 // Type Checking instruction.
 Type *TypeAnalysis::visitAssertStructTypeInst(AssertStructTypeInst &I) {
   CHECK_MEMOIZED(I);
@@ -838,6 +873,23 @@ void TypeAnalysis::markVisited(MemOIRInst &I) {
  */
 void TypeAnalysis::_invalidate() {
   this->value_to_type.clear();
+  this->edge_types.clear();
+  return;
+}
+
+void TypeAnalysis::_invalidate(llvm::Function &F) {
+  for (auto &A : F.args()) {
+    this->_invalidate(A);
+  }
+  for (auto &I : llvm::instructions(F)) {
+    this->_invalidate(I);
+  }
+  return;
+}
+
+void TypeAnalysis::_invalidate(llvm::Value &V) {
+  this->value_to_type.erase(&V);
+  this->edge_types.erase(&V);
   return;
 }
 
@@ -855,4 +907,14 @@ void TypeAnalysis::invalidate() {
   return;
 }
 
+void TypeAnalysis::invalidate(llvm::Function &F) {
+  TypeAnalysis::get()._invalidate(F);
+  return;
+}
+
+void TypeAnalysis::invalidate(llvm::Value &V) {
+  TypeAnalysis::get()._invalidate(V);
+  return;
+}
+
 } // namespace llvm::memoir
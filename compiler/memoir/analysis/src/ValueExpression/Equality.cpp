@@ -16,6 +16,39 @@ namespace llvm::memoir {
   }                                                                            \
   const auto &OE = cast<CLASS>(OTHER);
 
+// Argument helpers.
+static bool same_arguments(const ValueExpression &E1,
+                           const ValueExpression &E2) {
+  // Arguments are interned before their users, so compare them by identity.
+  return E1.arguments == E2.arguments;
+}
+
+static llvm::hash_code hash_arguments(const ValueExpression &E) {
+  return llvm::hash_combine_range(E.arguments.begin(), E.arguments.end());
+}
+
+// Instructions whose result depends only on their operands.
+static bool is_pure(const llvm::Instruction &I) {
+  return isa<llvm::BinaryOperator>(&I) || isa<llvm::CastInst>(&I)
+         || isa<llvm::CmpInst>(&I) || isa<llvm::SelectInst>(&I);
+}
+
+// ValueExpression
+llvm::hash_code ValueExpression::hash() const {
+  // Realized expressions are identified by their value alone.
+  if (this->value != nullptr) {
+    return llvm::hash_combine(this->EK, this->opcode, this->value);
+  }
+  return llvm::hash_combine(this->EK, this->opcode, hash_arguments(*this));
+}
+
+size_t ValueExpression::getHash() const {
+  if (this->interned) {
+    return this->hash_value;
+  }
+  return this->hash();
+}
+
 // ConstantExpression
 bool ConstantExpression::equals(const ValueExpression &E) const {
   CHECK_OTHER(E, ConstantExpression);
@@ -39,36 +72,123 @@ bool UnknownExpression::equals(const ValueExpression &E) const {
   return false;
 }
 
-// BasicExpressionpression
+llvm::hash_code UnknownExpression::hash() const {
+  // Unknown expressions are only equal to themselves.
+  return llvm::hash_value(this);
+}
+
+// BasicExpression
 bool BasicExpression::equals(const ValueExpression &E) const {
   CHECK_OTHER(E, BasicExpression);
-  if ((this->opcode != E.opcode) || (this->getLLVMType() != OE.getLLVMType())
-      || (this->getMemOIRType() != OE.getMemOIRType())
-      || (this->I->getNumOperands() != OE.I->getNumOperands())) {
+  if ((this->EK != OE.EK) || (this->opcode != OE.opcode)) {
     return false;
   }
-  return false;
+
+  // Realized expressions are equal if they are the same instruction, or if
+  // they are pure instructions of the same type over the same arguments.
+  if ((this->I != nullptr) || (OE.I != nullptr)) {
+    if (this->I == OE.I) {
+      return true;
+    } else if ((this->I == nullptr) || (OE.I == nullptr)) {
+      return false;
+    } else if (!is_pure(*this->I) || !is_pure(*OE.I)) {
+      return false;
+    } else if (this->I->getType() != OE.I->getType()) {
+      return false;
+    }
+  }
+
+  return same_arguments(*this, OE);
 };
 
+llvm::hash_code BasicExpression::hash() const {
+  if (this->I == nullptr) {
+    return llvm::hash_combine(this->EK, this->opcode, hash_arguments(*this));
+  }
+
+  // Impure instructions are identified by the instruction alone.
+  if (!is_pure(*this->I)) {
+    return this->ValueExpression::hash();
+  }
+
+  // Pure instructions hash alike if they are structurally equal.
+  return llvm::hash_combine(this->EK,
+                            this->opcode,
+                            this->I->getType(),
+                            hash_arguments(*this));
+}
+
+// CastExpression
+bool CastExpression::equals(const ValueExpression &E) const {
+  CHECK_OTHER(E, CastExpression);
+  return (&(this->dest_type) == &(OE.dest_type))
+         && this->BasicExpression::equals(E);
+}
+
+llvm::hash_code CastExpression::hash() const {
+  return llvm::hash_combine(this->BasicExpression::hash(), &this->dest_type);
+}
+
+// ICmpExpression
+bool ICmpExpression::equals(const ValueExpression &E) const {
+  CHECK_OTHER(E, ICmpExpression);
+  return (this->predicate == OE.predicate) && this->BasicExpression::equals(E);
+}
+
+llvm::hash_code ICmpExpression::hash() const {
+  return llvm::hash_combine(this->BasicExpression::hash(), this->predicate);
+}
+
 // PHIExpression
 bool PHIExpression::equals(const ValueExpression &E) const {
   CHECK_OTHER(E, PHIExpression);
-  // TODO
-  return false;
+
+  // Realized expressions are equal if they are the same PHI.
+  if ((this->phi != nullptr) || (OE.phi != nullptr)) {
+    return this->phi == OE.phi;
+  }
+
+  return same_arguments(*this, OE)
+         && (this->incoming_blocks == OE.incoming_blocks);
+}
+
+llvm::hash_code PHIExpression::hash() const {
+  return llvm::hash_combine(this->BasicExpression::hash(),
+                            this->phi,
+                            llvm::hash_combine_range(
+                                this->incoming_blocks.begin(),
+                                this->incoming_blocks.end()));
 }
 
 // SizeExpression
 bool SizeExpression::equals(const ValueExpression &E) const {
   CHECK_OTHER(E, SizeExpression);
-  // TODO
-  return false;
+  return (this->CE != nullptr) && (this->CE == OE.CE);
+}
+
+llvm::hash_code SizeExpression::hash() const {
+  return llvm::hash_combine(this->EK, this->CE);
 }
 
 // EndExpression
 bool EndExpression::equals(const ValueExpression &E) const {
   CHECK_OTHER(E, EndExpression);
-  // TODO
-  return false;
+  return true;
+}
+
+// Distinctness.
+bool is_distinct(ValueExpression &E1, ValueExpression &E2) {
+  auto *const1 = dyn_cast<ConstantExpression>(&E1);
+  auto *const2 = dyn_cast<ConstantExpression>(&E2);
+  if (const1 == nullptr || const2 == nullptr) {
+    return false;
+  }
+
+  // Integer constants are uniqued, so different constants differ in value.
+  auto *int1 = dyn_cast<llvm::ConstantInt>(&const1->getConstant());
+  auto *int2 = dyn_cast<llvm::ConstantInt>(&const2->getConstant());
+  return (int1 != nullptr) && (int2 != nullptr)
+         && (int1->getType() == int2->getType()) && (int1 != int2);
 }
 
 } // namespace llvm::memoir
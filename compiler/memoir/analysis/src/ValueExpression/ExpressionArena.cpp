@@ -0,0 +1,38 @@
+#include "memoir/analysis/ExpressionArena.hpp"
+
+namespace llvm::memoir {
+
+ValueExpression &ExpressionArena::intern(ValueExpression &E) {
+  // If the expression is already interned, return it.
+  if (E.interned) {
+    return E;
+  }
+
+  // Precompute the hash.
+  auto hash = E.hash();
+
+  // Search the bucket for a structurally equal expression.
+  auto &bucket = this->interned[hash];
+  for (auto *existing : bucket) {
+    if (existing->equals(E)) {
+      return *existing;
+    }
+  }
+
+  // Otherwise, this is the canonical expression.
+  E.interned = true;
+  E.hash_value = hash;
+  bucket.push_back(&E);
+
+  return E;
+}
+
+ExpressionArena::~ExpressionArena() {
+  // The allocator frees the memory in bulk, but the expressions own vectors
+  // that need to be destroyed.
+  for (auto *expr : this->expressions) {
+    expr->~ValueExpression();
+  }
+}
+
+} // namespace llvm::memoir
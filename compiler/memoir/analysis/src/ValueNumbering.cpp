@@ -98,15 +98,16 @@ ValueExpression *ValueNumbering::lookupOrInsert(llvm::Value &V,
   // Sanity check.
   MEMOIR_NULL_CHECK(expr, "Expression is NULL!");
 
-  // Lookup the LLVM Value. If we find it, return it and delete the temporary.
+  // Lookup the LLVM Value. If we find it, return it.
+  // The temporary is freed along with the arena.
   if (auto *found_expr = this->lookup(V)) {
-    delete expr;
     return found_expr;
   }
 
-  // Otherwise, insert the temporary expr and return.
-  this->VT.insert(V, *expr);
-  return expr;
+  // Otherwise, intern the temporary expr, insert it and return.
+  auto &interned_expr = this->arena.intern(*expr);
+  this->VT.insert(V, interned_expr);
+  return &interned_expr;
 }
 
 ValueExpression *ValueNumbering::lookupOrInsert(llvm::Use &U,
@@ -114,15 +115,28 @@ ValueExpression *ValueNumbering::lookupOrInsert(llvm::Use &U,
   // Sanity check.
   MEMOIR_NULL_CHECK(expr, "Expression is NULL!");
 
-  // Lookup the LLVM Value. If we find it, return it and delete the temporary.
+  // Lookup the LLVM Value. If we find it, return it.
+  // The temporary is freed along with the arena.
   if (auto *found_expr = this->lookup(U)) {
-    delete expr;
     return found_expr;
   }
 
-  // Otherwise, insert the temporary expr and return.
-  this->VT.insert(U, *expr);
-  return expr;
+  // Otherwise, intern the temporary expr, insert it and return.
+  auto &interned_expr = this->arena.intern(*expr);
+  this->VT.insert(U, interned_expr);
+  return &interned_expr;
+}
+
+ValueExpression *ValueNumbering::intern(llvm::Value &V,
+                                        ValueExpression *expr) {
+  // Sanity check.
+  MEMOIR_NULL_CHECK(expr, "Expression is NULL!");
+
+  // Replace the expression of @V with its canonical expression. Expressions
+  // on a cycle may still refer to @expr, which remains valid in the arena.
+  auto &interned_expr = this->arena.intern(*expr);
+  this->VT.insert(V, interned_expr);
+  return &interned_expr;
 }
 
 // Value visitors.
@@ -154,15 +168,15 @@ ValueExpression *ValueNumbering::visitValue(llvm::Value &V) {
     return this->visitConstant(*constant);
   }
 
-  return this->lookupOrInsert(V, new UnknownExpression());
+  return this->lookupOrInsert(V, &this->arena.create<UnknownExpression>());
 }
 
 ValueExpression *ValueNumbering::visitArgument(llvm::Argument &A) {
-  return this->lookupOrInsert(A, new ArgumentExpression(A));
+  return this->lookupOrInsert(A, &this->arena.create<ArgumentExpression>(A));
 }
 
 ValueExpression *ValueNumbering::visitConstant(llvm::Constant &C) {
-  return this->lookupOrInsert(C, new ConstantExpression(C));
+  return this->lookupOrInsert(C, &this->arena.create<ConstantExpression>(C));
 }
 
 // InstVisitor implementation.
@@ -172,7 +186,7 @@ ValueExpression *ValueNumbering::visitInstruction(llvm::Instruction &I) {
   if (auto *found_expr = this->lookup(I)) {
     return found_expr;
   }
-  auto *expr = new BasicExpression(I);
+  auto *expr = &this->arena.create<BasicExpression>(I);
   this->insert(I, expr);
 
   // Otherwise, let's initialize it.
@@ -184,8 +198,8 @@ ValueExpression *ValueNumbering::visitInstruction(llvm::Instruction &I) {
     expr->arguments.push_back(op_expr);
   }
 
-  // Return it.
-  return expr;
+  // Intern it and return the canonical expression.
+  return this->intern(I, expr);
 }
 
 ValueExpression *ValueNumbering::visitCastInst(llvm::CastInst &I) {
@@ -193,7 +207,7 @@ ValueExpression *ValueNumbering::visitCastInst(llvm::CastInst &I) {
   if (auto *found_expr = this->lookup(I)) {
     return found_expr;
   }
-  auto *expr = new CastExpression(I);
+  auto *expr = &this->arena.create<CastExpression>(I);
   this->insert(I, expr);
 
   // If it is already initialized correctly, return.
@@ -210,8 +224,8 @@ ValueExpression *ValueNumbering::visitCastInst(llvm::CastInst &I) {
     expr->arguments.push_back(op_expr);
   }
 
-  // Return it.
-  return expr;
+  // Intern it and return the canonical expression.
+  return this->intern(I, expr);
 }
 
 ValueExpression *ValueNumbering::visitICmpInst(llvm::ICmpInst &I) {
@@ -220,7 +234,7 @@ ValueExpression *ValueNumbering::visitICmpInst(llvm::ICmpInst &I) {
   if (expr = this->lookup(I)) {
     return expr;
   }
-  expr = new ICmpExpression(I);
+  expr = &this->arena.create<ICmpExpression>(I);
   this->insert(I, expr);
 
   // If it is already initialized correctly, return.
@@ -237,8 +251,8 @@ ValueExpression *ValueNumbering::visitICmpInst(llvm::ICmpInst &I) {
     expr->arguments.push_back(op_expr);
   }
 
-  // Return it.
-  return expr;
+  // Intern it and return the canonical expression.
+  return this->intern(I, expr);
 }
 
 ValueExpression *ValueNumbering::visitPHINode(llvm::PHINode &I) {
@@ -254,7 +268,7 @@ ValueExpression *ValueNumbering::visitPHINode(llvm::PHINode &I) {
     if (auto *found_expr = this->lookup(I)) {
       return found_expr;
     }
-    auto *expr = new SelectExpression(I);
+    auto *expr = &this->arena.create<SelectExpression>(I);
     this->insert(I, expr);
 
     // Get the expression of the condition value.
@@ -295,14 +309,14 @@ ValueExpression *ValueNumbering::visitPHINode(llvm::PHINode &I) {
     expr->arguments.push_back(true_expr);
     expr->arguments.push_back(false_expr);
 
-    return expr;
+    return this->intern(I, expr);
   }
 
   // Get or create the PHIExpression.
   if (auto *found_expr = this->lookup(I)) {
     return found_expr;
   }
-  auto *expr = new PHIExpression(I);
+  auto *expr = &this->arena.create<PHIExpression>(I);
   this->insert(I, expr);
 
   // Otherwise, let's initialize it.
@@ -321,15 +335,15 @@ ValueExpression *ValueNumbering::visitPHINode(llvm::PHINode &I) {
     expr->arguments.push_back(op_expr);
   }
 
-  // Return it.
-  return expr;
+  // Intern it and return the canonical expression.
+  return this->intern(I, expr);
 }
 
 ValueExpression *ValueNumbering::visitLLVMCallInst(llvm::CallInst &I) {
   if (auto *found_expr = this->lookup(I)) {
     return found_expr;
   }
-  auto *expr = new CallExpression(I);
+  auto *expr = &this->arena.create<CallExpression>(I);
   this->insert(I, expr);
 
   // TODO: initialize arguments.
@@ -341,7 +355,7 @@ ValueExpression *ValueNumbering::visitSizeInst(SizeInst &I) {
   if (auto *found_expr = this->lookup(I)) {
     return found_expr;
   }
-  auto *size_expr = new SizeExpression();
+  auto *size_expr = &this->arena.create<SizeExpression>();
   this->insert(I, size_expr);
 
   // Get the collection expression.
@@ -353,7 +367,7 @@ ValueExpression *ValueNumbering::visitSizeInst(SizeInst &I) {
   size_expr->CE = collection_expr;
 
   // Return.
-  return size_expr;
+  return this->intern(I.getCallInst(), size_expr);
 }
 
 } // namespace llvm::memoir
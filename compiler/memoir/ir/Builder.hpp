@@ -61,6 +61,8 @@ public:
             return this->CreateUInt16TypeInst(name);
           case 8:
             return this->CreateUInt8TypeInst(name);
+          case 1:
+            return this->CreateBoolTypeInst(name);
           default:
             MEMOIR_UNREACHABLE(
                 "Attempt to create unknown unsigned integer type!");
@@ -145,6 +147,22 @@ public:
                                               name);
   }
 
+  DefineStructTypeInst *CreateDefineStructTypeInst(const char *type_name,
+                                                   vector<Type *> field_types,
+                                                   const Twine &name = "") {
+    // Create the type instructions for each field.
+    vector<llvm::Value *> field_type_values = {};
+    for (auto *field_type : field_types) {
+      field_type_values.push_back(
+          &this->CreateTypeInst(*field_type)->getCallInst());
+    }
+
+    return this->CreateDefineStructTypeInst(type_name,
+                                            field_types.size(),
+                                            field_type_values,
+                                            name);
+  }
+
   StructTypeInst *CreateStructTypeInst(llvm::Value *llvm_type_name,
                                        const Twine &name = "") {
 
@@ -237,7 +255,49 @@ public:
                                              name);
   }
 
+  // Struct allocation
+  StructAllocInst *CreateStructAllocInst(Type &type, const Twine &name = "") {
+    return this->CreateStructAllocInst(
+        &this->CreateTypeInst(type)->getCallInst(),
+        name);
+  }
+
+  StructAllocInst *CreateStructAllocInst(llvm::Value *type,
+                                         const Twine &name = "") {
+    return this->create<StructAllocInst>(MemOIR_Func::ALLOCATE_STRUCT,
+                                         { type },
+                                         name);
+  }
+
   // Access Instructions
+  StructReadInst *CreateStructReadInst(Type &element_type,
+                                       llvm::Value *llvm_collection,
+                                       llvm::Value *llvm_field_index,
+                                       const Twine &name = "") {
+    return this->create<StructReadInst>(
+        getStructReadEnumForType(element_type),
+        { llvm_collection, llvm_field_index },
+        name);
+  }
+
+  IndexReadInst *CreateIndexReadInst(Type &element_type,
+                                     llvm::Value *llvm_collection,
+                                     llvm::Value *llvm_index,
+                                     const Twine &name = "") {
+    return this->create<IndexReadInst>(getIndexReadEnumForType(element_type),
+                                       { llvm_collection, llvm_index },
+                                       name);
+  }
+
+  AssocGetInst *CreateAssocGetInst(Type &element_type,
+                                   llvm::Value *llvm_collection,
+                                   llvm::Value *llvm_assoc,
+                                   const Twine &name = "") {
+    return this->create<AssocGetInst>(getAssocGetEnumForType(element_type),
+                                      { llvm_collection, llvm_assoc },
+                                      name);
+  }
+
   StructWriteInst *CreateStructWriteInst(Type &element_type,
                                          llvm::Value *llvm_value_to_write,
                                          llvm::Value *llvm_collection,
@@ -305,6 +365,15 @@ public:
                                               { collection_to_delete });
   }
 
+  // Clear Instructions
+  ClearInst *CreateClearInst(llvm::Value *collection, const Twine &name = "") {
+    return this->create<ClearInst>(MemOIR_Func::CLEAR, { collection }, name);
+  }
+
+  MutClearInst *CreateMutClearInst(llvm::Value *collection) {
+    return this->create<MutClearInst>(MemOIR_Func::MUT_CLEAR, { collection });
+  }
+
   // Assoc operations.
   //// SSA assoc operations.
   AssocInsertInst *CreateAssocInsertInst(llvm::Value *collection,
@@ -374,6 +443,18 @@ public:
                                        name);
   }
 
+  SeqFillInst *CreateSeqFillInst(Type &element_type,
+                                 llvm::Value *llvm_value_to_write,
+                                 llvm::Value *llvm_collection,
+                                 llvm::Value *llvm_begin,
+                                 llvm::Value *llvm_end,
+                                 const Twine &name = "") {
+    return this->create<SeqFillInst>(
+        getSeqFillEnumForType(element_type),
+        { llvm_value_to_write, llvm_collection, llvm_begin, llvm_end },
+        name);
+  }
+
   SeqInsertInst *CreateSeqInsertInst(Type &element_type,
                                      llvm::Value *llvm_value_to_write,
                                      llvm::Value *llvm_collection,
@@ -490,6 +571,18 @@ public:
                                           name);
   }
 
+  MutSeqFillInst *CreateMutSeqFillInst(Type &element_type,
+                                       llvm::Value *llvm_value_to_write,
+                                       llvm::Value *llvm_collection,
+                                       llvm::Value *llvm_begin,
+                                       llvm::Value *llvm_end,
+                                       const Twine &name = "") {
+    return this->create<MutSeqFillInst>(
+        getMutSeqFillEnumForType(element_type),
+        { llvm_value_to_write, llvm_collection, llvm_begin, llvm_end },
+        name);
+  }
+
   MutSeqInsertInst *CreateMutSeqInsertInst(Type &element_type,
                                            llvm::Value *llvm_value_to_write,
                                            llvm::Value *llvm_collection,
@@ -525,6 +618,13 @@ public:
     return this->create<EndInst>(MemOIR_Func::END, {}, name);
   }
 
+  //// Capacity operations.
+  SeqReserveInst *CreateSeqReserveInst(llvm::Value *collection,
+                                       llvm::Value *capacity) {
+    return this->create<SeqReserveInst>(MemOIR_Func::SEQ_RESERVE,
+                                        { collection, capacity });
+  }
+
   //// SSA renaming operations.
   UsePHIInst *CreateUsePHI(llvm::Value *collection, const Twine &name = "") {
     return this->create<UsePHIInst>(MemOIR_Func::USE_PHI, { collection }, name);
@@ -672,6 +772,8 @@ protected:
             return MemOIR_Func::ENUM_PREFIX##_UINT16;                          \
           case 8:                                                              \
             return MemOIR_Func::ENUM_PREFIX##_UINT8;                           \
+          case 1:                                                              \
+            return MemOIR_Func::ENUM_PREFIX##_BOOL;                            \
           default:                                                             \
             MEMOIR_UNREACHABLE(                                                \
                 "Attempt to create unknown unsigned integer type!");           \
@@ -706,10 +808,12 @@ protected:
   ENUM_FOR_PRIMITIVE_TYPE(ASSOC_WRITE, AssocWrite)
   ENUM_FOR_PRIMITIVE_TYPE(STRUCT_WRITE, StructWrite)
   ENUM_FOR_PRIMITIVE_TYPE(SEQ_INSERT, SeqInsert)
+  ENUM_FOR_PRIMITIVE_TYPE(SEQ_FILL, SeqFill)
   ENUM_FOR_PRIMITIVE_TYPE(MUT_INDEX_WRITE, MutIndexWrite)
   ENUM_FOR_PRIMITIVE_TYPE(MUT_ASSOC_WRITE, MutAssocWrite)
   ENUM_FOR_PRIMITIVE_TYPE(MUT_STRUCT_WRITE, MutStructWrite)
   ENUM_FOR_PRIMITIVE_TYPE(MUT_SEQ_INSERT, MutSeqInsert)
+  ENUM_FOR_PRIMITIVE_TYPE(MUT_SEQ_FILL, MutSeqFill)
 
 #define ENUM_FOR_NESTED_TYPE(ENUM_PREFIX, NAME)                                \
   MemOIR_Func get##NAME##EnumForType(Type &type) {                             \
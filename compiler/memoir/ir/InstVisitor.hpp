@@ -160,6 +160,12 @@ public:
     DELEGATE(RemoveInst);                                                      \
   };
 
+  // Fill instruction hierarchy.
+  RetTy visitSeqFillInst(SeqFillInst &I) {
+    DELEGATE(MemOIRInst);
+  };
+#define HANDLE_SEQ_FILL_INST(ENUM, FUNC, CLASS) /* No handling. */
+
   // Copy instruction hierarchy.
   RetTy visitCopyInst(CopyInst &I) {
     DELEGATE(MemOIRInst);
@@ -209,6 +215,12 @@ public:
   };
 #define HANDLE_SEQ_INSERT_INST(ENUM, FUNC, CLASS) /* No handling. */
 
+  // MutSeqFillInst hierarchy.
+  RetTy visitMutSeqFillInst(MutSeqFillInst &I) {
+    DELEGATE(MutInst);
+  };
+#define HANDLE_SEQ_FILL_INST(ENUM, FUNC, CLASS) /* No handling. */
+
 #include "memoir/ir/MutOperations.def"
 
 protected:
@@ -1014,6 +1014,39 @@ protected:
   friend class MemOIRInst;
 };
 
+// Sequence fill operations.
+struct SeqFillInst : public MemOIRInst {
+public:
+  llvm::Value &getResultCollection() const;
+
+  llvm::Value &getValueWritten() const;
+  llvm::Use &getValueWrittenAsUse() const;
+
+  llvm::Value &getBaseCollection() const;
+  llvm::Use &getBaseCollectionAsUse() const;
+
+  llvm::Value &getBeginIndex() const;
+  llvm::Use &getBeginIndexAsUse() const;
+
+  llvm::Value &getEndIndex() const;
+  llvm::Use &getEndIndexAsUse() const;
+
+  static bool classof(const MemOIRInst *I) {
+    return
+#define HANDLE_SEQ_FILL_INST(ENUM, FUNC, CLASS)                                \
+  (I->getKind() == MemOIR_Func::ENUM) ||
+#include "memoir/ir/Instructions.def"
+        false;
+  };
+
+  std::string toString(std::string indent = "") const override;
+
+protected:
+  SeqFillInst(llvm::CallInst &call_inst) : MemOIRInst(call_inst) {}
+
+  friend class MemOIRInst;
+};
+
 struct SwapInst : public MemOIRInst {
   llvm::Value &getResult() const;
 
@@ -1190,6 +1223,26 @@ protected:
   friend class MemOIRInst;
 };
 
+struct SeqReserveInst : public MemOIRInst {
+public:
+  llvm::Value &getCollection() const;
+  llvm::Use &getCollectionAsUse() const;
+
+  llvm::Value &getCapacity() const;
+  llvm::Use &getCapacityAsUse() const;
+
+  static bool classof(const MemOIRInst *I) {
+    return (I->getKind() == MemOIR_Func::SEQ_RESERVE);
+  };
+
+  std::string toString(std::string indent = "") const override;
+
+protected:
+  SeqReserveInst(llvm::CallInst &call_inst) : MemOIRInst(call_inst){};
+
+  friend class MemOIRInst;
+};
+
 // Assoc operations.
 struct AssocHasInst : public AccessInst {
 public:
@@ -1422,6 +1475,25 @@ protected:
   friend class MemOIRInst;
 };
 
+struct ClearInst : public MemOIRInst {
+public:
+  llvm::Value &getResultCollection() const;
+
+  llvm::Value &getBaseCollection() const;
+  llvm::Use &getBaseCollectionAsUse() const;
+
+  static bool classof(const MemOIRInst *I) {
+    return (I->getKind() == MemOIR_Func::CLEAR);
+  };
+
+  std::string toString(std::string indent = "") const override;
+
+protected:
+  ClearInst(llvm::CallInst &call_inst) : MemOIRInst(call_inst){};
+
+  friend class MemOIRInst;
+};
+
 // Type checking
 struct AssertStructTypeInst : public MemOIRInst {
 public:
@@ -201,6 +201,37 @@ protected:
   friend class MemOIRInst;
 };
 
+// Fill operation
+struct MutSeqFillInst : public MutInst {
+public:
+  llvm::Value &getValueWritten() const;
+  llvm::Use &getValueWrittenAsUse() const;
+
+  llvm::Value &getCollection() const;
+  llvm::Use &getCollectionAsUse() const;
+
+  llvm::Value &getBeginIndex() const;
+  llvm::Use &getBeginIndexAsUse() const;
+
+  llvm::Value &getEndIndex() const;
+  llvm::Use &getEndIndexAsUse() const;
+
+  static bool classof(const MemOIRInst *I) {
+    return
+#define HANDLE_SEQ_FILL_INST(ENUM, FUNC, CLASS)                                \
+  (I->getKind() == MemOIR_Func::ENUM) ||
+#include "memoir/ir/MutOperations.def"
+        false;
+  };
+
+  std::string toString(std::string indent = "") const override;
+
+protected:
+  MutSeqFillInst(llvm::CallInst &call_inst) : MutInst(call_inst){};
+
+  friend class MemOIRInst;
+};
+
 // Append operation
 struct MutSeqAppendInst : public MutInst {
 public:
@@ -327,6 +358,23 @@ protected:
   friend class MemOIRInst;
 };
 
+struct MutClearInst : public MutInst {
+public:
+  llvm::Value &getCollection() const;
+  llvm::Use &getCollectionAsUse() const;
+
+  static bool classof(const MemOIRInst *I) {
+    return (I->getKind() == MemOIR_Func::MUT_CLEAR);
+  };
+
+  std::string toString(std::string indent = "") const override;
+
+protected:
+  MutClearInst(llvm::CallInst &call_inst) : MutInst(call_inst){};
+
+  friend class MemOIRInst;
+};
+
 struct MutAssocRemoveInst : public MutInst {
 public:
   llvm::Value &getCollection() const;
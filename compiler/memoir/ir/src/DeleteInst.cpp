@@ -12,4 +12,9 @@ TO_STRING(DeleteStructInst)
 OPERAND(DeleteCollectionInst, DeletedCollection, 0)
 TO_STRING(DeleteCollectionInst)
 
+// ClearInst implementation
+RESULTANT(ClearInst, ResultCollection)
+OPERAND(ClearInst, BaseCollection, 0)
+TO_STRING(ClearInst)
+
 } // namespace llvm::memoir
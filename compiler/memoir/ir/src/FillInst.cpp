@@ -0,0 +1,15 @@
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/utility/InstructionUtils.hpp"
+
+namespace llvm::memoir {
+
+// SeqFillInst implementation.
+RESULTANT(SeqFillInst, ResultCollection)
+OPERAND(SeqFillInst, ValueWritten, 0)
+OPERAND(SeqFillInst, BaseCollection, 1)
+OPERAND(SeqFillInst, BeginIndex, 2)
+OPERAND(SeqFillInst, EndIndex, 3)
+TO_STRING(SeqFillInst)
+
+} // namespace llvm::memoir
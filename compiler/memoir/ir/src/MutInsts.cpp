@@ -60,6 +60,13 @@ OPERAND(MutSeqRemoveInst, BeginIndex, 1)
 OPERAND(MutSeqRemoveInst, EndIndex, 2)
 TO_STRING(MutSeqRemoveInst)
 
+// MutSeqFillInst implementation.
+OPERAND(MutSeqFillInst, ValueWritten, 0)
+OPERAND(MutSeqFillInst, Collection, 1)
+OPERAND(MutSeqFillInst, BeginIndex, 2)
+OPERAND(MutSeqFillInst, EndIndex, 3)
+TO_STRING(MutSeqFillInst)
+
 // MutSeqAppendInst implementation.
 OPERAND(MutSeqAppendInst, Collection, 0)
 OPERAND(MutSeqAppendInst, AppendedCollection, 1)
@@ -88,6 +95,10 @@ OPERAND(MutSeqSplitInst, BeginIndex, 1)
 OPERAND(MutSeqSplitInst, EndIndex, 2)
 TO_STRING(MutSeqSplitInst)
 
+// MutClearInst implementation.
+OPERAND(MutClearInst, Collection, 0)
+TO_STRING(MutClearInst)
+
 // MutAssocRemoveInst implementation.
 OPERAND(MutAssocRemoveInst, Collection, 0)
 OPERAND(MutAssocRemoveInst, KeyOperand, 1)
@@ -15,4 +15,9 @@ TO_STRING(SizeInst)
 RESULTANT(EndInst, Value)
 TO_STRING(EndInst)
 
+// SeqReserveInst implementation
+OPERAND(SeqReserveInst, Collection, 0)
+OPERAND(SeqReserveInst, Capacity, 1)
+TO_STRING(SeqReserveInst)
+
 } // namespace llvm::memoir
@@ -29,10 +29,16 @@ public:
 
   void implement_type(TypeLayout &struct_type_layout);
 
+  void implement_arena(TypeLayout &struct_type_layout);
+
+  // Returns the symbol prefix of the arena for the given struct type.
+  static std::string get_arena_prefix(StructType &struct_type);
+
   void emit(llvm::raw_ostream &os = llvm::errs());
 
 protected:
   ordered_set<TypeLayout *> struct_implementations;
+  ordered_set<TypeLayout *> arena_implementations;
   ordered_multimap<std::string, TypeLayout *> seq_implementations;
   ordered_multimap<std::string, tuple<TypeLayout *, TypeLayout *>>
       assoc_implementations;
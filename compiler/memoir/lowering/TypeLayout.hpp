@@ -2,6 +2,12 @@
 #define MEMOIR_TYPECONVERTER_H
 #pragma once
 
+#include <algorithm>
+
+#include "llvm/IR/Module.h"
+
+#include "llvm/Support/CommandLine.h"
+
 #include "memoir/support/Assert.hpp"
 #include "memoir/support/InternalDatatypes.hpp"
 #include "memoir/support/Print.hpp"
@@ -19,6 +25,12 @@
 
 namespace llvm::memoir {
 
+// When set, references to structs stored in struct fields are lowered to 32-bit
+// offsets into the arena of the referenced struct type. Struct types that are
+// stored inline, in another struct or in a collection, are never compressed,
+// since references to them may point outside of their arena.
+extern llvm::cl::opt<bool> CompressReferences;
+
 #define CHECK_MEMOIZED(T)                                                      \
   auto found_type = this->memoir_to_type_layout.find(&T);                      \
   if (found_type != this->memoir_to_type_layout.end()) {                       \
@@ -57,6 +69,16 @@ public:
       llvm_type(llvm_struct_type),
       field_offsets(field_offsets),
       bit_field_ranges(bit_field_ranges) {}
+  TypeLayout(StructType &memoir_struct_type,
+             llvm::StructType &llvm_struct_type,
+             vector<unsigned> field_offsets,
+             map<unsigned, pair<unsigned, unsigned>> bit_field_ranges,
+             set<unsigned> compressed_references)
+    : memoir_type(memoir_struct_type),
+      llvm_type(llvm_struct_type),
+      field_offsets(field_offsets),
+      bit_field_ranges(bit_field_ranges),
+      compressed_references(compressed_references) {}
 
   Type &get_memoir_type() const {
     return memoir_type;
@@ -92,11 +114,18 @@ public:
     return {};
   }
 
+  // A compressed reference is stored as a 32-bit offset into the arena of the
+  // referenced struct type, with offset 0 being the null reference.
+  bool is_compressed_reference(unsigned field_index) const {
+    return (this->compressed_references.count(field_index) > 0);
+  }
+
 protected:
   Type &memoir_type;
   llvm::Type &llvm_type;
   vector<unsigned> field_offsets;
   map<unsigned, pair<unsigned, unsigned>> bit_field_ranges;
+  set<unsigned> compressed_references;
 }; // struct TypeLayout
 
 class TypeConverter : public TypeVisitor<TypeConverter, TypeLayout &> {
@@ -104,7 +133,14 @@ class TypeConverter : public TypeVisitor<TypeConverter, TypeLayout &> {
 
 public:
   // Construction.
-  TypeConverter(llvm::LLVMContext &C) : TypeVisitor(), C(C) {}
+  TypeConverter(llvm::Module &M, bool compress_references = CompressReferences)
+    : TypeVisitor(),
+      C(M.getContext()),
+      compress_references(compress_references) {
+    if (compress_references) {
+      this->inline_struct_types = find_inline_struct_types(M);
+    }
+  }
 
   TypeLayout &convert(Type &T) {
     return this->visit(T);
@@ -257,6 +293,50 @@ protected:
     MEMOIR_UNREACHABLE("FieldArrayType lowering is unimplemented.");
   }
 
+  // The widest word that bit fields are packed into.
+  static constexpr unsigned max_bit_field_word = 64;
+
+  // Returns the size in bytes of @T within a packed struct. Pointers are
+  // assumed to be 64 bits.
+  static unsigned get_layout_size(llvm::Type &T) {
+    if (T.isPointerTy()) {
+      return 8;
+    } else if (auto *struct_type = dyn_cast<llvm::StructType>(&T)) {
+      unsigned size = 0;
+      for (auto *element_type : struct_type->elements()) {
+        size += get_layout_size(*element_type);
+      }
+      return size;
+    } else if (auto *array_type = dyn_cast<llvm::ArrayType>(&T)) {
+      return array_type->getNumElements()
+             * get_layout_size(*array_type->getElementType());
+    }
+    return get_next_size(T.getPrimitiveSizeInBits()) / 8;
+  }
+
+  // Returns the natural alignment in bytes of @T, aggregates are aligned to
+  // their most aligned element.
+  static unsigned get_layout_alignment(llvm::Type &T) {
+    if (auto *struct_type = dyn_cast<llvm::StructType>(&T)) {
+      unsigned alignment = 1;
+      for (auto *element_type : struct_type->elements()) {
+        alignment = std::max(alignment, get_layout_alignment(*element_type));
+      }
+      return alignment;
+    } else if (auto *array_type = dyn_cast<llvm::ArrayType>(&T)) {
+      return get_layout_alignment(*array_type->getElementType());
+    }
+    return std::min(get_layout_size(T), max_alignment);
+  }
+
+  // The largest natural alignment of a field.
+  static constexpr unsigned max_alignment = 16;
+
+  // Returns the padding needed to align @offset to @alignment.
+  static unsigned get_padding(unsigned offset, unsigned alignment) {
+    return (alignment - (offset % alignment)) % alignment;
+  }
+
   TypeLayout &visitStructType(StructType &T) {
     CHECK_MEMOIZED(T);
 
@@ -273,100 +353,137 @@ protected:
     vector<llvm::Type *> llvm_field_types;
     llvm_field_types.reserve(num_fields);
     map<unsigned, pair<unsigned, unsigned>> bit_field_ranges = {};
+    set<unsigned> compressed_references = {};
+
+    // Each slot is an element of the LLVM struct, holding either a single
+    // field or a word of bit fields.
+    struct Slot {
+      llvm::Type *llvm_type;
+      vector<unsigned> field_indices;
+      unsigned bit_width;
+    };
+    vector<Slot> slots = {};
+    vector<pair<unsigned, unsigned>> bit_fields = {};
 
     // Get the type layout of each field.
-    unsigned current_field_width = 0;
-    unsigned current_field_offset = 0;
-    for (auto field_index = 0; field_index < num_fields; ++field_index) {
+    for (unsigned field_index = 0; field_index < num_fields; ++field_index) {
       // Get the field type.
       auto &field_type = T.getFieldType(field_index);
 
-      // Convert the field type to its type layout.
-      auto &field_layout = this->visit(field_type);
-      auto &llvm_field_type = field_layout.get_llvm_type();
-
-      // If this is an integer type, and it is a non-power-of-2, figure out if
-      // it needs a bit field representation.
-      bool is_bit_field = false;
-      if (auto *field_int_type =
-              dyn_cast<llvm::IntegerType>(&llvm_field_type)) {
-        if (field_layout.is_bit_field(0)) {
-          // Write the bit field range.
-          auto bit_field_width = (*field_layout.get_bit_field_range(0)).second;
-          auto bit_field_start = current_field_width;
-          current_field_width += bit_field_width;
-          bit_field_ranges[field_index] =
-              make_pair(bit_field_start, current_field_width);
-          debugln("new bit field (",
-                  bit_field_start,
-                  ", ",
-                  current_field_width,
-                  ")");
-
-          // Mark this as a bit field so that we don't increment the field
-          // offset.
-          is_bit_field = true;
+      // If this is a reference to a struct that is only ever allocated from
+      // its arena, and references are compressed, store it as a 32-bit offset
+      // into the arena of the referenced type.
+      if (auto *ref_type = dyn_cast<ReferenceType>(&field_type)) {
+        auto *referenced_type =
+            dyn_cast<StructType>(&ref_type->getReferencedType());
+        if (this->compress_references && referenced_type != nullptr
+            && this->inline_struct_types.count(referenced_type) == 0) {
+          compressed_references.insert(field_index);
+          auto *offset_type = llvm::Type::getInt32Ty(this->C);
+          slots.push_back(Slot{ offset_type, { field_index }, 0 });
+          continue;
         }
       }
 
-      // If we were in a bit field, but no longer are, commit the previous bit
-      // field before handling this one.
-      // Get the integer type.
-      if (!is_bit_field && current_field_width != 0) {
-        // Get the integer type.
-        auto *bit_field_int_type =
-            llvm::IntegerType::get(this->C, current_field_width);
-
-        // Append the bit field aggregate type.
-        llvm_field_types.push_back(bit_field_int_type);
-
-        // Reset the bit field information.
-        current_field_width = 0;
+      // Convert the field type to its type layout.
+      auto &field_layout = this->visit(field_type);
+      auto &llvm_field_type = field_layout.get_llvm_type();
 
-        // Increment the field offset.
-        ++current_field_offset;
+      // If this is a non-power-of-2 integer type, it needs a bit field
+      // representation.
+      if (isa<llvm::IntegerType>(&llvm_field_type)
+          && field_layout.is_bit_field(0)) {
+        auto bit_field_width = (*field_layout.get_bit_field_range(0)).second;
+        bit_fields.push_back(make_pair(field_index, bit_field_width));
+        continue;
       }
 
-      // Record the field offset.
-      field_offsets[field_index] = current_field_offset;
-
-      // Handle bit fields.
-      if (is_bit_field) {
-        // If the new field offset is a size, then instantiate that field.
-        if (is_size(current_field_width)) {
-          // Get the integer type.
-          auto *bit_field_int_type =
-              llvm::IntegerType::get(this->C, current_field_width);
-
-          // Append the bit field aggregate type.
-          llvm_field_types.push_back(bit_field_int_type);
-        }
+      // Otherwise, the field gets a slot of its own.
+      slots.push_back(Slot{ &llvm_field_type, { field_index }, 0 });
+    }
 
-        // Otherwise, continue.
-        else {
-          continue;
+    // Pack the bit fields into shared words, widest first, placing each into
+    // the first word with room for it, regardless of declaration order.
+    std::stable_sort(bit_fields.begin(),
+                     bit_fields.end(),
+                     [](const auto &lhs, const auto &rhs) {
+                       return lhs.second > rhs.second;
+                     });
+    vector<Slot> bit_field_words = {};
+    for (auto const &[field_index, bit_field_width] : bit_fields) {
+      auto word_it = bit_field_words.begin();
+      for (; word_it != bit_field_words.end(); ++word_it) {
+        if (word_it->bit_width + bit_field_width <= max_bit_field_word) {
+          break;
         }
       }
+      if (word_it == bit_field_words.end()) {
+        auto empty_word = Slot{ nullptr, {}, 0 };
+        word_it = bit_field_words.insert(bit_field_words.end(), empty_word);
+      }
 
-      // Reset the bit field information.
-      current_field_width = 0;
+      // Write the bit field range.
+      auto bit_field_start = word_it->bit_width;
+      word_it->bit_width += bit_field_width;
+      bit_field_ranges[field_index] =
+          make_pair(bit_field_start, word_it->bit_width);
+      word_it->field_indices.push_back(field_index);
+      debugln("new bit field (",
+              bit_field_start,
+              ", ",
+              word_it->bit_width,
+              ")");
+    }
+    for (auto &word : bit_field_words) {
+      auto bit_field_size = get_next_size(word.bit_width);
+      debugln(word.bit_width, " ==> ", bit_field_size);
+      word.llvm_type = llvm::IntegerType::get(this->C, bit_field_size);
+      slots.push_back(word);
+    }
 
-      // Increment the field offset.
-      ++current_field_offset;
+    // Order the slots from most to least aligned, and then from largest to
+    // smallest, so that fields are naturally aligned within the packed struct
+    // with as little padding as possible.
+    std::stable_sort(slots.begin(),
+                     slots.end(),
+                     [](const Slot &lhs, const Slot &rhs) {
+                       auto lhs_alignment =
+                           get_layout_alignment(*lhs.llvm_type);
+                       auto rhs_alignment =
+                           get_layout_alignment(*rhs.llvm_type);
+                       if (lhs_alignment != rhs_alignment) {
+                         return lhs_alignment > rhs_alignment;
+                       }
+                       return get_layout_size(*lhs.llvm_type)
+                              > get_layout_size(*rhs.llvm_type);
+                     });
+
+    // Record the field offset of each field, padding the fields that follow
+    // an aggregate whose size is not a multiple of their alignment.
+    auto *llvm_byte_type = llvm::Type::getInt8Ty(this->C);
+    unsigned offset = 0;
+    unsigned struct_alignment = 1;
+    for (auto const &slot : slots) {
+      auto alignment = get_layout_alignment(*slot.llvm_type);
+      struct_alignment = std::max(struct_alignment, alignment);
+
+      if (auto padding = get_padding(offset, alignment)) {
+        llvm_field_types.push_back(
+            llvm::ArrayType::get(llvm_byte_type, padding));
+        offset += padding;
+      }
 
-      // Append the new field.
-      llvm_field_types.push_back(&llvm_field_type);
+      for (auto field_index : slot.field_indices) {
+        field_offsets[field_index] = llvm_field_types.size();
+      }
+      llvm_field_types.push_back(slot.llvm_type);
+      offset += get_layout_size(*slot.llvm_type);
     }
 
-    if (current_field_width != 0) {
-      // Get the integer type.
-      auto bit_field_size = get_next_size(current_field_width);
-      debugln(current_field_width, " ==> ", bit_field_size);
-      auto *bit_field_int_type =
-          llvm::IntegerType::get(this->C, bit_field_size);
-
-      // Append the bit field aggregate type.
-      llvm_field_types.push_back(bit_field_int_type);
+    // Pad the end of the struct, so that it stays aligned in arrays and when
+    // nested in other structs.
+    if (auto padding = get_padding(offset, struct_alignment)) {
+      llvm_field_types.push_back(llvm::ArrayType::get(llvm_byte_type, padding));
     }
 
     // Create the LLVM struct type.
@@ -377,8 +494,11 @@ protected:
         "Could not create the LLVM StructType!");
 
     // Create the type layout.
-    auto *type_layout =
-        new TypeLayout(T, llvm_type, field_offsets, bit_field_ranges);
+    auto *type_layout = new TypeLayout(T,
+                                       llvm_type,
+                                       field_offsets,
+                                       bit_field_ranges,
+                                       compressed_references);
 
     MEMOIZE_AND_RETURN(T, *type_layout);
   }
@@ -397,12 +517,20 @@ protected:
     // MEMOIZE_AND_RETURN(T, llvm_type);
   }
 
+  // Collects the struct types of @M that are stored inline, in another struct
+  // or in a collection.
+  static set<StructType *> find_inline_struct_types(llvm::Module &M);
+
   // Owned state.
   map<Type *, TypeLayout *> memoir_to_type_layout;
+  set<StructType *> inline_struct_types;
 
   // Borrowed state.
   llvm::LLVMContext &C;
 
+  // Configuration.
+  bool compress_references;
+
 }; // namespace llvm::memoir
 
 } // namespace llvm::memoir
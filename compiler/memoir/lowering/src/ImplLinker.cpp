@@ -16,6 +16,14 @@ void ImplLinker::implement_type(TypeLayout &type_layout) {
   return;
 }
 
+void ImplLinker::implement_arena(TypeLayout &struct_type_layout) {
+  this->implement_type(struct_type_layout);
+
+  this->arena_implementations.insert(&struct_type_layout);
+
+  return;
+}
+
 void ImplLinker::implement_seq(std::string impl_name,
                                TypeLayout &element_type_layout) {
 
@@ -75,6 +83,10 @@ static std::string memoir_to_c_type(Type &T) {
   MEMOIR_UNREACHABLE("Attempting to create Impl for unknown type!");
 }
 
+std::string ImplLinker::get_arena_prefix(StructType &struct_type) {
+  return memoir_to_c_type(struct_type) + "_arena";
+}
+
 void ImplLinker::emit(llvm::raw_ostream &os) {
   // General include headers.
   fprintln(os, "#include <stdint.h>");
@@ -101,6 +113,15 @@ void ImplLinker::emit(llvm::raw_ostream &os) {
              ";");
   }
 
+  // Instantiate the arenas for struct types with compressed references.
+  if (!this->arena_implementations.empty()) {
+    fprintln(os, "#include \"backend/arena.h\"");
+  }
+  for (auto *struct_layout : this->arena_implementations) {
+    auto c_type = memoir_to_c_type(struct_layout->get_memoir_type());
+    fprintln(os, "INSTANTIATE_arena(", c_type, ", ", c_type, ")");
+  }
+
   // Instantiate the sequence implementations.
   for (auto it = this->seq_implementations.begin();
        it != this->seq_implementations.end();) {
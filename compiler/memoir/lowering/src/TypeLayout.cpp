@@ -0,0 +1,54 @@
+#include "memoir/lowering/TypeLayout.hpp"
+
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/support/Casting.hpp"
+
+namespace llvm::memoir {
+
+llvm::cl::opt<bool> CompressReferences(
+    "memoir-compress-refs",
+    llvm::cl::desc("Lower struct references held in struct fields to 32-bit "
+                   "offsets into per-type arenas"),
+    llvm::cl::init(false));
+
+// Records the struct types stored inline in an object of type @T.
+static void collect_inline_struct_types(Type &T, set<StructType *> &found) {
+  if (auto *struct_type = dyn_cast<StructType>(&T)) {
+    for (unsigned i = 0; i < struct_type->getNumFields(); ++i) {
+      auto &field_type = struct_type->getFieldType(i);
+      if (auto *field_struct_type = dyn_cast<StructType>(&field_type)) {
+        found.insert(field_struct_type);
+      } else {
+        collect_inline_struct_types(field_type, found);
+      }
+    }
+  } else if (auto *collection_type = dyn_cast<CollectionType>(&T)) {
+    auto &element_type = collection_type->getElementType();
+    if (auto *element_struct_type = dyn_cast<StructType>(&element_type)) {
+      found.insert(element_struct_type);
+    } else {
+      collect_inline_struct_types(element_type, found);
+    }
+  }
+}
+
+set<StructType *> TypeConverter::find_inline_struct_types(llvm::Module &M) {
+  set<StructType *> found = {};
+
+  for (auto &F : M) {
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        if (auto *type_inst = into<TypeInst>(&I)) {
+          collect_inline_struct_types(type_inst->getType(), found);
+        } else if (auto *alloc_inst = into<CollectionAllocInst>(&I)) {
+          collect_inline_struct_types(alloc_inst->getCollectionType(), found);
+        }
+      }
+    }
+  }
+
+  return found;
+}
+
+} // namespace llvm::memoir
@@ -0,0 +1,384 @@
+#ifndef MEMOIR_ALLOCATIONHOISTING_H
+#define MEMOIR_ALLOCATIONHOISTING_H
+#pragma once
+
+#include <memory>
+
+// LLVM
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+
+// MemOIR
+#include "memoir/ir/Builder.hpp"
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/LivenessAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class hoists collections that are allocated and deleted on every
+ * iteration of a loop out of the loop, recycling them across iterations.
+ *
+ * An empty sequence or assoc allocated in a loop, that is deleted at the end
+ * of each iteration and is not live across iterations, is instead allocated
+ * in the preheader and carried around the loop by a PHI in the header. The
+ * delete is replaced with a clear, which keeps the capacity of the
+ * collection, and the collection is deleted at the exits of the loop:
+ *
+ *   for (...) {                   a0 = new
+ *     a = new                     for (...) {
+ *     ...                ==>        a = PHI(a0, a')
+ *     delete(a)                     ...
+ *   }                               a' = clear(a)
+ *                                 }
+ *                                 delete(a')
+ */
+
+namespace llvm::memoir {
+
+class AllocationHoisting {
+public:
+  /**
+   * Hoists the per-iteration collection allocations out of the loops of the
+   * program @M.
+   */
+  AllocationHoisting(llvm::Module &M) : M(M) {
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+  /**
+   * Gets the functions in which allocations were hoisted.
+   */
+  const set<llvm::Function *> &transformed_functions() const {
+    return this->_transformed_functions;
+  }
+
+protected:
+  // Top-level driver.
+  bool run() {
+    bool transformed = false;
+
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      llvm::DominatorTree DT(F);
+      llvm::LoopInfo LI(DT);
+      this->LA.reset();
+
+      // Visit inner loops first, so that a collection can be hoisted out of
+      // a loop nest one level at a time.
+      auto loops = LI.getLoopsInPreorder();
+      for (auto it = loops.rbegin(); it != loops.rend(); ++it) {
+        auto &L = **it;
+
+        // Gather the allocations made directly in this loop.
+        vector<llvm::Instruction *> allocs = {};
+        for (auto *BB : L.blocks()) {
+          if (LI.getLoopFor(BB) != &L) {
+            continue;
+          }
+          for (auto &I : *BB) {
+            if (into<SequenceAllocInst>(I) || into<AssocArrayAllocInst>(I)) {
+              allocs.push_back(&I);
+            }
+          }
+        }
+
+        // Hoisting invalidates the MEMOIR instructions, so we fetch them
+        // again for each allocation.
+        for (auto *I : allocs) {
+          auto &alloc = MEMOIR_SANITIZE(into<CollectionAllocInst>(I),
+                                        "Allocation is no longer an alloc!");
+          if (this->hoist(L, alloc, F, DT, LI)) {
+            this->_transformed_functions.insert(&F);
+            transformed = true;
+          }
+        }
+      }
+    }
+
+    return transformed;
+  }
+
+  // Analysis.
+  /**
+   * Checks that @V is available in the preheader of @L, or is a type that
+   * can be hoisted there.
+   */
+  static bool is_hoistable(llvm::Value &V, llvm::Loop &L) {
+    auto *inst = dyn_cast<llvm::Instruction>(&V);
+    if (inst == nullptr || !L.contains(inst)) {
+      return true;
+    }
+
+    if (!into<TypeInst>(inst)) {
+      return false;
+    }
+    for (auto &operand : inst->operands()) {
+      if (!is_hoistable(*operand.get(), L)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Checks that @alloc creates an empty collection from operands available
+   * in the preheader of @L.
+   */
+  static bool is_empty_allocation(CollectionAllocInst &alloc, llvm::Loop &L) {
+    if (auto *seq_alloc = dyn_cast<SequenceAllocInst>(&alloc)) {
+      auto *size = dyn_cast<llvm::ConstantInt>(&seq_alloc->getSizeOperand());
+      if (size == nullptr || !size->isZero()) {
+        return false;
+      }
+    }
+
+    auto &call = alloc.getCallInst();
+    for (auto &arg : call.arg_operands()) {
+      if (!is_hoistable(*arg.get(), L)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Collects the SSA versions of the collection allocated by @alloc within
+   * an iteration of @L, and the single deletion of them.
+   * Returns false if the collection may escape the iteration.
+   */
+  static bool collect_versions(llvm::Loop &L,
+                               CollectionAllocInst &alloc,
+                               set<llvm::Value *> &versions,
+                               DeleteCollectionInst *&delete_inst) {
+    vector<llvm::Value *> worklist = { &alloc.getCallInst() };
+    versions.insert(&alloc.getCallInst());
+
+    auto add_version = [&](llvm::Value &V) {
+      if (versions.insert(&V).second) {
+        worklist.push_back(&V);
+      }
+    };
+
+    while (!worklist.empty()) {
+      auto *collection = worklist.back();
+      worklist.pop_back();
+
+      for (auto &use : collection->uses()) {
+        auto *user = dyn_cast<llvm::Instruction>(use.getUser());
+        if (user == nullptr || !L.contains(user)) {
+          return false;
+        }
+
+        // A PHI in the header would carry the collection to the next
+        // iteration.
+        if (auto *phi = dyn_cast<llvm::PHINode>(user)) {
+          if (phi->getParent() == L.getHeader()) {
+            return false;
+          }
+          add_version(*phi);
+          continue;
+        }
+
+        auto *memoir_inst = into<MemOIRInst>(user);
+        if (memoir_inst == nullptr) {
+          return false;
+        }
+
+        if (auto *delete_collection =
+                dyn_cast<DeleteCollectionInst>(memoir_inst)) {
+          if (delete_inst != nullptr && delete_inst != delete_collection) {
+            return false;
+          }
+          delete_inst = delete_collection;
+        } else if (auto *insert_inst = dyn_cast<InsertInst>(memoir_inst)) {
+          if (&use == &insert_inst->getBaseCollectionAsUse()) {
+            add_version(*user);
+          } else if (!isa<SeqInsertSeqInst>(insert_inst)) {
+            return false;
+          }
+        } else if (auto *remove_inst = dyn_cast<RemoveInst>(memoir_inst)) {
+          if (&use != &remove_inst->getBaseCollectionAsUse()) {
+            return false;
+          }
+          add_version(*user);
+        } else if (auto *write_inst = dyn_cast<WriteInst>(memoir_inst)) {
+          if (&use != &write_inst->getObjectOperandAsUse()) {
+            return false;
+          }
+          add_version(*user);
+        } else if (auto *access_inst = dyn_cast<AccessInst>(memoir_inst)) {
+          if (&use != &access_inst->getObjectOperandAsUse()) {
+            return false;
+          }
+        } else if (auto *fill_inst = dyn_cast<SeqFillInst>(memoir_inst)) {
+          if (&use != &fill_inst->getBaseCollectionAsUse()) {
+            return false;
+          }
+          add_version(*user);
+        } else if (isa<ClearInst>(memoir_inst) || isa<UsePHIInst>(memoir_inst)
+                   || isa<DefPHIInst>(memoir_inst)) {
+          add_version(*user);
+        } else if (!isa<SizeInst>(memoir_inst) && !isa<CopyInst>(memoir_inst)
+                   && !isa<AssocKeysInst>(memoir_inst)
+                   && !isa<SeqReserveInst>(memoir_inst)) {
+          return false;
+        }
+      }
+    }
+
+    // Merges in the loop body may only join versions of the collection.
+    for (auto *version : versions) {
+      if (auto *phi = dyn_cast<llvm::PHINode>(version)) {
+        for (auto &incoming : phi->incoming_values()) {
+          if (versions.count(incoming.get()) == 0) {
+            return false;
+          }
+        }
+      }
+    }
+
+    return delete_inst != nullptr;
+  }
+
+  // Transformation.
+  bool hoist(llvm::Loop &L,
+             CollectionAllocInst &alloc,
+             llvm::Function &F,
+             llvm::DominatorTree &DT,
+             llvm::LoopInfo &LI) {
+    auto *header = L.getHeader();
+    auto *preheader = L.getLoopPreheader();
+    auto *latch = L.getLoopLatch();
+    if (preheader == nullptr || latch == nullptr
+        || !is_empty_allocation(alloc, L)) {
+      return false;
+    }
+
+    set<llvm::Value *> versions = {};
+    DeleteCollectionInst *delete_inst = nullptr;
+    if (!collect_versions(L, alloc, versions, delete_inst)) {
+      return false;
+    }
+
+    // The collection must be deleted exactly once on every iteration.
+    auto &delete_call = delete_inst->getCallInst();
+    if (LI.getLoopFor(delete_call.getParent()) != &L
+        || !DT.dominates(delete_call.getParent(), latch)) {
+      return false;
+    }
+
+    // The loop may only be exited from the header, before any version of
+    // the collection is defined, or from the latch, after it is deleted.
+    llvm::SmallVector<llvm::BasicBlock *, 4> exits;
+    L.getExitBlocks(exits);
+    for (auto *exit : exits) {
+      auto *pred = exit->getSinglePredecessor();
+      if (pred == latch) {
+        continue;
+      } else if (pred != header) {
+        return false;
+      }
+      for (auto *version : versions) {
+        if (cast<llvm::Instruction>(version)->getParent() == header) {
+          return false;
+        }
+      }
+    }
+
+    // No version of the collection may outlive the iteration.
+    if (!this->LA) {
+      this->LA = std::make_unique<LivenessAnalysis>(F);
+    }
+    auto &entry = *header->getFirstNonPHI();
+    for (auto *version : versions) {
+      if (this->LA->is_live(*version, entry, /* after = */ false)
+          || this->LA->is_live(*version, delete_call, /* after = */ true)) {
+        return false;
+      }
+    }
+
+    infoln("Hoisting ", alloc.getCallInst());
+    infoln("  out of loop at ", header->getName());
+
+    // Move the allocation, and any types it depends on, to the preheader.
+    auto &alloc_call = alloc.getCallInst();
+    this->move_to(alloc_call, L, *preheader->getTerminator());
+
+    // Carry the collection around the loop.
+    MemOIRBuilder header_builder(header->getFirstNonPHI());
+    auto *phi = header_builder.CreatePHI(alloc_call.getType(), 2, "recycled.");
+    alloc_call.replaceAllUsesWith(phi);
+    phi->addIncoming(&alloc_call, preheader);
+
+    // Replace the delete with a clear, keeping the capacity for the next
+    // iteration.
+    MemOIRBuilder clear_builder(*delete_inst);
+    auto *clear_inst = clear_builder.CreateClearInst(
+        &delete_inst->getDeletedCollection(),
+        "recycled.");
+    auto &cleared = clear_inst->getCallInst();
+    phi->addIncoming(&cleared, latch);
+    delete_call.eraseFromParent();
+
+    // Delete the collection once we leave the loop.
+    for (auto *exit : exits) {
+      auto *pred = exit->getSinglePredecessor();
+      auto *collection = (pred == latch) ? &cleared : phi;
+
+      MemOIRBuilder exit_builder(&*exit->getFirstInsertionPt());
+      exit_builder.CreateDeleteCollectionInst(collection);
+    }
+
+    MemOIRInst::invalidate();
+    this->LA.reset();
+
+    return true;
+  }
+
+  /**
+   * Moves @I before @point, along with the operands of @I defined in @L.
+   */
+  static void move_to(llvm::Instruction &I,
+                      llvm::Loop &L,
+                      llvm::Instruction &point) {
+    for (auto &operand : I.operands()) {
+      auto *operand_inst = dyn_cast<llvm::Instruction>(operand.get());
+      if (operand_inst != nullptr && L.contains(operand_inst)) {
+        move_to(*operand_inst, L, point);
+      }
+    }
+    I.moveBefore(&point);
+  }
+
+  // Owned state.
+  bool _transformed;
+  set<llvm::Function *> _transformed_functions;
+  std::unique_ptr<LivenessAnalysis> LA;
+
+  // Borrowed state.
+  llvm::Module &M;
+};
+
+} // namespace llvm::memoir
+
+#endif
@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "AllocationHoisting.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass hoists per-iteration collection allocations out of loops.
+ */
+
+struct AllocationHoistingPass : public ModulePass {
+  static char ID;
+
+  AllocationHoistingPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN allocation hoisting pass");
+    infoln();
+
+    AllocationHoisting AH(M);
+
+    // Hoisting rewrites the values of a function, but no types.
+    for (auto *F : AH.transformed_functions()) {
+      TypeAnalysis::invalidate(*F);
+    }
+
+    infoln();
+    infoln("END allocation hoisting pass");
+    infoln("========================");
+
+    return AH.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char AllocationHoistingPass::ID = 0;
+static llvm::RegisterPass<AllocationHoistingPass> X(
+    "memoir-ah",
+    "Hoists per-iteration collection allocations out of loops.");
+
+} // namespace llvm::memoir
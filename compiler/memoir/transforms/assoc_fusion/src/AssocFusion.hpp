@@ -0,0 +1,397 @@
+#ifndef MEMOIR_ASSOCFUSION_H
+#define MEMOIR_ASSOCFUSION_H
+#pragma once
+
+#include <string>
+
+// LLVM
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+// MemOIR
+#include "memoir/ir/Builder.hpp"
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class fuses pairs of assocs that always hold the same set of keys into
+ * a single assoc of structs, the inverse of field elision.
+ *
+ * Two assocs a: assoc<K, A> and b: assoc<K, B> are fused when they are
+ * allocated in the same basic block, do not escape their function, and every
+ * insert, remove, clear or delete of one is immediately followed, in the same
+ * basic block, by the same operation with the same key on the other. Their
+ * key sets are then equal at every other program point, so they are replaced
+ * with one assoc<K, struct { A, B }>, whose struct type is defined in the
+ * entry of the function:
+ *
+ *   a = new assoc<K, A>            ab = new assoc<K, struct { A, B }>
+ *   b = new assoc<K, B>
+ *   insert(a, k)           ==>     insert(ab, k)
+ *   insert(b, k)
+ *   x = a[k]                       x = ab[k].0
+ *   b[k] = y                       ab[k].1 = y
+ *
+ * The fused assoc is updated in place, so SSA construction must be run again
+ * after this transformation.
+ */
+
+namespace llvm::memoir {
+
+class AssocFusion {
+public:
+  /**
+   * Fuses the assocs with equal key sets in the program @M.
+   */
+  AssocFusion(llvm::Module &M) : M(M) {
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+protected:
+  // Describes the uses of one of the assocs being fused.
+  struct Candidate {
+    AssocArrayAllocInst *alloc;
+    set<llvm::Value *> versions;
+    map<llvm::Instruction *, MemOIRInst *> operations;
+  };
+
+  // Top-level driver.
+  bool run() {
+    bool transformed = false;
+
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      // Gather the assoc allocations in each basic block.
+      vector<vector<llvm::Instruction *>> allocs_per_block = {};
+      for (auto &BB : F) {
+        vector<llvm::Instruction *> allocs = {};
+        for (auto &I : BB) {
+          if (into<AssocArrayAllocInst>(I)) {
+            allocs.push_back(&I);
+          }
+        }
+        if (allocs.size() > 1) {
+          allocs_per_block.push_back(std::move(allocs));
+        }
+      }
+
+      // Try to fuse each pair of them, greedily.
+      for (auto &allocs : allocs_per_block) {
+        set<llvm::Instruction *> fused = {};
+        for (unsigned i = 0; i < allocs.size(); ++i) {
+          for (unsigned j = i + 1; j < allocs.size(); ++j) {
+            if (fused.count(allocs[i]) > 0 || fused.count(allocs[j]) > 0) {
+              continue;
+            }
+
+            auto &first = MEMOIR_SANITIZE(into<AssocArrayAllocInst>(allocs[i]),
+                                          "Allocation is no longer an assoc!");
+            auto &second =
+                MEMOIR_SANITIZE(into<AssocArrayAllocInst>(allocs[j]),
+                                "Allocation is no longer an assoc!");
+            if (this->fuse(F, first, second)) {
+              fused.insert(allocs[i]);
+              fused.insert(allocs[j]);
+              transformed = true;
+            }
+          }
+        }
+      }
+    }
+
+    return transformed;
+  }
+
+  // Analysis.
+  static bool is_fusable_type(Type &type) {
+    return Type::is_primitive_type(type) || Type::is_reference_type(type);
+  }
+
+  static bool changes_keys(MemOIRInst &I) {
+    return isa<AssocInsertInst>(&I) || isa<AssocRemoveInst>(&I)
+           || isa<ClearInst>(&I) || isa<DeleteCollectionInst>(&I);
+  }
+
+  static llvm::Value *get_key(MemOIRInst &I) {
+    if (auto *insert_inst = dyn_cast<AssocInsertInst>(&I)) {
+      return &insert_inst->getInsertionPoint();
+    } else if (auto *remove_inst = dyn_cast<AssocRemoveInst>(&I)) {
+      return &remove_inst->getKey();
+    }
+    return nullptr;
+  }
+
+  /**
+   * Collects the SSA versions of the assoc allocated by @candidate and the
+   * operations on them.
+   * Returns false if the assoc may escape the function.
+   */
+  static bool collect(Candidate &candidate) {
+    auto &alloc_call = candidate.alloc->getCallInst();
+    vector<llvm::Value *> worklist = { &alloc_call };
+    candidate.versions.insert(&alloc_call);
+
+    auto add_version = [&](llvm::Value &V) {
+      if (candidate.versions.insert(&V).second) {
+        worklist.push_back(&V);
+      }
+    };
+
+    while (!worklist.empty()) {
+      auto *collection = worklist.back();
+      worklist.pop_back();
+
+      for (auto &use : collection->uses()) {
+        auto *user = dyn_cast<llvm::Instruction>(use.getUser());
+        if (user == nullptr) {
+          return false;
+        }
+
+        if (auto *phi = dyn_cast<llvm::PHINode>(user)) {
+          add_version(*phi);
+          continue;
+        }
+
+        auto *memoir_inst = into<MemOIRInst>(user);
+        if (memoir_inst == nullptr) {
+          return false;
+        }
+        candidate.operations[user] = memoir_inst;
+
+        if (auto *insert_inst = dyn_cast<AssocInsertInst>(memoir_inst)) {
+          if (&use != &insert_inst->getBaseCollectionAsUse()) {
+            return false;
+          }
+          add_version(*user);
+        } else if (auto *remove_inst = dyn_cast<AssocRemoveInst>(memoir_inst)) {
+          if (&use != &remove_inst->getBaseCollectionAsUse()) {
+            return false;
+          }
+          add_version(*user);
+        } else if (auto *write_inst = dyn_cast<AssocWriteInst>(memoir_inst)) {
+          if (&use != &write_inst->getObjectOperandAsUse()) {
+            return false;
+          }
+          add_version(*user);
+        } else if (auto *read_inst = dyn_cast<AssocReadInst>(memoir_inst)) {
+          if (&use != &read_inst->getObjectOperandAsUse()) {
+            return false;
+          }
+        } else if (auto *has_inst = dyn_cast<AssocHasInst>(memoir_inst)) {
+          if (&use != &has_inst->getObjectOperandAsUse()) {
+            return false;
+          }
+        } else if (isa<ClearInst>(memoir_inst) || isa<UsePHIInst>(memoir_inst)
+                   || isa<DefPHIInst>(memoir_inst)) {
+          add_version(*user);
+        } else if (!isa<SizeInst>(memoir_inst)
+                   && !isa<AssocKeysInst>(memoir_inst)
+                   && !isa<DeleteCollectionInst>(memoir_inst)) {
+          return false;
+        }
+      }
+    }
+
+    // PHIs may only merge versions of the same assoc.
+    for (auto *version : candidate.versions) {
+      if (auto *phi = dyn_cast<llvm::PHINode>(version)) {
+        for (auto &incoming : phi->incoming_values()) {
+          if (candidate.versions.count(incoming.get()) == 0) {
+            return false;
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Pairs up the operations that change the keys of the two @candidates.
+   * Each such operation must be immediately followed, among the operations on
+   * either assoc, by the same operation with the same key on the other.
+   * Returns false if they could not be paired.
+   */
+  static bool pair_key_changes(
+      llvm::Function &F,
+      Candidate (&candidates)[2],
+      vector<std::pair<MemOIRInst *, MemOIRInst *>> &pairs) {
+    for (auto &BB : F) {
+      // Collect the operations on either assoc, in program order.
+      vector<std::pair<MemOIRInst *, unsigned>> operations = {};
+      for (auto &I : BB) {
+        for (unsigned side = 0; side < 2; ++side) {
+          auto found = candidates[side].operations.find(&I);
+          if (found != candidates[side].operations.end()) {
+            operations.emplace_back(found->second, side);
+          }
+        }
+      }
+
+      for (unsigned idx = 0; idx < operations.size(); ++idx) {
+        auto [first, first_side] = operations[idx];
+        if (!changes_keys(*first)) {
+          continue;
+        }
+
+        if (idx + 1 == operations.size()) {
+          return false;
+        }
+        auto [second, second_side] = operations[++idx];
+        if (first_side == second_side || first->getKind() != second->getKind()
+            || get_key(*first) != get_key(*second)) {
+          return false;
+        }
+
+        pairs.emplace_back(first, second);
+      }
+    }
+
+    return true;
+  }
+
+  // Transformation.
+  bool fuse(llvm::Function &F,
+            AssocArrayAllocInst &first,
+            AssocArrayAllocInst &second) {
+    auto &key_type = first.getKeyType();
+    if (&key_type != &second.getKeyType()
+        || !is_fusable_type(first.getValueType())
+        || !is_fusable_type(second.getValueType())) {
+      return false;
+    }
+
+    Candidate candidates[2] = { { &first, {}, {} }, { &second, {}, {} } };
+    if (!collect(candidates[0]) || !collect(candidates[1])) {
+      return false;
+    }
+
+    vector<std::pair<MemOIRInst *, MemOIRInst *>> pairs = {};
+    if (!pair_key_changes(F, candidates, pairs)) {
+      return false;
+    }
+
+    infoln("Fusing ", first.getCallInst());
+    infoln("  with ", second.getCallInst());
+
+    // Define the struct type of the fused assoc.
+    auto name = "assoc.fused." + F.getName().str() + "."
+                + std::to_string(this->num_fused++);
+    vector<Type *> field_types = { &first.getValueType(),
+                                   &second.getValueType() };
+
+    MemOIRBuilder entry_builder(F.getEntryBlock().getFirstNonPHI());
+    auto *definition =
+        entry_builder.CreateDefineStructTypeInst(name.c_str(), field_types);
+    auto &struct_type =
+        Type::define_struct_type(*definition, name, field_types);
+
+    // Allocate the fused assoc in place of the first allocation.
+    MemOIRBuilder alloc_builder(first);
+    auto *fused_alloc = alloc_builder.CreateAssocArrayAllocInst(key_type,
+                                                                struct_type,
+                                                                "fused.");
+    auto *fused = &fused_alloc->getCallInst();
+
+    set<llvm::Instruction *> to_erase = {};
+
+    // Perform each pair of key changes once on the fused assoc.
+    for (auto const &[op, other_op] : pairs) {
+      MemOIRBuilder builder(*op);
+      if (isa<AssocInsertInst>(op)) {
+        builder.CreateMutAssocInsertInst(fused, get_key(*op));
+      } else if (isa<AssocRemoveInst>(op)) {
+        builder.CreateMutAssocRemoveInst(fused, get_key(*op));
+      } else if (isa<ClearInst>(op)) {
+        builder.CreateMutClearInst(fused);
+      } else if (isa<DeleteCollectionInst>(op)) {
+        builder.CreateDeleteCollectionInst(fused);
+      }
+      to_erase.insert(&op->getCallInst());
+      to_erase.insert(&other_op->getCallInst());
+    }
+
+    // Redirect the accesses to the field of the fused assoc's element.
+    for (unsigned side = 0; side < 2; ++side) {
+      auto &field_type = *field_types[side];
+
+      for (auto const &[inst, memoir_inst] : candidates[side].operations) {
+        MemOIRBuilder builder(inst);
+        auto *field_index = builder.getInt32(side);
+
+        if (auto *read_inst = dyn_cast<AssocReadInst>(memoir_inst)) {
+          auto *element =
+              builder.CreateAssocGetInst(struct_type,
+                                         fused,
+                                         &read_inst->getKeyOperand());
+          auto *field = builder.CreateStructReadInst(field_type,
+                                                     &element->getCallInst(),
+                                                     field_index);
+          inst->replaceAllUsesWith(&field->getCallInst());
+          to_erase.insert(inst);
+        } else if (auto *write_inst = dyn_cast<AssocWriteInst>(memoir_inst)) {
+          auto *element =
+              builder.CreateAssocGetInst(struct_type,
+                                         fused,
+                                         &write_inst->getKeyOperand());
+          builder.CreateStructWriteInst(field_type,
+                                        &write_inst->getValueWritten(),
+                                        &element->getCallInst(),
+                                        field_index);
+        } else if (auto *has_inst = dyn_cast<AssocHasInst>(memoir_inst)) {
+          has_inst->getObjectOperandAsUse().set(fused);
+        } else if (auto *size_inst = dyn_cast<SizeInst>(memoir_inst)) {
+          size_inst->getCollectionAsUse().set(fused);
+        } else if (auto *keys_inst = dyn_cast<AssocKeysInst>(memoir_inst)) {
+          keys_inst->getCollectionAsUse().set(fused);
+        }
+      }
+
+      for (auto *version : candidates[side].versions) {
+        to_erase.insert(cast<llvm::Instruction>(version));
+      }
+    }
+
+    // Cleanup the original assocs.
+    for (auto *inst : to_erase) {
+      if (!inst->getType()->isVoidTy()) {
+        inst->replaceAllUsesWith(llvm::UndefValue::get(inst->getType()));
+      }
+    }
+    for (auto *inst : to_erase) {
+      inst->eraseFromParent();
+    }
+
+    MemOIRInst::invalidate();
+
+    return true;
+  }
+
+  // Owned state.
+  bool _transformed;
+  unsigned num_fused = 0;
+
+  // Borrowed state.
+  llvm::Module &M;
+};
+
+} // namespace llvm::memoir
+
+#endif
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "AssocFusion.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass fuses assocs with equal key sets into an assoc of structs.
+ */
+
+struct AssocFusionPass : public ModulePass {
+  static char ID;
+
+  AssocFusionPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN assoc fusion pass");
+    infoln();
+
+    AssocFusion AF(M);
+
+    // Fusion changes the collection type of fused values, drop all cached
+    // types.
+    if (AF.transformed()) {
+      TypeAnalysis::invalidate();
+    }
+
+    infoln();
+    infoln("END assoc fusion pass");
+    infoln("========================");
+
+    return AF.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char AssocFusionPass::ID = 0;
+static llvm::RegisterPass<AssocFusionPass> X(
+    "memoir-af",
+    "Fuses assocs with equal key sets into an assoc of structs.");
+
+} // namespace llvm::memoir
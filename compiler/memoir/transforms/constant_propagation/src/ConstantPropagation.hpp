@@ -0,0 +1,828 @@
+#ifndef MEMOIR_CONSTANTPROPAGATION_H
+#define MEMOIR_CONSTANTPROPAGATION_H
+#pragma once
+
+#include <algorithm>
+
+// LLVM
+#include "llvm/Analysis/ConstantFolding.h"
+#include "llvm/IR/CFG.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Transforms/Utils/Local.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/analysis/ValueExpression.hpp"
+#include "memoir/analysis/ValueNumbering.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class propagates constants through the elements of MEMOIR collections.
+ *
+ * Each SSA version of a collection is given the set of elements known to hold
+ * a constant, keyed by the ValueExpression of their index or key. States are
+ * solved sparsely over the def-use chains of collections, starting from an
+ * optimistic TOP state so that constants survive being carried around loops.
+ *
+ * As in SCCP, only the blocks reachable along executable edges are visited.
+ * Scalar instructions are evaluated alongside the reads of elements, and a
+ * branch on a constant condition only makes the edge it takes executable, so
+ * PHIs ignore the values flowing in along edges that are never taken.
+ *
+ * Reads of an element known to be constant, and the scalars computed from
+ * them, are folded, branches on folded conditions are pruned, and the writes
+ * whose resulting collection is no longer observed are then removed.
+ */
+
+namespace llvm::memoir {
+
+class ConstantPropagation {
+public:
+  /**
+   * Performs constant propagation through collections on the input program
+   * @M, using @VN to determine the equality of indices and keys.
+   */
+  ConstantPropagation(llvm::Module &M, ValueNumbering &VN) : M(M), VN(VN) {
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+  /**
+   * Gets the functions that were modified by the transformation.
+   */
+  const set<llvm::Function *> &transformed_functions() const {
+    return this->_transformed_functions;
+  }
+
+protected:
+  /**
+   * The lattice of a scalar element value.
+   */
+  struct Scalar {
+    enum Kind { TOP, CONSTANT, BOTTOM } kind;
+    llvm::Constant *constant;
+
+    static Scalar top() {
+      return { TOP, nullptr };
+    }
+
+    static Scalar bottom() {
+      return { BOTTOM, nullptr };
+    }
+
+    static Scalar of(llvm::Constant &C) {
+      return { CONSTANT, &C };
+    }
+
+    bool operator==(const Scalar &other) const {
+      return (this->kind == other.kind) && (this->constant == other.constant);
+    }
+
+    bool operator!=(const Scalar &other) const {
+      return !(*this == other);
+    }
+
+    Scalar meet(const Scalar &other) const {
+      if (this->kind == TOP) {
+        return other;
+      } else if (other.kind == TOP) {
+        return *this;
+      } else if (*this == other) {
+        return *this;
+      }
+      return bottom();
+    }
+  };
+
+  /**
+   * The lattice of a collection version. A TOP collection has not been
+   * reached yet, otherwise only the listed elements are known.
+   */
+  struct Collection {
+    bool top = true;
+    vector<std::pair<ValueExpression *, Scalar>> elements = {};
+
+    static Collection bottom() {
+      Collection state;
+      state.top = false;
+      return state;
+    }
+
+    bool operator==(const Collection &other) const {
+      return (this->top == other.top) && (this->elements == other.elements);
+    }
+
+    bool operator!=(const Collection &other) const {
+      return !(*this == other);
+    }
+
+    opt<Scalar> lookup(ValueExpression &key) const {
+      for (auto const &[element_key, value] : this->elements) {
+        if (element_key == &key || element_key->equals(key)) {
+          return value;
+        }
+      }
+      return {};
+    }
+  };
+
+  // Top-level driver.
+  bool run() {
+    bool transformed = false;
+
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      this->solve(F);
+
+      bool function_transformed = false;
+      function_transformed |= this->fold_constants(F);
+      function_transformed |= this->prune_branches(F);
+      function_transformed |= this->remove_dead_writes(F);
+
+      if (function_transformed) {
+        this->_transformed_functions.insert(&F);
+        transformed = true;
+      }
+    }
+
+    if (transformed) {
+      MemOIRInst::invalidate();
+    }
+
+    return transformed;
+  }
+
+  // Analysis.
+  static bool is_scalar(llvm::Instruction &I) {
+    if (isa<llvm::PHINode>(&I)) {
+      auto *type = I.getType();
+      return type->isIntegerTy() || type->isFloatingPointTy();
+    }
+    return isa<llvm::CmpInst>(&I) || isa<llvm::BinaryOperator>(&I)
+           || isa<llvm::CastInst>(&I) || isa<llvm::SelectInst>(&I);
+  }
+
+  static bool is_tracked(llvm::Instruction &I) {
+    if (Type::value_is_collection_type(I)) {
+      return true;
+    }
+    return into<IndexReadInst>(I) || into<AssocReadInst>(I) || is_scalar(I);
+  }
+
+  bool is_executable(llvm::BasicBlock &from, llvm::BasicBlock &to) const {
+    return this->executable_edges.count(std::make_pair(&from, &to)) > 0;
+  }
+
+  void mark_executable(llvm::BasicBlock &from, llvm::BasicBlock &to) {
+    if (!this->executable_edges.insert(std::make_pair(&from, &to)).second) {
+      return;
+    }
+
+    // Visit the block the first time it is reached, otherwise revisit its
+    // PHIs to meet the values flowing along the new edge.
+    if (this->executable_blocks.insert(&to).second) {
+      this->block_worklist.push_back(&to);
+    } else {
+      for (auto &phi : to.phis()) {
+        this->push(phi);
+      }
+    }
+  }
+
+  void push(llvm::Instruction &I) {
+    if (is_tracked(I) && this->in_worklist.insert(&I).second) {
+      this->worklist.push_back(&I);
+    }
+  }
+
+  /**
+   * Marks the successor edges of @BB that may be taken as executable. A
+   * branch on an undetermined condition takes no edge yet.
+   */
+  void visit_terminator(llvm::BasicBlock &BB) {
+    auto *terminator = BB.getTerminator();
+    if (terminator == nullptr) {
+      return;
+    }
+
+    llvm::BasicBlock *taken = nullptr;
+    if (auto *branch = dyn_cast<llvm::BranchInst>(terminator)) {
+      if (branch->isConditional()) {
+        auto condition = this->value_of(*branch->getCondition());
+        if (condition.kind == Scalar::TOP) {
+          return;
+        }
+        auto *constant = dyn_cast_or_null<llvm::ConstantInt>(
+            condition.constant);
+        if (constant != nullptr) {
+          taken = branch->getSuccessor(constant->isOne() ? 0 : 1);
+        }
+      }
+    } else if (auto *switch_inst = dyn_cast<llvm::SwitchInst>(terminator)) {
+      auto condition = this->value_of(*switch_inst->getCondition());
+      if (condition.kind == Scalar::TOP) {
+        return;
+      }
+      auto *constant =
+          dyn_cast_or_null<llvm::ConstantInt>(condition.constant);
+      if (constant != nullptr) {
+        taken = switch_inst->findCaseValue(constant)->getCaseSuccessor();
+      }
+    }
+
+    if (taken != nullptr) {
+      this->mark_executable(BB, *taken);
+      return;
+    }
+
+    for (auto *successor : llvm::successors(&BB)) {
+      this->mark_executable(BB, *successor);
+    }
+  }
+
+  void solve(llvm::Function &F) {
+    llvm::DominatorTree DT(F);
+
+    this->collections.clear();
+    this->scalars.clear();
+    this->executable_blocks.clear();
+    this->executable_edges.clear();
+
+    auto &entry = F.getEntryBlock();
+    this->executable_blocks.insert(&entry);
+    this->block_worklist.push_back(&entry);
+
+    while (!this->block_worklist.empty() || !this->worklist.empty()) {
+      // Visit the blocks that were newly reached.
+      while (!this->block_worklist.empty()) {
+        auto *BB = this->block_worklist.back();
+        this->block_worklist.pop_back();
+
+        for (auto &I : *BB) {
+          this->push(I);
+        }
+        this->visit_terminator(*BB);
+      }
+
+      while (!this->worklist.empty()) {
+        auto *I = this->worklist.back();
+        this->worklist.pop_back();
+        this->in_worklist.erase(I);
+
+        bool changed = false;
+        if (Type::value_is_collection_type(*I)) {
+          auto state = this->transfer(*I, DT);
+          auto &old_state = this->collections[I];
+          if (state != old_state) {
+            old_state = std::move(state);
+            changed = true;
+          }
+        } else {
+          auto value = this->evaluate(*I);
+          auto found = this->scalars.find(I);
+          if (found == this->scalars.end() || found->second != value) {
+            this->scalars[I] = value;
+            changed = true;
+          }
+        }
+
+        if (!changed) {
+          continue;
+        }
+
+        for (auto *user : I->users()) {
+          auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+          if (user_as_inst == nullptr
+              || this->executable_blocks.count(user_as_inst->getParent())
+                     == 0) {
+            continue;
+          }
+
+          if (user_as_inst->isTerminator()) {
+            this->visit_terminator(*user_as_inst->getParent());
+          } else {
+            this->push(*user_as_inst);
+          }
+        }
+      }
+
+      // A branch whose condition was never determined may go either way.
+      if (this->block_worklist.empty()) {
+        vector<llvm::BasicBlock *> blocks(this->executable_blocks.begin(),
+                                          this->executable_blocks.end());
+        for (auto *BB : blocks) {
+          auto *terminator = BB->getTerminator();
+          if (terminator == nullptr || terminator->getNumSuccessors() == 0) {
+            continue;
+          }
+          bool has_edge = false;
+          for (auto *successor : llvm::successors(BB)) {
+            has_edge |= this->is_executable(*BB, *successor);
+          }
+          if (!has_edge) {
+            for (auto *successor : llvm::successors(BB)) {
+              this->mark_executable(*BB, *successor);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  const Collection &state_of(llvm::Value &V) {
+    static const Collection bottom = Collection::bottom();
+
+    auto *inst = dyn_cast<llvm::Instruction>(&V);
+    if (inst == nullptr) {
+      return bottom;
+    }
+
+    // Unvisited collections are optimistically TOP.
+    return this->collections[inst];
+  }
+
+  Scalar value_of(llvm::Value &V) {
+    if (auto *constant = dyn_cast<llvm::Constant>(&V)) {
+      return Scalar::of(*constant);
+    }
+
+    auto found = this->scalars.find(&V);
+    if (found != this->scalars.end()) {
+      return found->second;
+    }
+
+    if (auto *inst = dyn_cast<llvm::Instruction>(&V)) {
+      if (is_tracked(*inst)) {
+        return Scalar::top();
+      }
+    }
+
+    return Scalar::bottom();
+  }
+
+  static Collection update(const Collection &base,
+                           ValueExpression *key,
+                           opt<Scalar> value) {
+    if (base.top) {
+      return base;
+    }
+
+    Collection state = Collection::bottom();
+
+    // If we don't know the key, we know nothing about the collection.
+    if (key == nullptr) {
+      return state;
+    }
+
+    // Kill the elements that the key may refer to.
+    for (auto const &element : base.elements) {
+      if (is_distinct(*element.first, *key)) {
+        state.elements.push_back(element);
+      }
+    }
+
+    // Record the new value of the element.
+    if (value.has_value() && value->kind != Scalar::BOTTOM) {
+      state.elements.emplace_back(key, *value);
+    }
+
+    return state;
+  }
+
+  /**
+   * A key can be carried into a PHI if it has the same value along every
+   * path to it, i.e. it is a constant, an argument or it is defined in a
+   * block that strictly dominates the PHI.
+   */
+  static bool is_invariant(ValueExpression &key,
+                           llvm::PHINode &phi,
+                           llvm::DominatorTree &DT) {
+    auto *key_value = key.getValue();
+    if (key_value == nullptr) {
+      return false;
+    } else if (isa<llvm::Constant>(key_value)
+               || isa<llvm::Argument>(key_value)) {
+      return true;
+    } else if (auto *key_inst = dyn_cast<llvm::Instruction>(key_value)) {
+      return DT.properlyDominates(key_inst->getParent(), phi.getParent());
+    }
+    return false;
+  }
+
+  Collection meet(llvm::PHINode &phi, llvm::DominatorTree &DT) {
+    Collection state;
+    for (auto &incoming : phi.incoming_values()) {
+      // Values flowing along edges that are never taken are ignored.
+      auto *incoming_block = phi.getIncomingBlock(incoming);
+      if (!this->is_executable(*incoming_block, *phi.getParent())) {
+        continue;
+      }
+
+      auto &incoming_state = this->state_of(*incoming.get());
+      if (incoming_state.top) {
+        continue;
+      }
+
+      if (state.top) {
+        state = Collection::bottom();
+        for (auto const &element : incoming_state.elements) {
+          if (is_invariant(*element.first, phi, DT)) {
+            state.elements.push_back(element);
+          }
+        }
+        continue;
+      }
+
+      vector<std::pair<ValueExpression *, Scalar>> elements = {};
+      for (auto const &[key, value] : state.elements) {
+        auto incoming_value = incoming_state.lookup(*key);
+        if (!incoming_value) {
+          continue;
+        }
+        auto new_value = value.meet(*incoming_value);
+        if (new_value.kind != Scalar::BOTTOM) {
+          elements.emplace_back(key, new_value);
+        }
+      }
+      state.elements = std::move(elements);
+    }
+
+    return state;
+  }
+
+  Collection transfer(llvm::Instruction &I, llvm::DominatorTree &DT) {
+    if (auto *write_inst = into<IndexWriteInst>(I)) {
+      auto &base = this->state_of(write_inst->getObjectOperand());
+      if (write_inst->getNumberOfDimensions() != 1) {
+        return update(base, nullptr, {});
+      }
+      return update(base,
+                    this->VN.get(write_inst->getIndexOfDimension(0)),
+                    this->value_of(write_inst->getValueWritten()));
+    } else if (auto *write_inst = into<AssocWriteInst>(I)) {
+      return update(this->state_of(write_inst->getObjectOperand()),
+                    this->VN.get(write_inst->getKeyOperand()),
+                    this->value_of(write_inst->getValueWritten()));
+    } else if (auto *insert_inst = into<AssocInsertInst>(I)) {
+      return update(this->state_of(insert_inst->getBaseCollection()),
+                    this->VN.get(insert_inst->getInsertionPoint()),
+                    {});
+    } else if (auto *remove_inst = into<AssocRemoveInst>(I)) {
+      return update(this->state_of(remove_inst->getBaseCollection()),
+                    this->VN.get(remove_inst->getKey()),
+                    {});
+    } else if (auto *use_phi = into<UsePHIInst>(I)) {
+      return this->state_of(use_phi->getUsedCollection());
+    } else if (auto *phi = dyn_cast<llvm::PHINode>(&I)) {
+      return this->meet(*phi, DT);
+    }
+
+    // Otherwise, we know nothing about the elements of the collection.
+    return Collection::bottom();
+  }
+
+  Scalar evaluate_scalar(llvm::Instruction &I) {
+    // Meet the values flowing in along executable edges.
+    if (auto *phi = dyn_cast<llvm::PHINode>(&I)) {
+      auto value = Scalar::top();
+      for (auto &incoming : phi->incoming_values()) {
+        auto *incoming_block = phi->getIncomingBlock(incoming);
+        if (this->is_executable(*incoming_block, *phi->getParent())) {
+          value = value.meet(this->value_of(*incoming.get()));
+        }
+      }
+      return value;
+    }
+
+    // Fold the instruction if all of its operands are constant.
+    vector<llvm::Constant *> operands = {};
+    bool has_top = false;
+    for (auto &operand : I.operands()) {
+      auto value = this->value_of(*operand.get());
+      if (value.kind == Scalar::BOTTOM) {
+        return value;
+      } else if (value.kind == Scalar::TOP) {
+        has_top = true;
+      }
+      operands.push_back(value.constant);
+    }
+    if (has_top) {
+      return Scalar::top();
+    }
+
+    auto &data_layout = this->M.getDataLayout();
+    llvm::Constant *folded = nullptr;
+    if (auto *cmp = dyn_cast<llvm::CmpInst>(&I)) {
+      folded = llvm::ConstantFoldCompareInstOperands(cmp->getPredicate(),
+                                                     operands[0],
+                                                     operands[1],
+                                                     data_layout);
+    } else {
+      folded = llvm::ConstantFoldInstOperands(&I, operands, data_layout);
+    }
+
+    if (folded == nullptr) {
+      return Scalar::bottom();
+    }
+    return Scalar::of(*folded);
+  }
+
+  Scalar evaluate(llvm::Instruction &I) {
+    if (is_scalar(I)) {
+      return this->evaluate_scalar(I);
+    }
+
+    llvm::Value *collection = nullptr;
+    ValueExpression *key = nullptr;
+    if (auto *read_inst = into<IndexReadInst>(I)) {
+      if (read_inst->getNumberOfDimensions() != 1) {
+        return Scalar::bottom();
+      }
+      collection = &read_inst->getObjectOperand();
+      key = this->VN.get(read_inst->getIndexOfDimension(0));
+    } else if (auto *read_inst = into<AssocReadInst>(I)) {
+      collection = &read_inst->getObjectOperand();
+      key = this->VN.get(read_inst->getKeyOperand());
+    }
+
+    if (collection == nullptr || key == nullptr) {
+      return Scalar::bottom();
+    }
+
+    auto &state = this->state_of(*collection);
+    if (state.top) {
+      return Scalar::top();
+    }
+
+    auto value = state.lookup(*key);
+    if (!value) {
+      return Scalar::bottom();
+    }
+
+    // Only fold values of the same type as the read.
+    if (value->kind == Scalar::CONSTANT
+        && value->constant->getType() != I.getType()) {
+      return Scalar::bottom();
+    }
+
+    return *value;
+  }
+
+  // Transformation.
+  bool fold_constants(llvm::Function &F) {
+    vector<llvm::Instruction *> folded = {};
+    for (auto const &[I, value] : this->scalars) {
+      if (value.kind != Scalar::CONSTANT) {
+        continue;
+      }
+      auto *inst = cast<llvm::Instruction>(I);
+      if (inst->getFunction() != &F) {
+        continue;
+      }
+
+      infoln("Folding ", *inst);
+      infoln("  to ", *value.constant);
+
+      inst->replaceAllUsesWith(value.constant);
+      folded.push_back(inst);
+    }
+
+    for (auto *inst : folded) {
+      this->scalars.erase(inst);
+      inst->eraseFromParent();
+    }
+
+    return !folded.empty();
+  }
+
+  /**
+   * Replaces the branches on folded conditions with a branch to the
+   * successor that is taken, dropping the edges that are never taken.
+   */
+  bool prune_branches(llvm::Function &F) {
+    bool pruned = false;
+    for (auto &BB : F) {
+      auto *terminator = BB.getTerminator();
+      if (terminator == nullptr || terminator->getNumSuccessors() < 2) {
+        continue;
+      }
+
+      llvm::Value *condition = nullptr;
+      if (auto *branch = dyn_cast<llvm::BranchInst>(terminator)) {
+        condition = branch->getCondition();
+      } else if (auto *switch_inst = dyn_cast<llvm::SwitchInst>(terminator)) {
+        condition = switch_inst->getCondition();
+      }
+      if (condition == nullptr || !isa<llvm::ConstantInt>(condition)) {
+        continue;
+      }
+
+      infoln("Pruning ", *terminator);
+      pruned |= llvm::ConstantFoldTerminator(&BB);
+    }
+    return pruned;
+  }
+
+  /**
+   * Returns the collection that @V is a new version of, if it is one.
+   */
+  static llvm::Use *get_base_use(llvm::Value &V) {
+    if (auto *write_inst = into<IndexWriteInst>(&V)) {
+      return &write_inst->getObjectOperandAsUse();
+    } else if (auto *write_inst = into<AssocWriteInst>(&V)) {
+      return &write_inst->getObjectOperandAsUse();
+    } else if (auto *insert_inst = into<AssocInsertInst>(&V)) {
+      return &insert_inst->getBaseCollectionAsUse();
+    } else if (auto *remove_inst = into<AssocRemoveInst>(&V)) {
+      return &remove_inst->getBaseCollectionAsUse();
+    } else if (auto *use_phi = into<UsePHIInst>(&V)) {
+      return &use_phi->getUsedCollectionAsUse();
+    }
+    return nullptr;
+  }
+
+  /**
+   * A use propagates a collection if the user is a new version of it.
+   * Deleting a collection does not observe it, so we treat it the same.
+   */
+  static bool is_propagating_use(llvm::Use &U) {
+    auto *user = U.getUser();
+    if (isa<llvm::PHINode>(user) || into<DeleteCollectionInst>(user)) {
+      return true;
+    }
+    return get_base_use(*user) == &U;
+  }
+
+  /**
+   * A use observes a collection if it reads from it without letting it
+   * escape.
+   */
+  static bool is_observing_use(llvm::Use &U) {
+    auto *user = U.getUser();
+    if (auto *read_inst = into<ReadInst>(user)) {
+      return &read_inst->getObjectOperandAsUse() == &U;
+    } else if (auto *get_inst = into<GetInst>(user)) {
+      return &get_inst->getObjectOperandAsUse() == &U;
+    } else if (into<SizeInst>(user) || into<AssocHasInst>(user)
+               || into<AssocKeysInst>(user) || into<CopyInst>(user)) {
+      return true;
+    }
+    return false;
+  }
+
+  static void find_roots(llvm::Value &V,
+                         set<llvm::Value *> &roots,
+                         set<llvm::Value *> &visited) {
+    if (!visited.insert(&V).second) {
+      return;
+    }
+
+    if (auto *base_use = get_base_use(V)) {
+      find_roots(*base_use->get(), roots, visited);
+    } else if (auto *phi = dyn_cast<llvm::PHINode>(&V)) {
+      for (auto &incoming : phi->incoming_values()) {
+        find_roots(*incoming.get(), roots, visited);
+      }
+    } else {
+      roots.insert(&V);
+    }
+  }
+
+  bool remove_dead_writes(llvm::Function &F) {
+    // Gather the collection versions of the function.
+    vector<llvm::Value *> versions = {};
+    for (auto &A : F.args()) {
+      if (Type::value_is_collection_type(A)) {
+        versions.push_back(&A);
+      }
+    }
+    for (auto &BB : F) {
+      for (auto &I : BB) {
+        if (Type::value_is_collection_type(I)) {
+          versions.push_back(&I);
+        }
+      }
+    }
+
+    // Find the live versions and the roots of collections that escape.
+    set<llvm::Value *> live = {};
+    set<llvm::Value *> escaped = {};
+    vector<llvm::Value *> worklist = {};
+    for (auto *V : versions) {
+      for (auto &use : V->uses()) {
+        if (is_propagating_use(use)) {
+          continue;
+        }
+
+        if (!is_observing_use(use)) {
+          set<llvm::Value *> visited = {};
+          find_roots(*V, escaped, visited);
+        }
+
+        if (live.insert(V).second) {
+          worklist.push_back(V);
+        }
+      }
+    }
+
+    // The versions that a live version was derived from are live.
+    while (!worklist.empty()) {
+      auto *V = worklist.back();
+      worklist.pop_back();
+
+      vector<llvm::Value *> bases = {};
+      if (auto *base_use = get_base_use(*V)) {
+        bases.push_back(base_use->get());
+      } else if (auto *phi = dyn_cast<llvm::PHINode>(V)) {
+        for (auto &incoming : phi->incoming_values()) {
+          bases.push_back(incoming.get());
+        }
+      }
+
+      for (auto *base : bases) {
+        if (live.insert(base).second) {
+          worklist.push_back(base);
+        }
+      }
+    }
+
+    // Remove the writes that are not live, if the collection they write to
+    // is allocated locally and never escapes.
+    vector<llvm::Instruction *> dead = {};
+    for (auto *V : versions) {
+      if (live.count(V) > 0) {
+        continue;
+      }
+
+      if (!(into<IndexWriteInst>(V) || into<AssocWriteInst>(V)
+            || into<AssocInsertInst>(V) || into<AssocRemoveInst>(V))) {
+        continue;
+      }
+
+      set<llvm::Value *> roots = {};
+      set<llvm::Value *> visited = {};
+      find_roots(*V, roots, visited);
+
+      bool removable = true;
+      for (auto *root : roots) {
+        if (escaped.count(root) > 0 || !into<CollectionAllocInst>(root)) {
+          removable = false;
+          break;
+        }
+      }
+
+      if (removable) {
+        dead.push_back(cast<llvm::Instruction>(V));
+      }
+    }
+
+    for (auto *inst : dead) {
+      infoln("Removing dead write ", *inst);
+      inst->replaceAllUsesWith(get_base_use(*inst)->get());
+    }
+    for (auto *inst : dead) {
+      inst->eraseFromParent();
+    }
+
+    return !dead.empty();
+  }
+
+  // Owned state.
+  map<llvm::Instruction *, Collection> collections;
+  map<llvm::Value *, Scalar> scalars;
+  set<llvm::BasicBlock *> executable_blocks;
+  ordered_set<std::pair<llvm::BasicBlock *, llvm::BasicBlock *>>
+      executable_edges;
+  vector<llvm::BasicBlock *> block_worklist;
+  vector<llvm::Instruction *> worklist;
+  set<llvm::Instruction *> in_worklist;
+  bool _transformed;
+  set<llvm::Function *> _transformed_functions;
+
+  // Borrowed state.
+  llvm::Module &M;
+  ValueNumbering &VN;
+};
+
+} // namespace llvm::memoir
+
+#endif
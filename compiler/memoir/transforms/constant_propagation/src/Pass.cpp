@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+#include "memoir/analysis/ValueNumbering.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "ConstantPropagation.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass propagates constants through the elements of collections, along
+ * the executable edges of the control flow graph.
+ */
+
+struct ConstantPropagationPass : public ModulePass {
+  static char ID;
+
+  ConstantPropagationPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN constant propagation pass");
+    infoln();
+
+    ValueNumbering VN(M);
+
+    ConstantPropagation CP(M, VN);
+
+    // Folding and pruning rewrite the values of a function, but no types.
+    for (auto *F : CP.transformed_functions()) {
+      TypeAnalysis::invalidate(*F);
+    }
+
+    infoln();
+    infoln("END constant propagation pass");
+    infoln("========================");
+
+    return CP.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char ConstantPropagationPass::ID = 0;
+static llvm::RegisterPass<ConstantPropagationPass> X(
+    "memoir-sccp",
+    "Propagates constants through the elements of collections.");
+
+} // namespace llvm::memoir
@@ -238,6 +238,8 @@ protected:
             warnln("Swap instruction is unimplemented!");
           } else if (auto *swap_within_inst = into<SeqSwapWithinInst>(inst)) {
             warnln("Swap instruction is unimplemented!");
+          } else if (auto *fill_inst = into<SeqFillInst>(inst)) {
+            warnln("Fill instruction is unimplemented!");
           }
         }
       }
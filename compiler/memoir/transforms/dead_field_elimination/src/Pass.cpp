@@ -15,6 +15,8 @@
 #include "memoir/ir/InstVisitor.hpp"
 #include "memoir/ir/Instructions.hpp"
 
+#include "memoir/analysis/TypeAnalysis.hpp"
+
 #include "memoir/support/Assert.hpp"
 #include "memoir/support/InternalDatatypes.hpp"
 #include "memoir/support/Print.hpp"
@@ -48,6 +50,11 @@ struct DeadFieldEliminationPass : public ModulePass {
 
     auto DFE = DeadFieldElimination(M);
 
+    // Elimination rewrites struct types, drop all cached types.
+    if (DFE.transformed) {
+      TypeAnalysis::invalidate();
+    }
+
     return DFE.transformed;
   }
 
@@ -290,8 +290,15 @@ protected:
   }
 
   // Transformation
-  static Type &construct_elided_type(const StructType &struct_type,
-                                     const IndexSetTy &indices_to_elide) {
+  static std::string get_companion_name(StructType &struct_type,
+                                        size_t group_index) {
+    return struct_type.getName() + ".elided." + std::to_string(group_index);
+  }
+
+  static Type &construct_elided_type(MemOIRBuilder &builder,
+                                     StructType &struct_type,
+                                     const IndexSetTy &indices_to_elide,
+                                     size_t group_index) {
 
     // If this is a single field, return the field's type.
     if (indices_to_elide.size() == 1) {
@@ -299,9 +306,42 @@ protected:
       return struct_type.getFieldType(field_index);
     }
 
-    // Otherwise, we need to create a struct type for it.
-    // TODO: implement this :)
-    MEMOIR_UNREACHABLE("Field elision with grouping is unimplemented.");
+    // Otherwise, we need to create a companion struct type holding each of the
+    // grouped fields, in ascending order of their original field index.
+    auto companion_name = get_companion_name(struct_type, group_index);
+
+    vector<Type *> field_types = {};
+    vector<llvm::Value *> field_type_values = {};
+    for (auto field_index : indices_to_elide) {
+      auto &field_type = struct_type.getFieldType(field_index);
+      field_types.push_back(&field_type);
+      field_type_values.push_back(
+          &builder.CreateTypeInst(field_type)->getCallInst());
+    }
+
+    auto *definition =
+        builder.CreateDefineStructTypeInst(companion_name.c_str(),
+                                           field_types.size(),
+                                           field_type_values);
+
+    infoln("Created companion struct ", companion_name);
+
+    return Type::define_struct_type(*definition, companion_name, field_types);
+  }
+
+  // Returns the position of @field_index within the companion struct of
+  // @indices_to_elide.
+  static unsigned get_companion_field_index(const IndexSetTy &indices_to_elide,
+                                            unsigned field_index) {
+    unsigned companion_field_index = 0;
+    for (auto elided_field_index : indices_to_elide) {
+      if (elided_field_index == field_index) {
+        return companion_field_index;
+      }
+      ++companion_field_index;
+    }
+
+    MEMOIR_UNREACHABLE("Field is not a member of the elision group!");
   }
 
   // TODO: make this extensible
@@ -570,25 +610,18 @@ protected:
       auto *struct_ref_type_inst = builder.CreateTypeInst(struct_ref_type);
       auto candidate_idx = 0;
       for (auto candidate : candidates) {
-        if (candidate.size() == 1) {
-          // Create the Value type.
-          auto candidate_field_index = *(candidate.begin());
-          auto &candidate_field_type =
-              struct_type->getFieldType(candidate_field_index);
-          auto *candidate_type_inst =
-              builder.CreateTypeInst(candidate_field_type);
-
-          // Allocate the associative arrays.
-          auto *allocation =
-              builder.CreateAssocArrayAllocInst(struct_ref_type,
-                                                candidate_field_type);
-
-          function_to_elision_values[&entry_function][struct_type]
-                                    [candidate_idx] =
-                                        &allocation->getCallInst();
-        } else {
-          MEMOIR_UNREACHABLE("Field elision groups are not supported!");
-        }
+        // Create the Value type, grouped fields share a companion struct.
+        auto &elided_type = construct_elided_type(builder,
+                                                  *struct_type,
+                                                  candidate,
+                                                  candidate_idx);
+
+        // Allocate the associative arrays.
+        auto *allocation =
+            builder.CreateAssocArrayAllocInst(struct_ref_type, elided_type);
+
+        function_to_elision_values[&entry_function][struct_type]
+                                  [candidate_idx] = &allocation->getCallInst();
 
         ++candidate_idx;
       }
@@ -716,7 +749,7 @@ protected:
           access_as_call = &struct_write->getCallInst();
           field_index = struct_write->getFieldIndex();
           field_index_as_use = &struct_write->getFieldIndexOperandAsUse();
-        } else if (auto *struct_get = dyn_cast<StructWriteInst>(access)) {
+        } else if (auto *struct_get = dyn_cast<StructGetInst>(access)) {
           access_as_call = &struct_get->getCallInst();
           field_index = struct_get->getFieldIndex();
           field_index_as_use = &struct_get->getFieldIndexOperandAsUse();
@@ -734,14 +767,16 @@ protected:
 
         // Check if this field index is elided.
         size_t elision_group_index = (size_t)-1;
+        const IndexSetTy *elided_group = nullptr;
         bool elided = false;
         for (auto const &[struct_type, elision_groups] : fields_to_elide) {
           if (struct_type == accessed_struct_type) {
             elision_group_index = 0;
-            for (auto elision_group : elision_groups) {
+            for (auto const &elision_group : elision_groups) {
               for (auto elision_field_index : elision_group) {
                 if (elision_field_index == field_index) {
                   elided = true;
+                  elided_group = &elision_group;
                   break;
                 }
               }
@@ -759,6 +794,47 @@ protected:
           continue;
         }
 
+        // Get the elision replacement value.
+        auto *replacement_collection =
+            elision_values[accessed_struct_type][elision_group_index];
+
+        // If the field was elided as part of a group, fetch the companion
+        // struct from the assoc and access the field within it.
+        if (elided_group->size() > 1) {
+          MemOIRBuilder access_builder(access_as_call);
+          auto &companion_type = Type::get_struct_type(
+              get_companion_name(*accessed_struct_type, elision_group_index));
+          auto *companion =
+              access_builder.CreateAssocGetInst(companion_type,
+                                                replacement_collection,
+                                                object_value);
+
+          // Get the field's index in the companion.
+          auto companion_field_index =
+              get_companion_field_index(*elided_group, field_index);
+          auto *companion_field_index_value = llvm::ConstantInt::get(
+              field_index_as_use->get()->getType(),
+              companion_field_index);
+
+          // Rebuild reads on the companion struct.
+          if (isa<StructReadInst>(access)) {
+            auto *companion_read = access_builder.CreateStructReadInst(
+                companion_type.getFieldType(companion_field_index),
+                &companion->getCallInst(),
+                companion_field_index_value);
+            companion_read->getCallInst().takeName(access_as_call);
+            access_as_call->replaceAllUsesWith(&companion_read->getCallInst());
+            instructions_to_delete.insert(access_as_call);
+            continue;
+          }
+
+          // Otherwise, redirect the access to the companion struct in place.
+          field_index_as_use->set(companion_field_index_value);
+          object_use.set(&companion->getCallInst());
+
+          continue;
+        }
+
         // Get the replacement function.
         auto &original_function =
             MEMOIR_SANITIZE(access_as_call->getCalledFunction(),
@@ -767,10 +843,6 @@ protected:
             MEMOIR_SANITIZE(get_assoc_function(original_function),
                             "Could not find assoc function");
 
-        // Get the elision replacement value.
-        auto *replacement_collection =
-            elision_values[accessed_struct_type][elision_group_index];
-
         // Replace the called function.
         access_as_call->setCalledFunction(&replacement_function);
 
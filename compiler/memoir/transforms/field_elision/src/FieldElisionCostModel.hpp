@@ -0,0 +1,228 @@
+#ifndef MEMOIR_FIELDELISIONCOSTMODEL_H
+#define MEMOIR_FIELDELISIONCOSTMODEL_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "FieldElision.hpp"
+
+/*
+ * This class selects fields to elide without user input.
+ *
+ * A field is a good candidate for elision when most instances of its struct
+ * hold the field's default value, since the side assoc array then only holds
+ * the few non-default entries. Each access to an elided field becomes an
+ * assoc lookup, so the memory saved must outweigh the accesses made.
+ *
+ * For each field we estimate, weighting each instruction by the execution
+ * count of its basic block:
+ *  - allocations, the number of structs allocated of its type,
+ *  - sparsity, the fraction of those structs that are never written a
+ *    non-default (non-zero) value in the field, and
+ *  - accesses, the number of reads and writes of the field.
+ *
+ * The field is elided if its sparsity is above the threshold and
+ *   allocations * sparsity * field size > accesses * access cost
+ */
+
+namespace llvm::memoir {
+
+class FieldElisionCostModel {
+public:
+  using BlockWeightsTy = map<llvm::BasicBlock *, double>;
+
+  /**
+   * Constructs the cost model for the program @M.
+   * @block_weights holds the execution count of each basic block, blocks that
+   * are missing are assumed to execute once.
+   */
+  FieldElisionCostModel(llvm::Module &M,
+                        const BlockWeightsTy &block_weights,
+                        double sparsity_threshold,
+                        double access_cost)
+    : M(M),
+      block_weights(block_weights),
+      sparsity_threshold(sparsity_threshold),
+      access_cost(access_cost) {
+    this->analyze();
+  }
+
+  /**
+   * Adds the profitable elision candidates to @fields_to_elide.
+   * Struct types that already have user-specified candidates are skipped.
+   */
+  void select(FieldElision::FieldsToElideMapTy &fields_to_elide) {
+    for (auto const &[struct_type, type_stats] : this->type_stats) {
+      if (fields_to_elide.find(struct_type) != fields_to_elide.end()) {
+        continue;
+      }
+
+      if (type_stats.allocations == 0) {
+        continue;
+      }
+
+      for (unsigned field_index = 0; field_index < struct_type->getNumFields();
+           ++field_index) {
+        auto found_field = type_stats.fields.find(field_index);
+        if (found_field == type_stats.fields.end()) {
+          // Unused fields are left to dead field elimination.
+          continue;
+        }
+        auto &field_stats = found_field->second;
+
+        auto field_size = this->get_field_size(*struct_type, field_index);
+        if (field_size == 0) {
+          continue;
+        }
+
+        auto non_default_ratio =
+            field_stats.non_default_writes / type_stats.allocations;
+        auto sparsity = 1.0 - std::min(1.0, non_default_ratio);
+
+        auto benefit = type_stats.allocations * sparsity * field_size;
+        auto cost = field_stats.accesses * this->access_cost;
+
+        debugln("FE cost model: ",
+                struct_type->getName(),
+                ".",
+                field_index,
+                " sparsity=",
+                sparsity,
+                " benefit=",
+                benefit,
+                " cost=",
+                cost);
+
+        if (sparsity >= this->sparsity_threshold && benefit > cost) {
+          infoln("Selected ",
+                 struct_type->getName(),
+                 ":",
+                 field_index,
+                 " for elision");
+          fields_to_elide[struct_type].push_back({ field_index });
+        }
+      }
+    }
+  }
+
+protected:
+  struct FieldStats {
+    double non_default_writes = 0.0;
+    double accesses = 0.0;
+  };
+
+  struct TypeStats {
+    double allocations = 0.0;
+    map<unsigned, FieldStats> fields;
+  };
+
+  double get_weight(llvm::Instruction &I) const {
+    auto found = this->block_weights.find(I.getParent());
+    if (found == this->block_weights.end()) {
+      return 1.0;
+    }
+    return found->second;
+  }
+
+  // Returns the size in bytes of the field, or 0 if it cannot be elided.
+  unsigned get_field_size(StructType &struct_type, unsigned field_index) const {
+    auto &field_type = struct_type.getFieldType(field_index);
+    if (auto *int_type = dyn_cast<IntegerType>(&field_type)) {
+      return (int_type->getBitWidth() + 7) / 8;
+    } else if (isa<FloatType>(&field_type)) {
+      return 4;
+    } else if (isa<DoubleType>(&field_type)) {
+      return 8;
+    } else if (isa<PointerType>(&field_type)
+               || isa<ReferenceType>(&field_type)) {
+      return this->M.getDataLayout().getPointerSize();
+    }
+
+    // Nested structs and collections are not elided.
+    return 0;
+  }
+
+  static StructType *get_accessed_type(AccessInst &access) {
+    auto *type = TypeAnalysis::analyze(access.getObjectOperand());
+    return dyn_cast_or_null<StructType>(type);
+  }
+
+  void analyze() {
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      for (auto &BB : F) {
+        for (auto &I : BB) {
+          auto *memoir_inst = MemOIRInst::get(I);
+          if (memoir_inst == nullptr) {
+            continue;
+          }
+
+          auto weight = this->get_weight(I);
+
+          if (auto *alloc_inst = dyn_cast<StructAllocInst>(memoir_inst)) {
+            auto &struct_type = alloc_inst->getStructType();
+            this->type_stats[&struct_type].allocations += weight;
+          } else if (auto *read_inst = dyn_cast<StructReadInst>(memoir_inst)) {
+            if (auto *struct_type = get_accessed_type(*read_inst)) {
+              auto &field_stats =
+                  this->type_stats[struct_type]
+                      .fields[read_inst->getFieldIndex()];
+              field_stats.accesses += weight;
+            }
+          } else if (auto *write_inst =
+                         dyn_cast<StructWriteInst>(memoir_inst)) {
+            if (auto *struct_type = get_accessed_type(*write_inst)) {
+              auto &field_stats =
+                  this->type_stats[struct_type]
+                      .fields[write_inst->getFieldIndex()];
+              field_stats.accesses += weight;
+
+              auto *value_written =
+                  dyn_cast<llvm::Constant>(&write_inst->getValueWritten());
+              if (value_written == nullptr || !value_written->isNullValue()) {
+                field_stats.non_default_writes += weight;
+              }
+            }
+          } else if (auto *get_inst = dyn_cast<StructGetInst>(memoir_inst)) {
+            if (auto *struct_type = get_accessed_type(*get_inst)) {
+              auto &field_stats =
+                  this->type_stats[struct_type]
+                      .fields[get_inst->getFieldIndex()];
+              field_stats.accesses += weight;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  // Owned state.
+  map<StructType *, TypeStats> type_stats;
+
+  // Borrowed state.
+  llvm::Module &M;
+  const BlockWeightsTy &block_weights;
+  double sparsity_threshold;
+  double access_cost;
+};
+
+} // namespace llvm::memoir
+
+#endif
@@ -11,6 +11,7 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 
+#include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/CallGraph.h"
 
 // MemOIR
@@ -18,6 +19,8 @@
 #include "memoir/ir/Instructions.hpp"
 #include "memoir/ir/Types.hpp"
 
+#include "memoir/analysis/TypeAnalysis.hpp"
+
 #include "memoir/support/Assert.hpp"
 #include "memoir/support/InternalDatatypes.hpp"
 #include "memoir/support/Print.hpp"
@@ -26,6 +29,7 @@
 
 // Field Elision
 #include "FieldElision.hpp"
+#include "FieldElisionCostModel.hpp"
 
 using namespace llvm::memoir;
 
@@ -43,6 +47,22 @@ static llvm::cl::list<std::string> FieldsToElide(
     cl::desc("Specify fields to elide as NAME:FIELD#,..."),
     cl::ZeroOrMore);
 
+static llvm::cl::opt<bool> AutoElide(
+    "elide-auto",
+    cl::desc("Select fields to elide with the cost model"),
+    cl::init(false));
+
+static llvm::cl::opt<double> ElideSparsityThreshold(
+    "elide-sparsity-threshold",
+    cl::desc("Minimum fraction of structs holding the default value for a "
+             "field to be elided automatically"),
+    cl::init(0.9));
+
+static llvm::cl::opt<double> ElideAccessCost(
+    "elide-access-cost",
+    cl::desc("Cost, in bytes saved, of each access to an elided field"),
+    cl::init(8.0));
+
 struct FieldElisionPass : public ModulePass {
   static char ID;
 
@@ -119,9 +139,44 @@ struct FieldElisionPass : public ModulePass {
       fields_to_elide[&elide_struct_type].push_back(field_indices);
     }
 
+    // Select the remaining candidates with the cost model.
+    if (AutoElide) {
+      FieldElisionCostModel::BlockWeightsTy block_weights = {};
+      for (auto &F : M) {
+        if (F.empty()) {
+          continue;
+        }
+
+        // Use profile counts if we have them, otherwise fall back to the
+        // static block frequency relative to the function entry.
+        auto &BFI =
+            getAnalysis<llvm::BlockFrequencyInfoWrapperPass>(F).getBFI();
+        auto entry_frequency = (double)BFI.getEntryFreq();
+        for (auto &BB : F) {
+          if (auto profile_count = BFI.getBlockProfileCount(&BB)) {
+            block_weights[&BB] = (double)*profile_count;
+          } else if (entry_frequency > 0) {
+            block_weights[&BB] =
+                (double)BFI.getBlockFreq(&BB).getFrequency() / entry_frequency;
+          }
+        }
+      }
+
+      FieldElisionCostModel cost_model(M,
+                                       block_weights,
+                                       ElideSparsityThreshold,
+                                       ElideAccessCost);
+      cost_model.select(fields_to_elide);
+    }
+
     // Perform field elision on the candidates.
     auto FE = FieldElision(M, CG, fields_to_elide);
 
+    // Elision rewrites struct types, drop all cached types.
+    if (FE.transformed) {
+      TypeAnalysis::invalidate();
+    }
+
     infoln();
     infoln("END field elision pass");
     infoln("========================");
@@ -132,6 +187,7 @@ struct FieldElisionPass : public ModulePass {
 
   void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
     AU.addRequired<llvm::CallGraphWrapperPass>();
+    AU.addRequired<llvm::BlockFrequencyInfoWrapperPass>();
     return;
   }
 };
@@ -0,0 +1,399 @@
+#ifndef MEMOIR_IDIOMRECOGNITION_H
+#define MEMOIR_IDIOMRECOGNITION_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/ir/Builder.hpp"
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/analysis/IterationSpace.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class recognizes loops that write a sequence one element at a time and
+ * replaces them with a single bulk operation on the sequence.
+ *
+ * Two idioms are recognized:
+ *  - fill:  for (i = s; i < e; ++i) b[f(i)] = v;
+ *           becomes b' = fill(v, b, f(s), f(e))
+ *  - copy:  for (i = s; i < e; ++i) b[f(i)] = a[g(i)];
+ *           becomes b' = swap(copy(a, g(s), g(e)), 0, e - s, b, f(s))
+ *
+ * where v and a are loop-invariant and f and g add a loop-invariant offset to
+ * the induction variable. The loop is found with NOELLE's loop-governing
+ * induction variable, which must start at s, step by one and exit on a
+ * less-than comparison against e in the loop header.
+ */
+
+namespace llvm::memoir {
+
+class IdiomRecognition {
+public:
+  /**
+   * Recognizes element-wise fill and copy loops in the program @M, using the
+   * induction variables found by @noelle.
+   */
+  IdiomRecognition(llvm::Module &M, arcana::noelle::Noelle &noelle)
+    : M(M),
+      noelle(noelle) {
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+protected:
+  // Top-level driver.
+  bool run() {
+    bool transformed = false;
+
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      auto *loops = this->noelle.getLoopContents(&F);
+      if (loops == nullptr) {
+        continue;
+      }
+
+      llvm::DominatorTree DT(F);
+      llvm::LoopInfo LI(DT);
+
+      for (auto *loop : *loops) {
+        auto &loop_structure =
+            MEMOIR_SANITIZE(loop->getLoopStructure(),
+                            "NOELLE gave us a NULL LoopStructure!");
+        auto &IVM =
+            MEMOIR_SANITIZE(loop->getInductionVariableManager(),
+                            "NOELLE gave us a NULL InductionVariableManager");
+
+        auto *llvm_loop = LI.getLoopFor(loop_structure.getHeader());
+        if (llvm_loop == nullptr
+            || llvm_loop->getHeader() != loop_structure.getHeader()) {
+          continue;
+        }
+
+        auto space = analyze_iteration_space(*llvm_loop, loop_structure, IVM);
+        if (!space) {
+          continue;
+        }
+
+        transformed |= this->recognize(*llvm_loop, *space, DT, LI);
+      }
+    }
+
+    return transformed;
+  }
+
+  // Analysis.
+  /**
+   * Checks that @V is computed from the induction variable @IV by a chain of
+   * extensions and additions of loop-invariant values.
+   */
+  static bool is_affine_in(llvm::Value &V,
+                           llvm::PHINode &IV,
+                           llvm::Loop &L) {
+    if (&V == &IV) {
+      return true;
+    }
+
+    auto *inst = dyn_cast<llvm::Instruction>(&V);
+    if (inst == nullptr || !L.contains(inst)) {
+      return false;
+    }
+
+    if (isa<llvm::ZExtInst>(inst) || isa<llvm::SExtInst>(inst)) {
+      return is_affine_in(*inst->getOperand(0), IV, L);
+    } else if (auto *binary = dyn_cast<llvm::BinaryOperator>(inst)) {
+      auto opcode = binary->getOpcode();
+      auto &lhs = *binary->getOperand(0);
+      auto &rhs = *binary->getOperand(1);
+      if (opcode == llvm::Instruction::Add) {
+        return (L.isLoopInvariant(&rhs) && is_affine_in(lhs, IV, L))
+               || (L.isLoopInvariant(&lhs) && is_affine_in(rhs, IV, L));
+      } else if (opcode == llvm::Instruction::Sub) {
+        return L.isLoopInvariant(&rhs) && is_affine_in(lhs, IV, L);
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Rebuilds the computation of @V from the induction variable @IV before the
+   * builder's insertion point, with @IV replaced by @replacement.
+   */
+  static llvm::Value *materialize(llvm::IRBuilder<> &builder,
+                                  llvm::Value &V,
+                                  llvm::PHINode &IV,
+                                  llvm::Value &replacement,
+                                  llvm::Loop &L) {
+    if (&V == &IV) {
+      return &replacement;
+    } else if (L.isLoopInvariant(&V)) {
+      return &V;
+    }
+
+    auto *clone = cast<llvm::Instruction>(&V)->clone();
+    for (auto &operand : clone->operands()) {
+      operand.set(materialize(builder, *operand.get(), IV, replacement, L));
+    }
+
+    // The end of the range is one past the last index written, so wrapping
+    // flags that held within the loop may not hold for it.
+    clone->dropPoisonGeneratingFlags();
+
+    return builder.Insert(clone, V.getName() + ".idiom");
+  }
+
+  // Transformation.
+  bool recognize(llvm::Loop &L,
+                 IterationSpace &space,
+                 llvm::DominatorTree &DT,
+                 llvm::LoopInfo &LI) {
+    bool transformed = false;
+
+    // Find the collection PHIs in the header that are written once per
+    // iteration.
+    vector<llvm::PHINode *> phis = {};
+    for (auto &phi : space.header->phis()) {
+      phis.push_back(&phi);
+    }
+
+    for (auto *phi : phis) {
+      if (phi->getNumIncomingValues() != 2) {
+        continue;
+      }
+
+      auto *write = into<IndexWriteInst>(
+          phi->getIncomingValueForBlock(space.latch));
+      if (write == nullptr || &write->getObjectOperand() != phi
+          || write->getNumberOfDimensions() != 1) {
+        continue;
+      }
+
+      auto &write_inst = write->getCallInst();
+      auto *write_block = write_inst.getParent();
+      if (write_block == space.header || !DT.dominates(write_block, space.latch)
+          || LI.getLoopFor(write_block) != &L) {
+        continue;
+      }
+
+      // The intermediate versions of the collection must not be observed.
+      if (!this->has_single_loop_user(*phi, write_inst, L)
+          || !this->has_single_loop_user(write_inst, *phi, L)) {
+        continue;
+      }
+
+      auto *seq_type = dyn_cast<SequenceType>(&write->getCollectionType());
+      if (seq_type == nullptr) {
+        continue;
+      }
+
+      auto &index = write->getIndexOfDimension(0);
+      if (!is_affine_in(index, *space.induction_variable, L)) {
+        continue;
+      }
+
+      auto &value = write->getValueWritten();
+      if (L.isLoopInvariant(&value)) {
+        transformed |=
+            this->replace_with_fill(L, space, *phi, *write, *seq_type);
+      } else if (auto *read = into<IndexReadInst>(&value)) {
+        transformed |=
+            this->replace_with_copy(L, space, *phi, *write, *read, *seq_type);
+      }
+    }
+
+    return transformed;
+  }
+
+  static bool has_single_loop_user(llvm::Value &V,
+                                   llvm::Value &expected,
+                                   llvm::Loop &L) {
+    for (auto *user : V.users()) {
+      auto *user_inst = dyn_cast<llvm::Instruction>(user);
+      if (user_inst == nullptr) {
+        return false;
+      } else if (user_inst != &expected && L.contains(user_inst)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Computes the index range [begin, end) written by the loop in the
+   * preheader. Empty iteration spaces yield an empty range.
+   */
+  std::pair<llvm::Value *, llvm::Value *> materialize_range(
+      llvm::IRBuilder<> &builder,
+      llvm::Loop &L,
+      IterationSpace &space,
+      llvm::Value &index) {
+    auto &IV = *space.induction_variable;
+
+    auto *in_bounds =
+        builder.CreateICmp(space.predicate, space.start, space.end);
+    auto *last = builder.CreateSelect(in_bounds, space.end, space.start);
+
+    auto *begin = materialize(builder, index, IV, *space.start, L);
+    auto *end = materialize(builder, index, IV, *last, L);
+
+    return { begin, end };
+  }
+
+  bool replace_with_fill(llvm::Loop &L,
+                         IterationSpace &space,
+                         llvm::PHINode &phi,
+                         IndexWriteInst &write,
+                         SequenceType &seq_type) {
+    auto &index = write.getIndexOfDimension(0);
+    if (!index.getType()->isIntegerTy(64)) {
+      return false;
+    }
+
+    infoln("Recognized fill loop:");
+    infoln("  ", write);
+
+    MemOIRBuilder builder(space.preheader->getTerminator());
+    auto [begin, end] = this->materialize_range(builder, L, space, index);
+
+    auto *initial = phi.getIncomingValueForBlock(space.preheader);
+    auto *fill = builder.CreateSeqFillInst(seq_type.getElementType(),
+                                           &write.getValueWritten(),
+                                           initial,
+                                           begin,
+                                           end,
+                                           "seq.fill.");
+
+    this->rewire(space, phi, write, fill->getCallInst());
+
+    // Drop the cached instructions that were erased.
+    MemOIRInst::invalidate();
+
+    return true;
+  }
+
+  bool replace_with_copy(llvm::Loop &L,
+                         IterationSpace &space,
+                         llvm::PHINode &phi,
+                         IndexWriteInst &write,
+                         IndexReadInst &read,
+                         SequenceType &seq_type) {
+    auto &read_inst = read.getCallInst();
+    auto &source = read.getObjectOperand();
+    if (!L.contains(&read_inst) || !L.isLoopInvariant(&source)
+        || read.getNumberOfDimensions() != 1 || !read_inst.hasOneUse()) {
+      return false;
+    }
+
+    auto *source_type = dyn_cast<SequenceType>(&read.getCollectionType());
+    if (source_type == nullptr
+        || &source_type->getElementType() != &seq_type.getElementType()) {
+      return false;
+    }
+
+    auto &write_index = write.getIndexOfDimension(0);
+    auto &read_index = read.getIndexOfDimension(0);
+    if (!is_affine_in(read_index, *space.induction_variable, L)
+        || !write_index.getType()->isIntegerTy(64)
+        || !read_index.getType()->isIntegerTy(64)) {
+      return false;
+    }
+
+    infoln("Recognized copy loop:");
+    infoln("  ", read);
+    infoln("  ", write);
+
+    MemOIRBuilder builder(space.preheader->getTerminator());
+    auto [read_begin, read_end] =
+        this->materialize_range(builder, L, space, read_index);
+    auto *write_begin = materialize(builder,
+                                    write_index,
+                                    *space.induction_variable,
+                                    *space.start,
+                                    L);
+
+    // Both indices step by one, so the ranges have the same length and the
+    // copied range can be swapped over the destination in place.
+    auto *initial = phi.getIncomingValueForBlock(space.preheader);
+    auto *copy = builder.CreateSeqCopyInst(&source,
+                                           read_begin,
+                                           read_end,
+                                           "seq.copy.");
+    auto *length = builder.CreateSub(read_end, read_begin, "seq.copy.len.");
+    auto *swap = builder.CreateSeqSwapInst(&copy->getCallInst(),
+                                           builder.getInt64(0),
+                                           length,
+                                           initial,
+                                           write_begin,
+                                           "seq.swap.");
+    auto *swapped_out =
+        builder.CreateExtractValue(&swap->getCallInst(),
+                                   llvm::ArrayRef<unsigned>({ 0 }),
+                                   "seq.swap.from.");
+    auto *overwritten =
+        builder.CreateExtractValue(&swap->getCallInst(),
+                                   llvm::ArrayRef<unsigned>({ 1 }),
+                                   "seq.swap.to.");
+    builder.CreateDeleteCollectionInst(swapped_out);
+
+    this->rewire(space, phi, write, *overwritten);
+
+    read_inst.eraseFromParent();
+
+    // Drop the cached instructions that were erased.
+    MemOIRInst::invalidate();
+
+    return true;
+  }
+
+  /**
+   * Makes the loop carry @replacement in place of its element-wise writes.
+   */
+  void rewire(IterationSpace &space,
+              llvm::PHINode &phi,
+              IndexWriteInst &write,
+              llvm::Value &replacement) {
+    phi.setIncomingValueForBlock(space.preheader, &replacement);
+
+    auto &write_inst = write.getCallInst();
+    write_inst.replaceAllUsesWith(&phi);
+    write_inst.eraseFromParent();
+  }
+
+  // Owned state.
+  bool _transformed;
+
+  // Borrowed state.
+  llvm::Module &M;
+  arcana::noelle::Noelle &noelle;
+};
+
+} // namespace llvm::memoir
+
+#endif
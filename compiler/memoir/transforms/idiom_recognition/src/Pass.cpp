@@ -0,0 +1,78 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/ir/InstVisitor.hpp"
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "IdiomRecognition.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass replaces loops that fill or copy a sequence one element at a time
+ * with bulk sequence operations.
+ */
+
+struct IdiomRecognitionPass : public ModulePass {
+  static char ID;
+
+  IdiomRecognitionPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN idiom recognition pass");
+    infoln();
+
+    auto &noelle = getAnalysis<arcana::noelle::Noelle>();
+
+    IdiomRecognition IR(M, noelle);
+
+    // If the pass rewrote any loops, the type analysis results are stale.
+    if (IR.transformed()) {
+      TypeAnalysis::invalidate();
+    }
+
+    infoln();
+    infoln("END idiom recognition pass");
+    infoln("========================");
+
+    return IR.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.addRequired<arcana::noelle::Noelle>();
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char IdiomRecognitionPass::ID = 0;
+static llvm::RegisterPass<IdiomRecognitionPass> X(
+    "memoir-idiom",
+    "Replaces element-wise fill and copy loops with bulk operations.");
+
+} // namespace llvm::memoir
@@ -67,10 +67,8 @@ struct ImplLinkerPass : public ModulePass {
   }
 
   bool runOnModule(llvm::Module &M) override {
-    TypeAnalysis::invalidate();
-
     // Get the TypeConverter.
-    TypeConverter TC(M.getContext());
+    TypeConverter TC(M);
 
     // Get the ImplLinker.
     ImplLinker IL(M);
@@ -112,8 +110,13 @@ struct ImplLinkerPass : public ModulePass {
             // Get the type layout for the struct.
             auto &struct_layout = TC.convert(struct_type);
 
-            // Implement the struct.
-            IL.implement_type(struct_layout);
+            // Implement the struct, allocating it from an arena if its
+            // references are compressed.
+            if (CompressReferences) {
+              IL.implement_arena(struct_layout);
+            } else {
+              IL.implement_type(struct_layout);
+            }
           }
         }
       }
@@ -0,0 +1,619 @@
+#ifndef MEMOIR_INTEGERNARROWING_H
+#define MEMOIR_INTEGERNARROWING_H
+#pragma once
+
+#include <regex>
+
+// LLVM
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/ir/Builder.hpp"
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/MutOperations.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/analysis/RangeAnalysis.hpp"
+#include "memoir/analysis/TypeAnalysis.hpp"
+#include "memoir/analysis/ValueExpression.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class narrows 64-bit integer struct fields and sequence elements to the
+ * smallest of 8, 16 or 32 bits that provably holds every value written to them.
+ *
+ * The bound of each value written comes from its ValueRange, when the
+ * RangeAnalysis has a constant one, or else from the LLVM instructions that
+ * compute it. Values that may be negative are never narrowed.
+ *
+ * Struct fields are narrowed per struct type, so none of the structs of that
+ * type may escape. Sequences are narrowed per allocation, so every use of the
+ * allocation must be a read, write, size or PHI within the function.
+ */
+
+namespace llvm::memoir {
+
+class IntegerNarrowing {
+  using AccessListTy = vector<MemOIRInst *>;
+  using StructTypeSetTy = set<StructType *>;
+
+public:
+  bool transformed;
+
+  IntegerNarrowing(llvm::Module &M, arcana::noelle::Noelle &noelle)
+    : M(M),
+      noelle(noelle) {
+    this->transformed = this->run();
+  }
+
+  ~IntegerNarrowing() {
+    for (auto const &[function, range_analysis] : this->range_analyses) {
+      delete range_analysis;
+    }
+  }
+
+protected:
+  struct FieldInfo {
+    AccessListTy reads;
+    AccessListTy writes;
+  };
+
+  // Top-level driver.
+  bool run() {
+    bool transformed = false;
+
+    this->analyze_structs();
+    for (auto &[struct_type, fields] : this->struct_fields) {
+      if (this->escaped_types.count(struct_type) > 0) {
+        continue;
+      }
+
+      for (auto &[field_index, field_info] : fields) {
+        transformed |=
+            this->narrow_field(*struct_type, field_index, field_info);
+      }
+    }
+
+    // Gather the sequence allocations before we begin rewriting.
+    vector<SequenceAllocInst *> seq_allocs = {};
+    for (auto &F : this->M) {
+      for (auto &BB : F) {
+        for (auto &I : BB) {
+          if (auto *seq_alloc = into<SequenceAllocInst>(&I)) {
+            seq_allocs.push_back(seq_alloc);
+          }
+        }
+      }
+    }
+    for (auto *seq_alloc : seq_allocs) {
+      transformed |= this->narrow_sequence(*seq_alloc);
+    }
+
+    return transformed;
+  }
+
+  // Helpers
+  static inline bool value_escapes(llvm::Value &V) {
+    for (auto *user : V.users()) {
+      if (auto *user_as_call = dyn_cast_or_null<llvm::CallBase>(user)) {
+        // If the user is a memoir instruction, continue.
+        if (auto *user_as_memoir = MemOIRInst::get(*user_as_call)) {
+          continue;
+        }
+
+        // Get the called function.
+        auto *called_function = user_as_call->getCalledFunction();
+
+        // If it is an indirect call, then the value escapes.
+        if (called_function == nullptr) {
+          return true;
+        }
+
+        // If it is empty, then the value escapes.
+        if (called_function->empty()) {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  RangeAnalysis &get_range_analysis(llvm::Function &F) {
+    auto found = this->range_analyses.find(&F);
+    if (found != this->range_analyses.end()) {
+      return *(found->second);
+    }
+
+    auto *range_analysis = new RangeAnalysis(F, this->noelle);
+    this->range_analyses[&F] = range_analysis;
+    return *range_analysis;
+  }
+
+  static opt<unsigned> get_constant_bits(ValueExpression &expr) {
+    auto *constant_expr = dyn_cast<ConstantExpression>(&expr);
+    if (constant_expr == nullptr) {
+      return {};
+    }
+
+    auto *constant_int =
+        dyn_cast<llvm::ConstantInt>(&constant_expr->getConstant());
+    if (constant_int == nullptr || constant_int->isNegative()) {
+      return {};
+    }
+
+    return constant_int->getValue().getActiveBits();
+  }
+
+  // Returns the number of bits needed to hold the value of @V as an unsigned
+  // integer, or none if it may be negative or is unbounded.
+  static opt<unsigned> get_active_bits(llvm::Value &V,
+                                       set<llvm::Value *> &visited) {
+    if (auto *constant_int = dyn_cast<llvm::ConstantInt>(&V)) {
+      if (constant_int->isNegative()) {
+        return {};
+      }
+      return constant_int->getValue().getActiveBits();
+    }
+
+    // Bail out on cycles.
+    if (!visited.insert(&V).second) {
+      return {};
+    }
+
+    auto bits_of = [&](llvm::Value *operand) {
+      return get_active_bits(*operand, visited);
+    };
+
+    auto limit = [](unsigned bits) -> opt<unsigned> {
+      if (bits > 64) {
+        return {};
+      }
+      return bits;
+    };
+
+    if (auto *zext = dyn_cast<llvm::ZExtInst>(&V)) {
+      return zext->getSrcTy()->getIntegerBitWidth();
+    } else if (auto *trunc = dyn_cast<llvm::TruncInst>(&V)) {
+      return bits_of(trunc->getOperand(0));
+    } else if (auto *select = dyn_cast<llvm::SelectInst>(&V)) {
+      auto true_bits = bits_of(select->getTrueValue());
+      auto false_bits = bits_of(select->getFalseValue());
+      if (!true_bits || !false_bits) {
+        return {};
+      }
+      return std::max(*true_bits, *false_bits);
+    } else if (auto *phi = dyn_cast<llvm::PHINode>(&V)) {
+      unsigned max_bits = 0;
+      for (auto &incoming : phi->incoming_values()) {
+        auto incoming_bits = bits_of(incoming.get());
+        if (!incoming_bits) {
+          return {};
+        }
+        max_bits = std::max(max_bits, *incoming_bits);
+      }
+      return max_bits;
+    } else if (auto *binary_op = dyn_cast<llvm::BinaryOperator>(&V)) {
+      auto *lhs = binary_op->getOperand(0);
+      auto *rhs = binary_op->getOperand(1);
+      switch (binary_op->getOpcode()) {
+        case llvm::Instruction::And: {
+          auto lhs_bits = bits_of(lhs);
+          auto rhs_bits = bits_of(rhs);
+          if (lhs_bits && rhs_bits) {
+            return std::min(*lhs_bits, *rhs_bits);
+          }
+          return lhs_bits ? lhs_bits : rhs_bits;
+        }
+        case llvm::Instruction::Or:
+        case llvm::Instruction::Xor: {
+          auto lhs_bits = bits_of(lhs);
+          auto rhs_bits = bits_of(rhs);
+          if (!lhs_bits || !rhs_bits) {
+            return {};
+          }
+          return std::max(*lhs_bits, *rhs_bits);
+        }
+        case llvm::Instruction::Add: {
+          auto lhs_bits = bits_of(lhs);
+          auto rhs_bits = bits_of(rhs);
+          if (!lhs_bits || !rhs_bits) {
+            return {};
+          }
+          return limit(std::max(*lhs_bits, *rhs_bits) + 1);
+        }
+        case llvm::Instruction::Mul: {
+          auto lhs_bits = bits_of(lhs);
+          auto rhs_bits = bits_of(rhs);
+          if (!lhs_bits || !rhs_bits) {
+            return {};
+          }
+          return limit(*lhs_bits + *rhs_bits);
+        }
+        case llvm::Instruction::LShr: {
+          auto lhs_bits = bits_of(lhs);
+          auto *shift = dyn_cast<llvm::ConstantInt>(rhs);
+          if (!lhs_bits || shift == nullptr) {
+            return {};
+          }
+          auto shift_amount = shift->getZExtValue();
+          return (shift_amount >= *lhs_bits) ? 0 : *lhs_bits - shift_amount;
+        }
+        case llvm::Instruction::URem: {
+          // The result is less than the divisor.
+          auto rhs_bits = bits_of(rhs);
+          auto lhs_bits = bits_of(lhs);
+          if (rhs_bits && lhs_bits) {
+            return std::min(*lhs_bits, *rhs_bits);
+          }
+          return rhs_bits ? rhs_bits : lhs_bits;
+        }
+        case llvm::Instruction::UDiv: {
+          return bits_of(lhs);
+        }
+        default:
+          break;
+      }
+    }
+
+    return {};
+  }
+
+  // Returns the number of bits needed to hold the value written by @use.
+  opt<unsigned> get_written_bits(llvm::Use &use) {
+    // Use the value range, if it is constant.
+    auto *user = dyn_cast<llvm::Instruction>(use.getUser());
+    if (user != nullptr) {
+      auto &function = MEMOIR_SANITIZE(user->getFunction(),
+                                       "Write does not belong to a function!");
+      auto &range_analysis = this->get_range_analysis(function);
+      if (auto *range = range_analysis.find_value_range(use)) {
+        auto lower_bits = get_constant_bits(range->get_lower());
+        auto upper_bits = get_constant_bits(range->get_upper());
+        if (lower_bits && upper_bits) {
+          return upper_bits;
+        }
+      }
+    }
+
+    // Otherwise, inspect the computation of the value.
+    set<llvm::Value *> visited = {};
+    return get_active_bits(*use.get(), visited);
+  }
+
+  static opt<unsigned> get_narrow_width(unsigned bits, bool is_signed) {
+    // Signed values must leave room for the sign bit.
+    auto needed_bits = is_signed ? bits + 1 : bits;
+    for (unsigned width : { 8, 16, 32 }) {
+      if (needed_bits <= width) {
+        return width;
+      }
+    }
+    return {};
+  }
+
+  static IntegerType &get_narrow_type(unsigned width, bool is_signed) {
+    switch (width) {
+      case 8:
+        return is_signed ? Type::get_i8_type() : Type::get_u8_type();
+      case 16:
+        return is_signed ? Type::get_i16_type() : Type::get_u16_type();
+      case 32:
+        return is_signed ? Type::get_i32_type() : Type::get_u32_type();
+      default:
+        MEMOIR_UNREACHABLE("Unsupported width for integer narrowing!");
+    }
+  }
+
+  // Returns the variant of the 64-bit access function @F with @width bits.
+  static llvm::Function *get_narrow_function(llvm::Function &F,
+                                             unsigned width) {
+    auto &M = MEMOIR_SANITIZE(F.getParent(), "Could not get function's module");
+    auto name = F.getName().str();
+
+    // Keep the arity suffix of the specialized index and assoc accesses.
+    std::regex width_re("_([ui])64(_[12]d)?$");
+    auto replacement = std::regex_replace(name,
+                                          width_re,
+                                          "_$1" + std::to_string(width) + "$2");
+    if (replacement == name) {
+      return nullptr;
+    }
+
+    return M.getFunction(replacement);
+  }
+
+  static llvm::Use &get_value_written_use(MemOIRInst &write) {
+    if (auto *write_inst = dyn_cast<WriteInst>(&write)) {
+      return write_inst->getValueWrittenAsUse();
+    } else if (auto *mut_write_inst = dyn_cast<MutWriteInst>(&write)) {
+      return mut_write_inst->getValueWrittenAsUse();
+    }
+    MEMOIR_UNREACHABLE("Instruction is not a write!");
+  }
+
+  // Computes the width that every value written by @writes fits in.
+  opt<unsigned> get_writes_width(const AccessListTy &writes, bool is_signed) {
+    if (writes.empty()) {
+      return {};
+    }
+
+    unsigned max_bits = 0;
+    for (auto *write : writes) {
+      auto bits = this->get_written_bits(get_value_written_use(*write));
+      if (!bits) {
+        return {};
+      }
+      max_bits = std::max(max_bits, *bits);
+    }
+
+    return get_narrow_width(max_bits, is_signed);
+  }
+
+  // Checks that the narrow variant of each access exists.
+  static bool has_narrow_functions(const AccessListTy &accesses,
+                                   unsigned width) {
+    for (auto *access : accesses) {
+      auto &function =
+          MEMOIR_SANITIZE(access->getCallInst().getCalledFunction(),
+                          "Access has no called function!");
+      if (get_narrow_function(function, width) == nullptr) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Rewrites the reads and writes to use their narrow variants.
+  static void narrow_accesses(const AccessListTy &reads,
+                              const AccessListTy &writes,
+                              unsigned width,
+                              bool is_signed) {
+    for (auto *read : reads) {
+      auto &call = read->getCallInst();
+      auto *narrow_function =
+          get_narrow_function(*call.getCalledFunction(), width);
+
+      MemOIRBuilder builder(&call);
+      vector<llvm::Value *> arguments(call.arg_begin(), call.arg_end());
+      auto *narrow_read = builder.CreateCall(narrow_function, arguments);
+      auto *extended =
+          is_signed ? builder.CreateSExt(narrow_read, call.getType())
+                    : builder.CreateZExt(narrow_read, call.getType());
+
+      call.replaceAllUsesWith(extended);
+      narrow_read->takeName(&call);
+      call.eraseFromParent();
+    }
+
+    for (auto *write : writes) {
+      auto &call = write->getCallInst();
+      auto *narrow_function =
+          get_narrow_function(*call.getCalledFunction(), width);
+
+      MemOIRBuilder builder(&call);
+      auto &value_use = get_value_written_use(*write);
+      auto *truncated =
+          builder.CreateTrunc(value_use.get(), builder.getIntNTy(width));
+      value_use.set(truncated);
+      call.setCalledFunction(narrow_function);
+    }
+  }
+
+  static bool is_wide_integer(Type &type) {
+    auto *int_type = dyn_cast<IntegerType>(&type);
+    return int_type != nullptr && int_type->getBitWidth() == 64;
+  }
+
+  // Struct field narrowing.
+  void analyze_struct_value(llvm::Value &V) {
+    if (!Type::value_is_struct_type(V)) {
+      return;
+    }
+
+    auto *struct_type = dyn_cast_or_null<StructType>(TypeAnalysis::analyze(V));
+    MEMOIR_NULL_CHECK(struct_type,
+                      "Could not determine the StructType of a struct value!");
+
+    if (value_escapes(V)) {
+      this->escaped_types.insert(struct_type);
+      return;
+    }
+
+    auto &fields = this->struct_fields[struct_type];
+    for (auto *user : V.users()) {
+      auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+      if (user_as_inst == nullptr) {
+        continue;
+      }
+
+      auto *memoir_inst = MemOIRInst::get(*user_as_inst);
+      if (memoir_inst == nullptr) {
+        continue;
+      }
+
+      if (auto *read = dyn_cast<StructReadInst>(memoir_inst)) {
+        if (&read->getObjectOperand() == &V) {
+          fields[read->getFieldIndex()].reads.push_back(read);
+        }
+      } else if (auto *write = dyn_cast<StructWriteInst>(memoir_inst)) {
+        if (&write->getObjectOperand() == &V) {
+          fields[write->getFieldIndex()].writes.push_back(write);
+        }
+      } else if (auto *mut_write = dyn_cast<MutStructWriteInst>(memoir_inst)) {
+        if (&mut_write->getObjectOperand() == &V) {
+          fields[mut_write->getFieldIndex()].writes.push_back(mut_write);
+        }
+      }
+    }
+  }
+
+  void analyze_structs() {
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      for (auto &A : F.args()) {
+        this->analyze_struct_value(A);
+      }
+
+      for (auto &BB : F) {
+        for (auto &I : BB) {
+          this->analyze_struct_value(I);
+        }
+      }
+    }
+  }
+
+  bool narrow_field(StructType &struct_type,
+                    unsigned field_index,
+                    FieldInfo &field_info) {
+    auto &field_type = struct_type.getFieldType(field_index);
+    if (!is_wide_integer(field_type)) {
+      return false;
+    }
+    auto is_signed = cast<IntegerType>(&field_type)->isSigned();
+
+    auto width = this->get_writes_width(field_info.writes, is_signed);
+    if (!width) {
+      return false;
+    }
+
+    if (!has_narrow_functions(field_info.reads, *width)
+        || !has_narrow_functions(field_info.writes, *width)) {
+      return false;
+    }
+
+    infoln("Narrowing ",
+           struct_type.getName(),
+           ".",
+           field_index,
+           " to ",
+           *width,
+           " bits");
+
+    // Update the type definition.
+    auto &definition = struct_type.getDefinition();
+    MemOIRBuilder builder(definition);
+    auto *narrow_type_inst =
+        builder.CreateTypeInst(get_narrow_type(*width, is_signed));
+    definition.getFieldTypeOperandAsUse(field_index)
+        .set(&narrow_type_inst->getCallInst());
+
+    narrow_accesses(field_info.reads, field_info.writes, *width, is_signed);
+
+    return true;
+  }
+
+  // Sequence narrowing.
+  bool narrow_sequence(SequenceAllocInst &seq_alloc) {
+    auto &element_type = seq_alloc.getElementType();
+    if (!is_wide_integer(element_type)) {
+      return false;
+    }
+    auto is_signed = cast<IntegerType>(&element_type)->isSigned();
+
+    // Gather the accesses to all versions of the sequence.
+    AccessListTy reads = {};
+    AccessListTy writes = {};
+    set<llvm::Value *> visited = {};
+    vector<llvm::Value *> worklist = { &seq_alloc.getCallInst() };
+    while (!worklist.empty()) {
+      auto *collection = worklist.back();
+      worklist.pop_back();
+
+      if (!visited.insert(collection).second) {
+        continue;
+      }
+
+      for (auto *user : collection->users()) {
+        if (auto *phi = dyn_cast<llvm::PHINode>(user)) {
+          worklist.push_back(phi);
+          continue;
+        }
+
+        auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+        if (user_as_inst == nullptr) {
+          return false;
+        }
+
+        auto *memoir_inst = MemOIRInst::get(*user_as_inst);
+        if (memoir_inst == nullptr) {
+          return false;
+        }
+
+        if (auto *read = dyn_cast<IndexReadInst>(memoir_inst)) {
+          if (&read->getObjectOperand() != collection) {
+            return false;
+          }
+          reads.push_back(read);
+        } else if (auto *write = dyn_cast<IndexWriteInst>(memoir_inst)) {
+          if (&write->getObjectOperand() != collection) {
+            return false;
+          }
+          writes.push_back(write);
+          worklist.push_back(&write->getCallInst());
+        } else if (auto *mut_write = dyn_cast<MutIndexWriteInst>(memoir_inst)) {
+          if (&mut_write->getObjectOperand() != collection) {
+            return false;
+          }
+          writes.push_back(mut_write);
+        } else if (auto *use_phi = dyn_cast<UsePHIInst>(memoir_inst)) {
+          worklist.push_back(&use_phi->getResultCollection());
+        } else if (auto *def_phi = dyn_cast<DefPHIInst>(memoir_inst)) {
+          worklist.push_back(&def_phi->getResultCollection());
+        } else if (isa<SizeInst>(memoir_inst)
+                   || isa<DeleteCollectionInst>(memoir_inst)) {
+          continue;
+        } else {
+          return false;
+        }
+      }
+    }
+
+    auto width = this->get_writes_width(writes, is_signed);
+    if (!width) {
+      return false;
+    }
+
+    if (!has_narrow_functions(reads, *width)
+        || !has_narrow_functions(writes, *width)) {
+      return false;
+    }
+
+    infoln("Narrowing ", seq_alloc.getCallInst(), " to ", *width, " bits");
+
+    // Update the element type of the allocation.
+    MemOIRBuilder builder(seq_alloc);
+    auto *narrow_type_inst =
+        builder.CreateTypeInst(get_narrow_type(*width, is_signed));
+    seq_alloc.getElementOperandAsUse().set(&narrow_type_inst->getCallInst());
+
+    narrow_accesses(reads, writes, *width, is_signed);
+
+    return true;
+  }
+
+  // Owned state.
+  map<llvm::Function *, RangeAnalysis *> range_analyses;
+  map<StructType *, map<unsigned, FieldInfo>> struct_fields;
+  StructTypeSetTy escaped_types;
+
+  // Borrowed state.
+  llvm::Module &M;
+  arcana::noelle::Noelle &noelle;
+};
+
+} // namespace llvm::memoir
+
+#endif
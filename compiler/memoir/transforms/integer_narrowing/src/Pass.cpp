@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/ir/InstVisitor.hpp"
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "IntegerNarrowing.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass narrows integer struct fields and sequence elements to the width
+ * of the values written to them.
+ */
+
+struct IntegerNarrowingPass : public ModulePass {
+  static char ID;
+
+  IntegerNarrowingPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    debugln("Running integer narrowing pass");
+    debugln();
+
+    auto &noelle = getAnalysis<arcana::noelle::Noelle>();
+
+    IntegerNarrowing IN(M, noelle);
+
+    // Narrowing changes the types of fields and elements, drop all cached
+    // types.
+    if (IN.transformed) {
+      TypeAnalysis::invalidate();
+    }
+
+    return IN.transformed;
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.addRequired<arcana::noelle::Noelle>();
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char IntegerNarrowingPass::ID = 0;
+static llvm::RegisterPass<IntegerNarrowingPass> X(
+    "memoir-narrow",
+    "Narrows integer fields and elements to the width of their values.");
+
+} // namespace llvm::memoir
@@ -23,7 +23,9 @@
 #include "memoir/ir/Builder.hpp"
 #include "memoir/ir/InstVisitor.hpp"
 #include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/MutOperations.hpp"
 
+#include "memoir/analysis/RangeAnalysis.hpp"
 #include "memoir/analysis/TypeAnalysis.hpp"
 
 #include "memoir/support/Assert.hpp"
@@ -37,6 +39,11 @@
  * This class folds the key-space of assoc collections onto the index-space of a
  * sequence when possible..
  *
+ * Assocs keyed by integers are folded onto a sequence of their own when every
+ * key is known to lie within a dense range [0, N). If the program queries the
+ * presence of keys, a sequence of bytes records which keys are present, with a
+ * version of it threaded alongside each version of the assoc.
+ *
  * Author(s): Tommy McMichen
  * Created: August 28, 2023
  */
@@ -48,26 +55,107 @@ class KeyFolding {
 public:
   bool transformed;
 
-  KeyFolding(llvm::Module &M) {
-    // Run dead collection elimination.
+  KeyFolding(llvm::Module &M,
+             arcana::noelle::Noelle &noelle,
+             uint64_t dense_key_limit)
+    : noelle(noelle),
+      dense_key_limit(dense_key_limit) {
+    // Run key folding.
     this->transformed = this->run(M);
   }
 
+  ~KeyFolding() {
+    for (auto const &[function, range_analysis] : this->range_analyses) {
+      delete range_analysis;
+    }
+  }
+
 protected:
   // Top-level driver.
   bool run(llvm::Module &M) {
+    this->summarize(M);
     return this->transform(this->analyze(M));
   }
 
   // Analysis Types.
   struct KeyFoldingInfo {
     map<AssocArrayAllocInst *, CollectionAllocInst *> key_folds;
-    map<AssocArrayAllocInst *, map<AccessInst *, llvm::Use *>> assoc_accesses;
+    map<AssocArrayAllocInst *, map<MemOIRInst *, llvm::Use *>> assoc_accesses;
     map<llvm::Use *, llvm::Value *> key_to_index;
+    map<AssocArrayAllocInst *, uint64_t> dense_folds;
+    map<AssocArrayAllocInst *, set<DeleteCollectionInst *>> assoc_deletions;
+    map<AssocArrayAllocInst *, set<llvm::Value *>> assoc_versions;
+    set<AssocArrayAllocInst *> needs_presence;
   };
 
+  // Call graph summaries.
+  struct FunctionSummary {
+    // The call sites that may call this function.
+    set<llvm::CallBase *> callers;
+    // The values that may be returned by this function.
+    set<llvm::Value *> returned_values;
+  };
+
+  // Summarizes the callers and returned values of each function, using the
+  // complete call graph to resolve indirect calls.
+  void summarize(llvm::Module &M) {
+    auto &call_graph = MEMOIR_SANITIZE(this->noelle.getProgramCallGraph(),
+                                       "NOELLE gave us a NULL call graph!");
+
+    for (auto &F : M) {
+      // Gather the values returned by the function.
+      auto &summary = this->summaries[&F];
+      for (auto &BB : F) {
+        auto *terminator = BB.getTerminator();
+        if (auto *return_inst = dyn_cast<llvm::ReturnInst>(terminator)) {
+          if (auto *return_value = return_inst->getReturnValue()) {
+            summary.returned_values.insert(return_value);
+          }
+        }
+      }
+
+      // Gather the callees of each call site in the function.
+      auto *node = call_graph.getFunctionNode(&F);
+      if (node == nullptr) {
+        continue;
+      }
+      for (auto *edge : call_graph.getOutgoingEdges(node)) {
+        auto *callee = edge->getCallee()->getFunction();
+        for (auto *sub_edge : edge->getSubEdges()) {
+          auto *caller_inst = sub_edge->getCaller()->getInstruction();
+          auto *call = dyn_cast_or_null<llvm::CallBase>(caller_inst);
+          if (call == nullptr) {
+            continue;
+          }
+          this->callees[call].insert(callee);
+          this->summaries[callee].callers.insert(call);
+        }
+      }
+    }
+  }
+
+  // Returns the functions that may be called by @call.
+  const set<llvm::Function *> &get_callees(llvm::CallBase &call) {
+    return this->callees[&call];
+  }
+
+  // Returns true if @call may call a function whose body we cannot see, or if
+  // we could not resolve its callees.
+  bool may_call_external(llvm::CallBase &call) {
+    auto &possible_callees = this->get_callees(call);
+    if (possible_callees.empty()) {
+      return true;
+    }
+    for (auto *callee : possible_callees) {
+      if (callee->empty()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
   // Analysis Helpers.
-  static inline bool value_escapes(llvm::Value &V) {
+  bool value_escapes(llvm::Value &V) {
     for (auto *user : V.users()) {
       if (auto *user_as_call = dyn_cast_or_null<llvm::CallBase>(user)) {
         // If the user is a memoir instruction, continue.
@@ -75,17 +163,8 @@ protected:
           continue;
         }
 
-        // Get the called function.
-        auto *called_function = user_as_call->getCalledFunction();
-
-        // If it is an indirect call, then the value escapes.
-        // TODO: improve this by using NOELLE's complete call graph
-        if (called_function == nullptr) {
-          return true;
-        }
-
-        // If it is empty, then the value escapes.
-        if (called_function->empty()) {
+        // If the call may reach a function we cannot see, the value escapes.
+        if (this->may_call_external(*user_as_call)) {
           return true;
         }
       }
@@ -94,56 +173,387 @@ protected:
     return false;
   }
 
-  static inline set<llvm::Value *> gather_returned_values(llvm::Function &F) {
-    set<llvm::Value *> returned_values = {};
+  const set<llvm::Value *> &gather_returned_values(llvm::Function &F) {
+    return this->summaries[&F].returned_values;
+  }
+
+  set<llvm::Value *> gather_possible_arguments(llvm::Argument &A) {
+    set<llvm::Value *> possible_arguments = {};
 
-    for (auto &BB : F) {
-      auto *terminator = BB.getTerminator();
-      if (auto *return_inst = dyn_cast<llvm::ReturnInst>(terminator)) {
-        auto *return_value = return_inst->getReturnValue();
-        returned_values.insert(return_value);
+    auto *arg_function = A.getParent();
+
+    // Stash the argument passed by each call site that may call the function.
+    for (auto *call : this->summaries[arg_function].callers) {
+      if (A.getArgNo() < call->arg_size()) {
+        auto *passed_argument = (call->arg_begin() + A.getArgNo())->get();
+        possible_arguments.insert(passed_argument);
       }
     }
 
-    return returned_values;
+    return possible_arguments;
   }
 
-  static inline set<llvm::Value *> gather_possible_arguments(
-      llvm::Module &M,
-      llvm::Argument &A) {
-    set<llvm::Value *> possible_arguments = {};
+  // Collects the key used by each access to the assoc allocated by @alloc,
+  // following each version of it through writes, PHIs and calls. Returns false
+  // if a version of the assoc has a use that cannot be folded.
+  bool gather_assoc_accesses(AssocArrayAllocInst &alloc,
+                             map<MemOIRInst *, llvm::Use *> &accesses,
+                             set<DeleteCollectionInst *> &deletions,
+                             set<llvm::Value *> &versions) {
+    vector<llvm::Value *> worklist = {};
+    worklist.push_back(&alloc.getCallInst());
+    while (!worklist.empty()) {
+      // Pop an item of the worklist.
+      auto *workitem = worklist.back();
+      worklist.pop_back();
+
+      // Check that this item hasn't been visited.
+      if (versions.find(workitem) != versions.end()) {
+        continue;
+      } else {
+        versions.insert(workitem);
+      }
 
-    auto *arg_function = A.getParent();
+      // Iterate over the uses of this item.
+      for (auto &use : workitem->uses()) {
+        auto *user = use.getUser();
 
-    for (auto &F : M) {
-      for (auto &BB : F) {
-        for (auto &I : BB) {
-          if (auto *call = dyn_cast<llvm::CallBase>(&I)) {
-            // If this is a direct call, check if it calls the function we care
-            // about. If it does, stash the passed argument.
-            if (auto *called_function = call->getCalledFunction()) {
-              if (called_function == &F) {
-                auto *passed_argument =
-                    (call->arg_begin() + A.getArgNo())->get();
-                possible_arguments.insert(passed_argument);
-              }
+        // Check that the user is an instruction. If not skip it.
+        auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+        if (user_as_inst == nullptr) {
+          continue;
+        }
+
+        // Handle memoir instructions.
+        if (auto *user_as_memoir = MemOIRInst::get(*user_as_inst)) {
+          // If this is an assoc access instruction, fetch the key used to
+          // access and stash them. Writes, inserts and removes define a new
+          // version of the assoc, which we iterate on.
+          if (auto *assoc_read = dyn_cast<AssocReadInst>(user_as_memoir)) {
+            accesses[assoc_read] = &assoc_read->getKeyOperandAsUse();
+          } else if (auto *assoc_write =
+                         dyn_cast<AssocWriteInst>(user_as_memoir)) {
+            if (&use != &assoc_write->getObjectOperandAsUse()) {
+              return false;
             }
-            // Otherwise, this is an indirect call. Check if it _may_ call the
-            // function, if so, stash the passed argument.
-            else {
-              auto *function_type = call->getFunctionType();
-              if (function_type == F.getFunctionType()) {
-                auto *passed_argument =
-                    (call->arg_begin() + A.getArgNo())->get();
-                possible_arguments.insert(passed_argument);
-              }
+            accesses[assoc_write] = &assoc_write->getKeyOperandAsUse();
+            worklist.push_back(&assoc_write->getCallInst());
+          } else if (auto *assoc_get = dyn_cast<AssocGetInst>(user_as_memoir)) {
+            accesses[assoc_get] = &assoc_get->getKeyOperandAsUse();
+          } else if (auto *mut_assoc_write =
+                         dyn_cast<MutAssocWriteInst>(user_as_memoir)) {
+            if (&use != &mut_assoc_write->getObjectOperandAsUse()) {
+              return false;
             }
+            accesses[mut_assoc_write] = &mut_assoc_write->getKeyOperandAsUse();
+          } else if (auto *assoc_has = dyn_cast<AssocHasInst>(user_as_memoir)) {
+            accesses[assoc_has] = &assoc_has->getKeyOperandAsUse();
+          } else if (auto *assoc_insert =
+                         dyn_cast<AssocInsertInst>(user_as_memoir)) {
+            accesses[assoc_insert] = &assoc_insert->getInsertionPointAsUse();
+            worklist.push_back(&assoc_insert->getCallInst());
+          } else if (auto *assoc_remove =
+                         dyn_cast<AssocRemoveInst>(user_as_memoir)) {
+            accesses[assoc_remove] = &assoc_remove->getKeyAsUse();
+            worklist.push_back(&assoc_remove->getCallInst());
+          } else if (auto *delete_inst =
+                         dyn_cast<DeleteCollectionInst>(user_as_memoir)) {
+            deletions.insert(delete_inst);
+          }
+
+          // If this is a Use/Def/Arg/RetPHI, iterate on its resultant.
+          else if (auto *use_phi = dyn_cast<UsePHIInst>(user_as_memoir)) {
+            worklist.push_back(&use_phi->getCallInst());
+          } else if (auto *def_phi = dyn_cast<DefPHIInst>(user_as_memoir)) {
+            worklist.push_back(&def_phi->getCallInst());
+          } else if (auto *arg_phi = dyn_cast<ArgPHIInst>(user_as_memoir)) {
+            worklist.push_back(&arg_phi->getCallInst());
+          } else if (auto *ret_phi = dyn_cast<RetPHIInst>(user_as_memoir)) {
+            worklist.push_back(&ret_phi->getCallInst());
           }
+
+          // Type assertions carry no state.
+          else if (isa<AssertCollectionTypeInst>(user_as_memoir)) {
+            continue;
+          }
+
+          // Any other use, such as the size or keys of the assoc, has no
+          // counterpart on a sequence. The pass runs on SSA form, so the
+          // mutable insert and remove are not handled either.
+          else {
+            return false;
+          }
+
+          continue;
+        }
+
+        // Handle PHI Nodes, iterating on the resultant.
+        if (auto *use_as_phi = dyn_cast<llvm::PHINode>(user_as_inst)) {
+          worklist.push_back(use_as_phi);
+        }
+
+        // Handle call instructions, iterating on the argument corresponding
+        // to this use.
+        else if (auto *user_as_call = dyn_cast<llvm::CallBase>(user_as_inst)) {
+          // If the assoc is passed to a function we cannot see, we cannot
+          // find all its uses.
+          if (!user_as_call->isArgOperand(&use)
+              || this->may_call_external(*user_as_call)) {
+            return false;
+          }
+
+          // Iterate on the argument of each function that _may_ be called,
+          // as resolved by the call graph.
+          auto argument_number = user_as_call->getArgOperandNo(&use);
+          for (auto *callee : this->get_callees(*user_as_call)) {
+            if (argument_number >= callee->arg_size()) {
+              return false;
+            }
+            worklist.push_back(callee->arg_begin() + argument_number);
+          }
+        }
+
+        // Otherwise, the assoc is returned, stored or used in a way we cannot
+        // follow, so we cannot find all its uses.
+        else {
+          return false;
         }
       }
     }
 
-    return possible_arguments;
+    // Every value merged into a version must itself be a version, otherwise
+    // folding would merge a sequence with an assoc.
+    for (auto *version : versions) {
+      if (auto *phi = dyn_cast<llvm::PHINode>(version)) {
+        for (auto &incoming : phi->incoming_values()) {
+          if (versions.count(incoming.get()) == 0) {
+            return false;
+          }
+        }
+      } else if (auto *arg = dyn_cast<llvm::Argument>(version)) {
+        for (auto *passed : this->gather_possible_arguments(*arg)) {
+          if (versions.count(passed) == 0) {
+            return false;
+          }
+        }
+      }
+    }
+
+    return true;
+  }
+
+  static bool is_presence_operation(MemOIRInst &I) {
+    return isa<AssocHasInst>(&I) || isa<AssocInsertInst>(&I)
+           || isa<AssocRemoveInst>(&I);
+  }
+
+  static bool has_presence_operations(
+      const map<MemOIRInst *, llvm::Use *> &accesses) {
+    for (auto const &[access, key_use] : accesses) {
+      if (is_presence_operation(*access)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  RangeAnalysis &get_range_analysis(llvm::Function &F) {
+    auto found = this->range_analyses.find(&F);
+    if (found != this->range_analyses.end()) {
+      return *(found->second);
+    }
+
+    auto *range_analysis = new RangeAnalysis(F, this->noelle);
+    this->range_analyses[&F] = range_analysis;
+    return *range_analysis;
+  }
+
+  static opt<uint64_t> get_constant(ValueExpression &expr) {
+    auto *constant_expr = dyn_cast<ConstantExpression>(&expr);
+    if (constant_expr == nullptr) {
+      return {};
+    }
+
+    auto *constant_int =
+        dyn_cast<llvm::ConstantInt>(&constant_expr->getConstant());
+    if (constant_int == nullptr || constant_int->isNegative()
+        || constant_int->getValue().getActiveBits() > 63) {
+      return {};
+    }
+
+    return constant_int->getZExtValue();
+  }
+
+  // Returns an exclusive upper bound on the value of @V, if it is known to be
+  // non-negative, from the instructions that compute it.
+  static opt<uint64_t> get_value_bound(llvm::Value &V,
+                                       set<llvm::Value *> &visited) {
+    if (auto *constant_int = dyn_cast<llvm::ConstantInt>(&V)) {
+      if (constant_int->isNegative()
+          || constant_int->getValue().getActiveBits() > 63) {
+        return {};
+      }
+      return constant_int->getZExtValue() + 1;
+    }
+
+    // Cyclic values are not bounded.
+    if (visited.count(&V) > 0) {
+      return {};
+    }
+    visited.insert(&V);
+
+    if (auto *zext = dyn_cast<llvm::ZExtInst>(&V)) {
+      // Prefer the bound of the extended value. The width of the source type
+      // only bounds it loosely, so we only fall back to it for bytes.
+      if (auto bound = get_value_bound(*zext->getOperand(0), visited)) {
+        return bound;
+      }
+      auto source_bits = zext->getSrcTy()->getIntegerBitWidth();
+      if (source_bits <= 8) {
+        return uint64_t(1) << source_bits;
+      }
+      return {};
+    } else if (auto *binary_op = dyn_cast<llvm::BinaryOperator>(&V)) {
+      auto *lhs = binary_op->getOperand(0);
+      auto *rhs = binary_op->getOperand(1);
+      switch (binary_op->getOpcode()) {
+        case llvm::Instruction::And: {
+          // Masking with a non-negative value bounds the result by the mask.
+          auto lhs_bound = get_value_bound(*lhs, visited);
+          auto rhs_bound = get_value_bound(*rhs, visited);
+          if (lhs_bound && rhs_bound) {
+            return std::min(*lhs_bound, *rhs_bound);
+          } else if (isa<llvm::ConstantInt>(rhs)) {
+            return rhs_bound;
+          } else if (isa<llvm::ConstantInt>(lhs)) {
+            return lhs_bound;
+          }
+          return {};
+        }
+        case llvm::Instruction::URem: {
+          if (auto *divisor = dyn_cast<llvm::ConstantInt>(rhs)) {
+            if (!divisor->isZero()
+                && divisor->getValue().getActiveBits() <= 63) {
+              return divisor->getZExtValue();
+            }
+          }
+          return {};
+        }
+        default:
+          return {};
+      }
+    } else if (auto *select = dyn_cast<llvm::SelectInst>(&V)) {
+      auto true_bound = get_value_bound(*select->getTrueValue(), visited);
+      auto false_bound = get_value_bound(*select->getFalseValue(), visited);
+      if (true_bound && false_bound) {
+        return std::max(*true_bound, *false_bound);
+      }
+      return {};
+    } else if (auto *phi = dyn_cast<llvm::PHINode>(&V)) {
+      uint64_t bound = 0;
+      for (auto &incoming : phi->incoming_values()) {
+        auto incoming_bound = get_value_bound(*incoming.get(), visited);
+        if (!incoming_bound) {
+          return {};
+        }
+        bound = std::max(bound, *incoming_bound);
+      }
+      return bound;
+    }
+
+    return {};
+  }
+
+  // Returns an exclusive upper bound on the key at @key_use, if it is known to
+  // be non-negative.
+  opt<uint64_t> get_key_bound(llvm::Use &key_use) {
+    // Use the value range of the key, if its bounds are constant. The upper
+    // bound may be inclusive, so we leave room for it.
+    auto *user = dyn_cast<llvm::Instruction>(key_use.getUser());
+    if (user != nullptr) {
+      auto &function = MEMOIR_SANITIZE(user->getFunction(),
+                                       "Key is used outside of a function!");
+      auto &range_analysis = this->get_range_analysis(function);
+      if (auto *range = range_analysis.find_value_range(key_use)) {
+        auto lower = get_constant(range->get_lower());
+        auto upper = get_constant(range->get_upper());
+        if (lower && upper) {
+          return *upper + 1;
+        }
+      }
+    }
+
+    // Otherwise, bound the key by the instructions that compute it.
+    set<llvm::Value *> visited = {};
+    return get_value_bound(*key_use.get(), visited);
+  }
+
+  // Records the integer-keyed assoc @alloc for folding if all of its keys lie
+  // within a dense range.
+  void analyze_dense_keys(AssocArrayAllocInst &alloc, KeyFoldingInfo &info) {
+    auto &accesses = info.assoc_accesses[&alloc];
+
+    auto *alloc_function = alloc.getCallInst().getFunction();
+
+    // Find the size of the key space.
+    uint64_t key_space = 0;
+    bool needs_presence = false;
+    bool has_mutable_writes = false;
+    bool has_removes = false;
+    bool has_remote_accesses = false;
+    for (auto const &[access, key_use] : accesses) {
+      auto bound = this->get_key_bound(*key_use);
+      if (!bound) {
+        debugln("  key is not bounded: ", *key_use->get());
+        return;
+      }
+      key_space = std::max(key_space, *bound);
+
+      needs_presence |= is_presence_operation(*access);
+      has_mutable_writes |= isa<MutAssocWriteInst>(access);
+      has_removes |= isa<AssocRemoveInst>(access);
+
+      has_remote_accesses |=
+          (access->getCallInst().getFunction() != alloc_function);
+    }
+
+    if (key_space == 0 || key_space > this->dense_key_limit) {
+      debugln("  key space of ", key_space, " is not dense");
+      return;
+    }
+
+    // We thread the versions of the presence sequence alongside the versions
+    // of the assoc in the allocating function, so every access and deletion
+    // must be there, and no version may enter it as an argument.
+    if (needs_presence) {
+      for (auto *delete_inst : info.assoc_deletions[&alloc]) {
+        has_remote_accesses |=
+            (delete_inst->getCallInst().getFunction() != alloc_function);
+      }
+      for (auto *version : info.assoc_versions[&alloc]) {
+        auto *arg = dyn_cast<llvm::Argument>(version);
+        has_remote_accesses |= (arg != nullptr
+                                && arg->getParent() == alloc_function);
+      }
+    }
+    if (needs_presence && (has_mutable_writes || has_remote_accesses)) {
+      debugln("  cannot track key presence, skipping.");
+      return;
+    }
+
+    // Removing a key resets its value, which must be a primitive.
+    auto &value_type = alloc.getValueType();
+    if (has_removes
+        && !(isa<IntegerType>(&value_type) || isa<FloatType>(&value_type)
+             || isa<DoubleType>(&value_type))) {
+      debugln("  cannot reset the value of removed keys, skipping.");
+      return;
+    }
+
+    info.dense_folds[&alloc] = key_space;
+    if (needs_presence) {
+      info.needs_presence.insert(&alloc);
+    }
   }
 
   // Analysis Driver.
@@ -206,8 +616,27 @@ protected:
     for (auto const &[assoc_alloc, assoc_type] : assoc_allocations) {
       debugln("Visiting ", *assoc_alloc);
 
-      // Check that the assoc type has a reference type for its key.
+      // Inspect each access to this collection, recording the source of their
+      // key value for each.
+      auto &assoc_alloc_accesses = assoc_accesses[assoc_alloc];
+      auto &assoc_alloc_deletions = info.assoc_deletions[assoc_alloc];
+      auto &assoc_alloc_versions = info.assoc_versions[assoc_alloc];
+      if (!this->gather_assoc_accesses(*assoc_alloc,
+                                       assoc_alloc_accesses,
+                                       assoc_alloc_deletions,
+                                       assoc_alloc_versions)) {
+        debugln("  assoc has an unhandled use");
+        continue;
+      }
+
+      // If the key is an integer, try to fold it onto a dense sequence.
       auto &key_type = assoc_type->getKeyType();
+      if (isa<IntegerType>(&key_type)) {
+        this->analyze_dense_keys(*assoc_alloc, info);
+        continue;
+      }
+
+      // Check that the assoc type has a reference type for its key.
       auto *key_ref_type = dyn_cast<ReferenceType>(&key_type);
       if (key_ref_type == nullptr) {
         debugln("  key is not a reference");
@@ -220,100 +649,10 @@ protected:
         continue;
       }
 
-      // Get the LLVM representation of the assoc alloc.
-      auto &llvm_assoc_alloc = assoc_alloc->getCallInst();
-
-      // Inspect each access to this collection, recording the source of their
-      // key value for each.
-      auto &assoc_alloc_accesses = assoc_accesses[assoc_alloc];
-
-      set<llvm::Value *> visited = {};
-      vector<llvm::Value *> worklist = {};
-      worklist.push_back(&llvm_assoc_alloc);
-      while (!worklist.empty()) {
-        // Pop an item of the worklist.
-        auto *workitem = worklist.back();
-        worklist.pop_back();
-
-        // Check that this item hasn't been visited.
-        if (visited.find(workitem) != visited.end()) {
-          continue;
-        } else {
-          visited.insert(workitem);
-        }
-
-        // Iterate over the uses of this item.
-        for (auto &use : workitem->uses()) {
-          auto *user = use.getUser();
-
-          // Check that the user is an instruction. If not skip it.
-          auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
-          if (user_as_inst == nullptr) {
-            continue;
-          }
-
-          // Handle memoir instructions.
-          if (auto *user_as_memoir = MemOIRInst::get(*user_as_inst)) {
-            // If this is an assoc access instruction, fetch the key used to
-            // access and stash them.
-            if (auto *assoc_read = dyn_cast<AssocReadInst>(user_as_memoir)) {
-              auto &key_use = assoc_read->getKeyOperandAsUse();
-              assoc_alloc_accesses[assoc_read] = &key_use;
-            } else if (auto *assoc_write =
-                           dyn_cast<AssocWriteInst>(user_as_memoir)) {
-              auto &key_use = assoc_write->getKeyOperandAsUse();
-              assoc_alloc_accesses[assoc_write] = &key_use;
-            } else if (auto *assoc_get =
-                           dyn_cast<AssocGetInst>(user_as_memoir)) {
-              auto &key_use = assoc_get->getKeyOperandAsUse();
-              assoc_alloc_accesses[assoc_get] = &key_use;
-            }
-
-            // If this is a Use/DefPHI, iterate on its resultant.
-            else if (auto *use_phi = dyn_cast<UsePHIInst>(user_as_memoir)) {
-              worklist.push_back(&use_phi->getCallInst());
-            } else if (auto *def_phi = dyn_cast<DefPHIInst>(user_as_memoir)) {
-              worklist.push_back(&def_phi->getCallInst());
-            }
-          }
-
-          // Handle PHI Nodes, iterating on the resultant.
-          if (auto *use_as_phi = dyn_cast<llvm::PHINode>(user_as_inst)) {
-            worklist.push_back(use_as_phi);
-          }
-
-          // Handle call instructions, iterating on the argument corresponding
-          // to this use.
-          if (auto *user_as_call = dyn_cast<llvm::CallBase>(user_as_inst)) {
-            auto argument_number = use.getOperandNo();
-
-            // Fetch the called function, if this is a direct call, handle it.
-            auto *called_function = user_as_call->getCalledFunction();
-            if (called_function != nullptr) {
-              auto *argument = called_function->arg_begin() + argument_number;
-              worklist.push_back(argument);
-              continue;
-            }
-
-            // If this is an indirect call, conservatively grab every function
-            // that _may_ be called.
-            auto *function_type = user_as_call->getFunctionType();
-            MEMOIR_NULL_CHECK(function_type,
-                              "CallBase has NULL function type!");
-            for (auto &F : M) {
-              auto *other_function_type = F.getFunctionType();
-
-              // If this function _could_ be called (becuase it shares a
-              // function type with the call), grab its argument and add it to
-              // the worklist.
-              if (other_function_type == function_type) {
-                auto *argument = F.arg_begin() + argument_number;
-                worklist.push_back(argument);
-                continue;
-              }
-            }
-          }
-        }
+      // Presence queries have no counterpart on the folded sequence.
+      if (has_presence_operations(assoc_alloc_accesses)) {
+        debugln("  key presence is queried, skipping.");
+        continue;
       }
 
       // Next, we will check each of the keys used to access this collection to
@@ -380,8 +719,8 @@ protected:
 
       // Check that all collections accessed _must_ be the same allocation.
       set<CollectionAllocInst *> collections_referenced = {};
-      visited.clear();
-      worklist.clear();
+      set<llvm::Value *> visited = {};
+      vector<llvm::Value *> worklist = {};
       worklist.insert(worklist.end(),
                       collections_accessed.begin(),
                       collections_accessed.end());
@@ -428,41 +767,24 @@ protected:
               worklist.push_back(incoming);
             }
           } else if (auto *call = dyn_cast<llvm::CallBase>(inst)) {
-            // Round up all the possible callees and iterate on their returns.
+            // If the call may reach a function we cannot see, we do not know
+            // what it returns.
+            if (this->may_call_external(*call)) {
+              collections_referenced.insert(nullptr);
+              continue;
+            }
 
-            // Fetch the called function, if this is a direct call, handle it.
-            auto *called_function = call->getCalledFunction();
-            if (called_function != nullptr) {
-              auto returned_values = gather_returned_values(*called_function);
+            // Round up all the possible callees and iterate on their returns.
+            for (auto *callee : this->get_callees(*call)) {
+              auto &returned_values = this->gather_returned_values(*callee);
               worklist.insert(worklist.end(),
                               returned_values.begin(),
                               returned_values.end());
-              continue;
-            }
-
-            // If this is an indirect call, conservatively grab every function
-            // that _may_ be called.
-            auto *function_type = call->getFunctionType();
-            MEMOIR_NULL_CHECK(function_type,
-                              "CallBase has NULL function type!");
-            for (auto &F : M) {
-              auto *other_function_type = F.getFunctionType();
-
-              // If this function _could_ be called (becuase it shares a
-              // function type with the call), grab its argument and add it to
-              // the worklist.
-              if (other_function_type == function_type) {
-                auto returned_values = gather_returned_values(F);
-                worklist.insert(worklist.end(),
-                                returned_values.begin(),
-                                returned_values.end());
-                continue;
-              }
             }
           }
         } else if (auto *arg = dyn_cast<llvm::Argument>(workitem)) {
           // Round up all the possible callers and iterate on their arguments.
-          auto possible_arguments = gather_possible_arguments(M, *arg);
+          auto possible_arguments = this->gather_possible_arguments(*arg);
           worklist.insert(worklist.end(),
                           possible_arguments.begin(),
                           possible_arguments.end());
@@ -508,15 +830,263 @@ protected:
     auto name = F.getName().str();
 
     // Replace assoc with index.
-    // "memoir__assoc"
-    auto suffix = name.substr(13);
-    auto replacement = "memoir__index" + suffix;
+    // "memoir__assoc_" or "mut__assoc_"
+    std::string assoc_infix = "__assoc_";
+    auto assoc_pos = name.find(assoc_infix);
+    MEMOIR_ASSERT((assoc_pos != std::string::npos),
+                  "Access function is not an assoc operation!");
+    auto replacement = name.substr(0, assoc_pos) + "__index_"
+                       + name.substr(assoc_pos + assoc_infix.size());
     debugln("index function is ", replacement);
 
     // Get this function from the module.
     return M.getFunction(replacement);
   }
 
+  // Returns the value of a removed key, which is the same as that of a key
+  // that was never written.
+  static llvm::Constant &get_default_value(llvm::LLVMContext &C, Type &type) {
+    if (auto *integer_type = dyn_cast<IntegerType>(&type)) {
+      auto *llvm_type = llvm::IntegerType::get(C, integer_type->getBitWidth());
+      return *llvm::ConstantInt::get(llvm_type, 0);
+    } else if (isa<FloatType>(&type)) {
+      return *llvm::ConstantFP::get(llvm::Type::getFloatTy(C), 0.0);
+    } else if (isa<DoubleType>(&type)) {
+      return *llvm::ConstantFP::get(llvm::Type::getDoubleTy(C), 0.0);
+    }
+    MEMOIR_UNREACHABLE("No default value for the given type!");
+  }
+
+  // Returns the version of the presence sequence that corresponds to the
+  // version @V of the assoc, marking the key present or absent where the assoc
+  // is written, inserted into or removed from.
+  static llvm::Value &get_presence_version(
+      llvm::Value &V,
+      map<llvm::Value *, llvm::Value *> &presence_versions) {
+    auto found = presence_versions.find(&V);
+    if (found != presence_versions.end()) {
+      return *(found->second);
+    }
+
+    auto &inst = MEMOIR_SANITIZE(dyn_cast<llvm::Instruction>(&V),
+                                 "Version of the assoc is not an instruction!");
+    auto &memoir_inst =
+        MEMOIR_SANITIZE(MemOIRInst::get(inst),
+                        "Version of the assoc is not a MEMOIR instruction!");
+
+    // Marks the key at @key_use present or absent in the version of the
+    // presence sequence that corresponds to @base.
+    auto &presence_type = Type::get_u8_type();
+    auto mark = [&](llvm::Value &base, llvm::Use &key_use, bool present) {
+      MemOIRBuilder builder(memoir_inst);
+      auto *index =
+          builder.CreateZExtOrTrunc(key_use.get(), builder.getInt64Ty());
+      auto *byte = builder.getInt8(present ? 1 : 0);
+      auto &base_presence = get_presence_version(base, presence_versions);
+      return &builder
+                  .CreateIndexWriteInst(presence_type,
+                                        byte,
+                                        &base_presence,
+                                        index,
+                                        "folded.present.")
+                  ->getCallInst();
+    };
+
+    llvm::Value *presence_version = nullptr;
+    if (auto *write = dyn_cast<AssocWriteInst>(&memoir_inst)) {
+      presence_version = mark(write->getObjectOperand(),
+                              write->getKeyOperandAsUse(),
+                              /* present = */ true);
+    } else if (auto *insert = dyn_cast<AssocInsertInst>(&memoir_inst)) {
+      presence_version = mark(insert->getBaseCollection(),
+                              insert->getInsertionPointAsUse(),
+                              /* present = */ true);
+    } else if (auto *remove = dyn_cast<AssocRemoveInst>(&memoir_inst)) {
+      presence_version = mark(remove->getBaseCollection(),
+                              remove->getKeyAsUse(),
+                              /* present = */ false);
+    } else if (auto *use_phi = dyn_cast<UsePHIInst>(&memoir_inst)) {
+      presence_version = &get_presence_version(use_phi->getUsedCollection(),
+                                               presence_versions);
+    } else if (auto *def_phi = dyn_cast<DefPHIInst>(&memoir_inst)) {
+      presence_version = &get_presence_version(def_phi->getDefinedCollection(),
+                                               presence_versions);
+    } else if (auto *arg_phi = dyn_cast<ArgPHIInst>(&memoir_inst)) {
+      presence_version = &get_presence_version(arg_phi->getInputCollection(),
+                                               presence_versions);
+    } else if (auto *ret_phi = dyn_cast<RetPHIInst>(&memoir_inst)) {
+      presence_version = &get_presence_version(ret_phi->getInputCollection(),
+                                               presence_versions);
+    } else {
+      MEMOIR_UNREACHABLE("Unhandled version of the assoc!");
+    }
+
+    presence_versions[&V] = presence_version;
+    return *presence_version;
+  }
+
+  // Threads a version of the presence sequence @presence alongside each
+  // version of the assoc @alloc in its function.
+  static map<llvm::Value *, llvm::Value *> thread_presence(
+      AssocArrayAllocInst &alloc,
+      llvm::Value &presence,
+      const set<llvm::Value *> &versions) {
+    auto *function = alloc.getCallInst().getFunction();
+
+    map<llvm::Value *, llvm::Value *> presence_versions = {};
+    presence_versions[&alloc.getCallInst()] = &presence;
+
+    // Create the PHIs first, since the versions may be cyclic.
+    vector<llvm::PHINode *> phis = {};
+    for (auto *version : versions) {
+      auto *phi = dyn_cast<llvm::PHINode>(version);
+      if (phi == nullptr || phi->getFunction() != function) {
+        continue;
+      }
+      auto *presence_phi = llvm::PHINode::Create(presence.getType(),
+                                                 phi->getNumIncomingValues(),
+                                                 "folded.present.",
+                                                 phi);
+      presence_versions[phi] = presence_phi;
+      phis.push_back(phi);
+    }
+
+    // Thread the presence through the remaining versions.
+    for (auto *version : versions) {
+      auto *inst = dyn_cast<llvm::Instruction>(version);
+      if (inst != nullptr && inst->getFunction() == function) {
+        get_presence_version(*inst, presence_versions);
+      }
+    }
+
+    // Connect the PHIs.
+    for (auto *phi : phis) {
+      auto *presence_phi = cast<llvm::PHINode>(presence_versions[phi]);
+      for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+        auto &incoming = get_presence_version(*phi->getIncomingValue(i),
+                                              presence_versions);
+        presence_phi->addIncoming(&incoming, phi->getIncomingBlock(i));
+      }
+    }
+
+    return presence_versions;
+  }
+
+  // Folds the integer-keyed assoc @assoc_alloc onto a sequence of
+  // @key_space elements, indexed by the key.
+  void fold_dense_keys(AssocArrayAllocInst &assoc_alloc,
+                       uint64_t key_space,
+                       bool needs_presence,
+                       KeyFoldingInfo &info,
+                       set<llvm::Instruction *> &instructions_to_delete) {
+    // Build the new sequence allocation, the value operand _will_ be
+    // available, because we are inserting immediately before the existing
+    // allocation.
+    MemOIRBuilder builder(assoc_alloc);
+    auto &elem_type = assoc_alloc.getValueOperand();
+    auto *folded_sequence =
+        builder.CreateSequenceAllocInst(&elem_type, key_space, "folded.");
+
+    // Build the presence sequence, if needed. It holds a byte per key, since
+    // the sequence backends do not support packed booleans.
+    auto &presence_type = Type::get_u8_type();
+    auto *absent_byte = builder.getInt8(0);
+    auto &accesses = info.assoc_accesses[&assoc_alloc];
+    map<MemOIRInst *, llvm::Value *> presence_queried = {};
+    if (needs_presence) {
+      auto &presence = builder
+                           .CreateSequenceAllocInst(presence_type,
+                                                    key_space,
+                                                    "folded.present.")
+                           ->getCallInst();
+
+      // Thread the presence sequence through each version of the assoc. This
+      // must happen before the versions are rewritten.
+      auto presence_versions =
+          thread_presence(assoc_alloc,
+                          presence,
+                          info.assoc_versions[&assoc_alloc]);
+
+      // Find the version of the presence sequence each query reads.
+      for (auto const &[access, key_use] : accesses) {
+        if (auto *assoc_has = dyn_cast<AssocHasInst>(access)) {
+          presence_queried[access] =
+              presence_versions[&assoc_has->getObjectOperand()];
+        }
+      }
+
+      // Delete the presence sequence along with the folded sequence.
+      for (auto *delete_inst : info.assoc_deletions[&assoc_alloc]) {
+        MemOIRBuilder delete_builder(*delete_inst);
+        delete_builder.CreateDeleteCollectionInst(
+            presence_versions[&delete_inst->getDeletedCollection()]);
+      }
+    }
+
+    // Replace the assoc allocation with the folded one.
+    assoc_alloc.getCallInst().replaceAllUsesWith(
+        &folded_sequence->getCallInst());
+
+    // Mark the old allocation for cleanup.
+    instructions_to_delete.insert(&assoc_alloc.getCallInst());
+
+    // For each access, convert it to be an indexed access using the key.
+    auto &value_type = assoc_alloc.getValueType();
+    for (auto const &[access, key_use] : accesses) {
+      auto &access_call = access->getCallInst();
+      MemOIRBuilder access_builder(*access);
+
+      // Convert the key to an index.
+      auto *index =
+          access_builder.CreateZExtOrTrunc(key_use->get(),
+                                           access_builder.getInt64Ty());
+
+      if (isa<AssocHasInst>(access)) {
+        // Read the presence of the key.
+        auto *present =
+            access_builder.CreateIndexReadInst(presence_type,
+                                               presence_queried[access],
+                                               index);
+        auto *is_present =
+            access_builder.CreateICmpNE(&present->getCallInst(), absent_byte);
+        auto *result =
+            access_builder.CreateZExtOrTrunc(is_present, access_call.getType());
+        access_call.replaceAllUsesWith(result);
+        instructions_to_delete.insert(&access_call);
+      } else if (auto *insert = dyn_cast<AssocInsertInst>(access)) {
+        // Inserted keys hold the default value, which absent keys already do,
+        // so the folded sequence is unchanged.
+        access_call.replaceAllUsesWith(&insert->getBaseCollection());
+        instructions_to_delete.insert(&access_call);
+      } else if (auto *remove = dyn_cast<AssocRemoveInst>(access)) {
+        // Reset the value of removed keys, so they can be inserted again.
+        auto &default_value =
+            get_default_value(access_call.getContext(), value_type);
+        auto *reset =
+            access_builder.CreateIndexWriteInst(value_type,
+                                                &default_value,
+                                                &remove->getBaseCollection(),
+                                                index,
+                                                "folded.");
+        access_call.replaceAllUsesWith(&reset->getCallInst());
+        instructions_to_delete.insert(&access_call);
+      } else {
+        // Get the index variant of this function.
+        auto *access_function = access_call.getCalledFunction();
+        MEMOIR_NULL_CHECK(access_function, "Access function is NULL!");
+        auto *replacement_function = get_index_function(*access_function);
+        MEMOIR_NULL_CHECK(replacement_function,
+                          "Couldn't get the index function");
+
+        // Replace the called function and the key.
+        access_call.setCalledFunction(replacement_function);
+        key_use->set(index);
+      }
+    }
+
+    infoln("Folded ", assoc_alloc, " onto ", key_space, " dense keys");
+  }
+
   // Transformation driver.
   bool transform(KeyFoldingInfo info) {
     auto &key_folds = info.key_folds;
@@ -529,6 +1099,17 @@ protected:
     // Stash for any instructions that will be removed by the transformation.
     set<llvm::Instruction *> instructions_to_delete = {};
 
+    // Fold the dense integer keys.
+    for (auto const &[assoc_alloc, key_space] : info.dense_folds) {
+      auto needs_presence = (info.needs_presence.count(assoc_alloc) > 0);
+      this->fold_dense_keys(*assoc_alloc,
+                            key_space,
+                            needs_presence,
+                            info,
+                            instructions_to_delete);
+      transformed = true;
+    }
+
     // For key-fold pair.
     for (auto const &[assoc_alloc, collection_alloc] : key_folds) {
       if (auto *seq_alloc = dyn_cast<SequenceAllocInst>(collection_alloc)) {
@@ -648,6 +1229,17 @@ protected:
     // Return, true if the program was transformed, false otherwise.
     return transformed;
   }
+
+  // Owned state.
+  map<llvm::Function *, RangeAnalysis *> range_analyses;
+  map<llvm::Function *, FunctionSummary> summaries;
+  map<llvm::CallBase *, set<llvm::Function *>> callees;
+
+  // Borrowed state.
+  arcana::noelle::Noelle &noelle;
+
+  // Configuration.
+  uint64_t dense_key_limit;
 }; // namespace llvm::memoir
 
 } // namespace llvm::memoir
@@ -11,10 +11,15 @@
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
 // MemOIR
 #include "memoir/ir/InstVisitor.hpp"
 #include "memoir/ir/Instructions.hpp"
 
+#include "memoir/analysis/TypeAnalysis.hpp"
+
 #include "memoir/support/Assert.hpp"
 #include "memoir/support/InternalDatatypes.hpp"
 #include "memoir/support/Print.hpp"
@@ -32,6 +37,12 @@ namespace llvm::memoir {
  * Created: August 28, 2023
  */
 
+static llvm::cl::opt<uint64_t> DenseKeyLimit(
+    "kf-dense-key-limit",
+    llvm::cl::desc("The largest integer key space that is folded onto a "
+                   "sequence"),
+    llvm::cl::init(1 << 20));
+
 struct KeyFoldingPass : public ModulePass {
   static char ID;
 
@@ -45,12 +56,21 @@ struct KeyFoldingPass : public ModulePass {
     debugln("Running key folding pass");
     debugln();
 
-    auto KF = KeyFolding(M);
+    auto &noelle = getAnalysis<arcana::noelle::Noelle>();
+
+    KeyFolding KF(M, noelle, DenseKeyLimit);
+
+    // Folding changes the collection type of folded values, drop all cached
+    // types.
+    if (KF.transformed) {
+      TypeAnalysis::invalidate();
+    }
 
     return KF.transformed;
   }
 
   void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.addRequired<arcana::noelle::Noelle>();
     return;
   }
 };
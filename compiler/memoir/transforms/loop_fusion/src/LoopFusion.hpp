@@ -0,0 +1,637 @@
+#ifndef MEMOIR_LOOPFUSION_H
+#define MEMOIR_LOOPFUSION_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Local.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class fuses adjacent loops that traverse the same index space of MEMOIR
+ * collections, so that each collection is streamed through once.
+ *
+ * Two loops are fused when:
+ *  - the exit block of the first is the preheader of the second,
+ *  - both are governed by equivalent induction variables (same start, step,
+ *    bound and predicate),
+ *  - neither contains side effects beyond MEMOIR accesses,
+ *  - every collection written by either loop is only accessed at the
+ *    induction variable in both loops, and
+ *  - no scalar computed by the first loop is used by the second.
+ *
+ * Legality is established on the MEMOIR SSA form: collection versions are
+ * followed along their def-use chains (writes, use PHIs and loop PHIs) back to
+ * the definition outside of the loops to determine which accesses refer to the
+ * same collection.
+ */
+
+namespace llvm::memoir {
+
+class LoopFusion {
+public:
+  /**
+   * Performs Loop Fusion on the input program @M.
+   */
+  LoopFusion(llvm::Module &M) : M(M) {
+    // Run loop fusion.
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+  /**
+   * Gets the functions in which loops were fused or prepared for fusion.
+   */
+  const set<llvm::Function *> &transformed_functions() const {
+    return this->_transformed_functions;
+  }
+
+protected:
+  /**
+   * The structure of a loop that is a candidate for fusion.
+   * Candidates are in the non-rotated form, where the header is the only
+   * exiting block and consists of induction variable PHIs and the exit check.
+   */
+  struct Candidate {
+    llvm::Loop *loop;
+    llvm::BasicBlock *preheader;
+    llvm::BasicBlock *header;
+    llvm::BasicBlock *body;
+    llvm::BasicBlock *latch;
+    llvm::BasicBlock *exit;
+
+    llvm::PHINode *induction_variable;
+    llvm::Value *start;
+    llvm::ConstantInt *step;
+    llvm::ICmpInst *compare;
+    llvm::Value *bound;
+    bool body_on_true;
+  };
+
+  /**
+   * A MEMOIR access performed within a candidate loop.
+   */
+  struct Access {
+    llvm::Value *collection;
+    bool is_write;
+    bool at_induction_variable;
+  };
+
+  // Top-level driver.
+  bool run() {
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      // Fuse loops in this function until we reach a fixed point.
+      while (this->fuse_one(F)) {
+        this->_transformed_functions.insert(&F);
+      }
+    }
+
+    return !this->_transformed_functions.empty();
+  }
+
+  bool fuse_one(llvm::Function &F) {
+    llvm::DominatorTree DT(F);
+    llvm::LoopInfo LI(DT);
+
+    for (auto *first_loop : LI.getLoopsInPreorder()) {
+      auto first = this->analyze_loop(*first_loop);
+      if (!first) {
+        continue;
+      }
+
+      // Find the loop that immediately follows this one.
+      auto *successor = first->exit->getSingleSuccessor();
+      if (successor == nullptr || !LI.isLoopHeader(successor)) {
+        continue;
+      }
+      auto *second_loop = LI.getLoopFor(successor);
+      if (second_loop->getParentLoop() != first_loop->getParentLoop()) {
+        continue;
+      }
+
+      // Fold away LCSSA PHIs between the loops. This changes the function
+      // even if the loops turn out not to be fusable.
+      if (llvm::FoldSingleEntryPHINodes(first->exit)) {
+        this->_transformed_functions.insert(&F);
+      }
+
+      auto second = this->analyze_loop(*second_loop);
+      if (!second || second->preheader != first->exit) {
+        continue;
+      }
+
+      if (!this->can_fuse(*first, *second)) {
+        continue;
+      }
+
+      infoln("Fusing loops:");
+      infoln("  ", first->header->getName());
+      infoln("  ", second->header->getName());
+
+      this->fuse(*first, *second);
+
+      return true;
+    }
+
+    return false;
+  }
+
+  // Analysis helpers.
+  static bool is_induction_variable(llvm::Value &V, llvm::PHINode &IV) {
+    if (&V == &IV) {
+      return true;
+    } else if (auto *cast = dyn_cast<llvm::CastInst>(&V)) {
+      return is_induction_variable(*cast->getOperand(0), IV);
+    }
+    return false;
+  }
+
+  static bool is_equivalent(llvm::Value &V1, llvm::Value &V2) {
+    if (&V1 == &V2) {
+      return true;
+    }
+
+    if (V1.getType() != V2.getType()) {
+      return false;
+    }
+
+    if (auto *const1 = dyn_cast<llvm::ConstantInt>(&V1)) {
+      if (auto *const2 = dyn_cast<llvm::ConstantInt>(&V2)) {
+        return const1->getValue() == const2->getValue();
+      }
+      return false;
+    }
+
+    if (auto *cast1 = dyn_cast<llvm::CastInst>(&V1)) {
+      if (auto *cast2 = dyn_cast<llvm::CastInst>(&V2)) {
+        return (cast1->getOpcode() == cast2->getOpcode())
+               && is_equivalent(*cast1->getOperand(0), *cast2->getOperand(0));
+      }
+      return false;
+    }
+
+    // Sizes are unchanged by the accesses we allow in candidate loops, so two
+    // sizes of the same collection are equivalent.
+    if (auto *size1 = into<SizeInst>(&V1)) {
+      if (auto *size2 = into<SizeInst>(&V2)) {
+        return &find_collection(size1->getCollection())
+               == &find_collection(size2->getCollection());
+      }
+      return false;
+    }
+
+    return false;
+  }
+
+  static llvm::Value *find_collection_helper(llvm::Value &V,
+                                             set<llvm::Value *> &visited) {
+    if (visited.count(&V) > 0) {
+      return nullptr;
+    }
+    visited.insert(&V);
+
+    if (auto *write_inst = into<IndexWriteInst>(&V)) {
+      return find_collection_helper(write_inst->getObjectOperand(), visited);
+    } else if (auto *use_phi = into<UsePHIInst>(&V)) {
+      return find_collection_helper(use_phi->getUsedCollection(), visited);
+    } else if (auto *phi = dyn_cast<llvm::PHINode>(&V)) {
+      llvm::Value *collection = nullptr;
+      for (auto &incoming : phi->incoming_values()) {
+        auto *incoming_collection =
+            find_collection_helper(*incoming.get(), visited);
+        if (incoming_collection == nullptr
+            || incoming_collection == collection) {
+          continue;
+        } else if (collection == nullptr) {
+          collection = incoming_collection;
+        } else {
+          return phi;
+        }
+      }
+      return (collection == nullptr) ? phi : collection;
+    }
+
+    return &V;
+  }
+
+  /**
+   * Follows the SSA def-use chain of collection @V back to the definition of
+   * the collection that it is a version of.
+   */
+  static llvm::Value &find_collection(llvm::Value &V) {
+    set<llvm::Value *> visited = {};
+    auto *collection = find_collection_helper(V, visited);
+    return (collection == nullptr) ? V : *collection;
+  }
+
+  opt<Candidate> analyze_loop(llvm::Loop &L) {
+    Candidate candidate;
+    candidate.loop = &L;
+    candidate.header = L.getHeader();
+    candidate.preheader = L.getLoopPreheader();
+    candidate.latch = L.getLoopLatch();
+    candidate.exit = L.getExitBlock();
+
+    if (candidate.preheader == nullptr || candidate.latch == nullptr
+        || candidate.exit == nullptr
+        || L.getExitingBlock() != candidate.header
+        || candidate.exit->getSinglePredecessor() != candidate.header) {
+      return {};
+    }
+
+    // Fetch the exit condition.
+    auto *branch =
+        dyn_cast<llvm::BranchInst>(candidate.header->getTerminator());
+    if (branch == nullptr || !branch->isConditional()) {
+      return {};
+    }
+    candidate.compare = dyn_cast<llvm::ICmpInst>(branch->getCondition());
+    if (candidate.compare == nullptr
+        || candidate.compare->getParent() != candidate.header) {
+      return {};
+    }
+    candidate.body_on_true = L.contains(branch->getSuccessor(0));
+    candidate.body = branch->getSuccessor(candidate.body_on_true ? 0 : 1);
+    if (candidate.body->getSinglePredecessor() != candidate.header) {
+      return {};
+    }
+
+    // The header may only contain PHIs and the exit condition.
+    for (auto &I : *candidate.header) {
+      if (isa<llvm::PHINode>(&I) || isa<llvm::DbgInfoIntrinsic>(&I)
+          || &I == candidate.compare || &I == branch) {
+        continue;
+      }
+      return {};
+    }
+
+    // Fetch the induction variable from the exit condition.
+    auto *lhs = candidate.compare->getOperand(0);
+    auto *rhs = candidate.compare->getOperand(1);
+    candidate.induction_variable = dyn_cast<llvm::PHINode>(lhs);
+    candidate.bound = rhs;
+    if (candidate.induction_variable == nullptr
+        || candidate.induction_variable->getParent() != candidate.header
+        || !L.isLoopInvariant(candidate.bound)) {
+      return {};
+    }
+
+    auto &IV = *candidate.induction_variable;
+    candidate.start = IV.getIncomingValueForBlock(candidate.preheader);
+    auto *next = dyn_cast<llvm::BinaryOperator>(
+        IV.getIncomingValueForBlock(candidate.latch));
+    if (next == nullptr || next->getOpcode() != llvm::Instruction::Add
+        || next->getOperand(0) != &IV) {
+      return {};
+    }
+    candidate.step = dyn_cast<llvm::ConstantInt>(next->getOperand(1));
+    if (candidate.step == nullptr) {
+      return {};
+    }
+
+    return candidate;
+  }
+
+  bool collect_accesses(Candidate &C, vector<Access> &accesses) {
+    auto &IV = *C.induction_variable;
+
+    for (auto *BB : C.loop->getBlocks()) {
+      for (auto &I : *BB) {
+        if (BB == C.header) {
+          continue;
+        }
+
+        if (auto *memoir_inst = MemOIRInst::get(I)) {
+          if (auto *read_inst = dyn_cast<IndexReadInst>(memoir_inst)) {
+            if (read_inst->getNumberOfDimensions() != 1) {
+              return false;
+            }
+            accesses.push_back(
+                { &find_collection(read_inst->getObjectOperand()),
+                  false,
+                  is_induction_variable(read_inst->getIndexOfDimension(0),
+                                        IV) });
+          } else if (auto *write_inst = dyn_cast<IndexWriteInst>(memoir_inst)) {
+            if (write_inst->getNumberOfDimensions() != 1) {
+              return false;
+            }
+            accesses.push_back(
+                { &find_collection(write_inst->getObjectOperand()),
+                  true,
+                  is_induction_variable(write_inst->getIndexOfDimension(0),
+                                        IV) });
+          } else if (auto *get_inst = dyn_cast<IndexGetInst>(memoir_inst)) {
+            if (get_inst->getNumberOfDimensions() != 1) {
+              return false;
+            }
+            accesses.push_back(
+                { &find_collection(get_inst->getObjectOperand()),
+                  false,
+                  is_induction_variable(get_inst->getIndexOfDimension(0),
+                                        IV) });
+          } else if (isa<StructReadInst>(memoir_inst)
+                     || isa<StructWriteInst>(memoir_inst)) {
+            // Struct accesses are attributed to the sequence element they
+            // were fetched from.
+            auto &access = cast<AccessInst>(*memoir_inst);
+            auto *get_inst = into<IndexGetInst>(&access.getObjectOperand());
+            if (get_inst == nullptr
+                || !C.loop->contains(&get_inst->getCallInst())
+                || get_inst->getNumberOfDimensions() != 1) {
+              return false;
+            }
+            accesses.push_back(
+                { &find_collection(get_inst->getObjectOperand()),
+                  isa<StructWriteInst>(memoir_inst),
+                  is_induction_variable(get_inst->getIndexOfDimension(0),
+                                        IV) });
+          } else if (isa<UsePHIInst>(memoir_inst) || isa<SizeInst>(memoir_inst)
+                     || isa<TypeInst>(memoir_inst)
+                     || isa<AssertCollectionTypeInst>(memoir_inst)
+                     || isa<AssertStructTypeInst>(memoir_inst)) {
+            continue;
+          } else {
+            debugln("LF: unsupported MEMOIR instruction ", I);
+            return false;
+          }
+        } else if (isa<llvm::IntrinsicInst>(&I) && !I.mayWriteToMemory()) {
+          continue;
+        } else if (isa<llvm::CallBase>(&I) || I.mayWriteToMemory()) {
+          debugln("LF: side effect ", I);
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  bool can_fuse(Candidate &first, Candidate &second) {
+    // Check that the induction variables are equivalent.
+    auto &IV1 = *first.induction_variable;
+    auto &IV2 = *second.induction_variable;
+    if (IV1.getType() != IV2.getType()
+        || !is_equivalent(*first.start, *second.start)
+        || first.step->getValue() != second.step->getValue()
+        || first.compare->getPredicate() != second.compare->getPredicate()
+        || first.body_on_true != second.body_on_true
+        || !is_equivalent(*first.bound, *second.bound)) {
+      debugln("LF: induction variables differ");
+      return false;
+    }
+
+    // The instructions between the loops must only feed the header of the
+    // second loop, which will be removed.
+    for (auto &I : *first.exit) {
+      if (&I == first.exit->getTerminator()) {
+        continue;
+      }
+      if (I.mayHaveSideEffects() && !into<SizeInst>(&I)) {
+        return false;
+      }
+      for (auto *user : I.users()) {
+        auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+        if (user_as_inst == nullptr
+            || (user_as_inst->getParent() != first.exit
+                && user_as_inst != second.compare && user_as_inst != &IV2)) {
+          return false;
+        }
+      }
+    }
+
+    // Check that the second loop does not depend on scalars computed by the
+    // first loop. Collections defined by the first loop may only flow into
+    // the second loop.
+    for (auto &phi : first.header->phis()) {
+      bool used_by_second = false;
+      for (auto *user : phi.users()) {
+        auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+        if (user_as_inst == nullptr) {
+          return false;
+        }
+        if (second.loop->contains(user_as_inst)
+            || user_as_inst->getParent() == first.exit) {
+          used_by_second = true;
+        }
+      }
+
+      if (!used_by_second) {
+        continue;
+      }
+
+      if (!Type::value_is_collection_type(phi)) {
+        debugln("LF: scalar flows between loops ", phi);
+        return false;
+      }
+
+      unsigned num_phi_users = 0;
+      for (auto *user : phi.users()) {
+        auto *user_as_inst = cast<llvm::Instruction>(user);
+        if (!first.loop->contains(user_as_inst)
+            && !second.loop->contains(user_as_inst)
+            && user_as_inst->getParent() != first.exit) {
+          debugln("LF: collection escapes the loops ", phi);
+          return false;
+        }
+        if (user_as_inst->getParent() == second.header) {
+          ++num_phi_users;
+        }
+      }
+      if (num_phi_users > 1) {
+        return false;
+      }
+    }
+
+    // Check the incoming values of the second loop.
+    for (auto &phi : second.header->phis()) {
+      if (&phi == &IV2) {
+        continue;
+      }
+      auto *incoming = phi.getIncomingValueForBlock(second.preheader);
+      auto *incoming_inst = dyn_cast<llvm::Instruction>(incoming);
+      if (incoming_inst == nullptr) {
+        continue;
+      }
+      if (incoming_inst->getParent() == first.exit) {
+        return false;
+      }
+      if (first.loop->contains(incoming_inst)
+          && !(isa<llvm::PHINode>(incoming_inst)
+               && incoming_inst->getParent() == first.header)) {
+        return false;
+      }
+    }
+
+    // Collect the accesses performed by each loop.
+    vector<Access> accesses = {};
+    if (!this->collect_accesses(first, accesses)
+        || !this->collect_accesses(second, accesses)) {
+      return false;
+    }
+
+    // Any collection written by either loop must only be accessed at the
+    // induction variable, so that iteration i of the second loop only depends
+    // on iteration i of the first.
+    set<llvm::Value *> written = {};
+    for (auto &access : accesses) {
+      if (access.is_write) {
+        written.insert(access.collection);
+      }
+    }
+    for (auto &access : accesses) {
+      if (written.count(access.collection) > 0
+          && !access.at_induction_variable) {
+        debugln("LF: non-elementwise access to ", *access.collection);
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  static void replace_incoming_block(llvm::BasicBlock &BB,
+                                     llvm::BasicBlock &old_block,
+                                     llvm::BasicBlock &new_block) {
+    for (auto &phi : BB.phis()) {
+      auto idx = phi.getBasicBlockIndex(&old_block);
+      if (idx >= 0) {
+        phi.setIncomingBlock(idx, &new_block);
+      }
+    }
+  }
+
+  // Transformation.
+  void fuse(Candidate &first, Candidate &second) {
+    auto &IV1 = *first.induction_variable;
+    auto &IV2 = *second.induction_variable;
+
+    // Record the collection versions at the end of each iteration of the
+    // first loop.
+    map<llvm::PHINode *, llvm::Value *> first_next = {};
+    for (auto &phi : first.header->phis()) {
+      first_next[&phi] = phi.getIncomingValueForBlock(first.latch);
+    }
+
+    // Within the second loop body, collections from the first loop are
+    // replaced with their version from the same iteration.
+    set<llvm::BasicBlock *> second_blocks(second.loop->block_begin(),
+                                          second.loop->block_end());
+    for (auto const &[phi, next] : first_next) {
+      if (phi == &IV1) {
+        continue;
+      }
+      for (auto it = phi->use_begin(); it != phi->use_end();) {
+        auto &use = *it++;
+        auto *user_as_inst = cast<llvm::Instruction>(use.getUser());
+        if (user_as_inst->getParent() != second.header
+            && second_blocks.count(user_as_inst->getParent()) > 0) {
+          use.set(next);
+        }
+      }
+    }
+
+    // Merge the headers.
+    vector<llvm::PHINode *> second_phis = {};
+    for (auto &phi : second.header->phis()) {
+      second_phis.push_back(&phi);
+    }
+
+    for (auto &phi : first.header->phis()) {
+      phi.setIncomingBlock(phi.getBasicBlockIndex(first.latch), second.latch);
+    }
+
+    auto *first_insertion_point = first.header->getFirstNonPHI();
+    for (auto *phi : second_phis) {
+      if (phi == &IV2) {
+        continue;
+      }
+
+      auto *incoming = phi->getIncomingValueForBlock(second.preheader);
+      auto *incoming_phi = dyn_cast<llvm::PHINode>(incoming);
+      if (incoming_phi != nullptr
+          && incoming_phi->getParent() == first.header) {
+        // The collection is carried by the first loop, thread the second
+        // loop's version through it.
+        auto *next = first_next[incoming_phi];
+        for (auto it = phi->use_begin(); it != phi->use_end();) {
+          auto &use = *it++;
+          auto *user_as_inst = cast<llvm::Instruction>(use.getUser());
+          if (second_blocks.count(user_as_inst->getParent()) > 0) {
+            use.set(next);
+          } else {
+            use.set(incoming_phi);
+          }
+        }
+        incoming_phi->setIncomingValue(
+            incoming_phi->getBasicBlockIndex(second.latch),
+            phi->getIncomingValueForBlock(second.latch));
+        phi->eraseFromParent();
+      } else {
+        phi->moveBefore(first_insertion_point);
+        phi->setIncomingBlock(phi->getBasicBlockIndex(second.preheader),
+                              first.preheader);
+      }
+    }
+
+    auto *IV2_next = IV2.getIncomingValueForBlock(second.latch);
+    IV2.replaceAllUsesWith(&IV1);
+    IV2.eraseFromParent();
+    llvm::RecursivelyDeleteTriviallyDeadInstructions(IV2_next);
+
+    // Stitch the bodies together.
+    first.latch->getTerminator()->replaceUsesOfWith(first.header, second.body);
+    replace_incoming_block(*second.body, *second.header, *first.latch);
+
+    second.latch->getTerminator()->replaceUsesOfWith(second.header,
+                                                     first.header);
+
+    first.header->getTerminator()->replaceUsesOfWith(first.exit, second.exit);
+    replace_incoming_block(*second.exit, *second.header, *first.header);
+
+    // Remove the second header and the block between the loops.
+    first.exit->dropAllReferences();
+    second.header->dropAllReferences();
+    first.exit->eraseFromParent();
+    second.header->eraseFromParent();
+
+    return;
+  }
+
+  // Owned state.
+  bool _transformed;
+  set<llvm::Function *> _transformed_functions;
+
+  // Borrowed state.
+  llvm::Module &M;
+};
+
+} // namespace llvm::memoir
+
+#endif
@@ -0,0 +1,71 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// MemOIR
+#include "memoir/ir/InstVisitor.hpp"
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "LoopFusion.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass fuses adjacent loops over the same collections.
+ */
+
+struct LoopFusionPass : public ModulePass {
+  static char ID;
+
+  LoopFusionPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN loop fusion pass");
+    infoln();
+
+    LoopFusion LF(M);
+
+    // Fusion rewrites the values of the fused loops, but no types.
+    for (auto *F : LF.transformed_functions()) {
+      TypeAnalysis::invalidate(*F);
+    }
+
+    infoln();
+    infoln("END loop fusion pass");
+    infoln("========================");
+
+    return LF.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char LoopFusionPass::ID = 0;
+static llvm::RegisterPass<LoopFusionPass> X(
+    "memoir-lf",
+    "Fuses adjacent loops over the same collections.");
+
+} // namespace llvm::memoir
@@ -1,3 +1,11 @@
+#include "llvm/IR/Attributes.h"
+
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+#include "memoir/utility/FunctionNames.hpp"
+
+#include "memoir/ir/Instructions.hpp"
+
 #include "Normalization.hpp"
 
 namespace llvm::memoir {
@@ -14,8 +22,62 @@ void Normalization::analyze() {
 
 void Normalization::transform() {
   // Transform the program
+  this->foldPrimitiveTypes();
 
   return;
 }
 
+void Normalization::foldPrimitiveTypes() {
+  // The runtime returns the same type for every call to a primitive type
+  // constructor, so we only need one call per function. Mark the constructors
+  // as readnone so that LLVM can fold any calls we introduce later on.
+  bool folded = false;
+  for (auto &F : M) {
+    if (!FunctionNames::is_memoir_call(F)) {
+      continue;
+    }
+
+    auto func_enum = FunctionNames::get_memoir_enum(F);
+    if (!FunctionNames::is_primitive_type(func_enum)) {
+      continue;
+    }
+
+    F.addFnAttr(llvm::Attribute::AttrKind::ReadNone);
+    F.addFnAttr(llvm::Attribute::AttrKind::NoUnwind);
+
+    // Gather the calls to this constructor in each function.
+    map<llvm::Function *, vector<llvm::CallInst *>> calls_by_function = {};
+    for (auto &use : F.uses()) {
+      auto *call = dyn_cast<llvm::CallInst>(use.getUser());
+      if (!call || call->getCalledFunction() != &F) {
+        continue;
+      }
+      calls_by_function[call->getFunction()].push_back(call);
+    }
+
+    // Hoist one call to the entry block and replace the others with it.
+    for (auto const &[caller, calls] : calls_by_function) {
+      auto *canonical = calls.front();
+      auto &entry_bb = caller->getEntryBlock();
+      canonical->moveBefore(&*entry_bb.getFirstInsertionPt());
+
+      for (auto *call : calls) {
+        if (call == canonical) {
+          continue;
+        }
+        call->replaceAllUsesWith(canonical);
+        call->eraseFromParent();
+        folded = true;
+      }
+    }
+
+    debugln("Folded calls to ", F.getName());
+  }
+
+  // Invalidate the MemOIRInst cache, since we deleted calls.
+  if (folded) {
+    MemOIRInst::invalidate();
+  }
+}
+
 } // namespace llvm::memoir
@@ -40,6 +40,13 @@ public:
    * Transform the runtime bitcode
    */
   void transformRuntime();
+
+protected:
+  /*
+   * Fold the calls to each primitive type constructor into a single call per
+   * function.
+   */
+  void foldPrimitiveTypes();
 };
 
 } // namespace llvm::memoir
@@ -0,0 +1,73 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/ir/InstVisitor.hpp"
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "ReserveInsertion.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass reserves the capacity of sequences before the loops that append to
+ * them, when the trip count of the loop can be computed.
+ */
+
+struct ReserveInsertionPass : public ModulePass {
+  static char ID;
+
+  ReserveInsertionPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN reserve insertion pass");
+    infoln();
+
+    auto &noelle = getAnalysis<arcana::noelle::Noelle>();
+
+    // Reserving capacity neither replaces nor retypes any collection, so the
+    // type analysis results stay valid.
+    ReserveInsertion RI(M, noelle);
+
+    infoln();
+    infoln("END reserve insertion pass");
+    infoln("========================");
+
+    return RI.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.addRequired<arcana::noelle::Noelle>();
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char ReserveInsertionPass::ID = 0;
+static llvm::RegisterPass<ReserveInsertionPass> X(
+    "memoir-reserve",
+    "Reserves sequences before loops that append to them.");
+
+} // namespace llvm::memoir
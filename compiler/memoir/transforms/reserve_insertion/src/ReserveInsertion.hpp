@@ -0,0 +1,232 @@
+#ifndef MEMOIR_RESERVEINSERTION_H
+#define MEMOIR_RESERVEINSERTION_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+#include "llvm/Analysis/LoopInfo.h"
+
+// NOELLE
+#include "noelle/core/Noelle.hpp"
+
+// MemOIR
+#include "memoir/ir/Builder.hpp"
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/analysis/IterationSpace.hpp"
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class reserves the capacity of sequences that are appended to in loops
+ * with a computable trip count, so that the loop performs a single allocation.
+ *
+ * For a loop governed by an induction variable that starts at s, steps by one
+ * and exits on a less-than comparison against e in the header, every sequence
+ * that is appended to k times per iteration is reserved in the preheader:
+ *
+ *   reserve(b, size(b) + k * max(e - s, 0))
+ */
+
+namespace llvm::memoir {
+
+class ReserveInsertion {
+public:
+  /**
+   * Reserves sequences appended to in loops of the program @M, using the trip
+   * counts computed from the induction variables found by @noelle.
+   */
+  ReserveInsertion(llvm::Module &M, arcana::noelle::Noelle &noelle)
+    : M(M),
+      noelle(noelle) {
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+protected:
+  // Top-level driver.
+  bool run() {
+    bool transformed = false;
+
+    for (auto &F : this->M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      auto *loops = this->noelle.getLoopContents(&F);
+      if (loops == nullptr) {
+        continue;
+      }
+
+      llvm::DominatorTree DT(F);
+      llvm::LoopInfo LI(DT);
+
+      for (auto *loop : *loops) {
+        auto &loop_structure =
+            MEMOIR_SANITIZE(loop->getLoopStructure(),
+                            "NOELLE gave us a NULL LoopStructure!");
+        auto &IVM =
+            MEMOIR_SANITIZE(loop->getInductionVariableManager(),
+                            "NOELLE gave us a NULL InductionVariableManager");
+
+        auto *llvm_loop = LI.getLoopFor(loop_structure.getHeader());
+        if (llvm_loop == nullptr
+            || llvm_loop->getHeader() != loop_structure.getHeader()) {
+          continue;
+        }
+
+        transformed |= this->reserve(*llvm_loop, loop_structure, IVM, DT, LI);
+      }
+    }
+
+    return transformed;
+  }
+
+  // Analysis.
+  /**
+   * Computes the trip count of the iteration @space in its preheader.
+   */
+  llvm::Value *trip_count(IterationSpace &space) {
+    // trip count = (start < end) ? (end - start) : 0
+    MemOIRBuilder builder(space.preheader->getTerminator());
+    auto *in_bounds =
+        builder.CreateICmp(space.predicate, space.start, space.end);
+    auto *distance = builder.CreateSub(space.end, space.start);
+    auto *count = builder.CreateSelect(
+        in_bounds,
+        distance,
+        llvm::ConstantInt::get(distance->getType(), 0),
+        "trip.count.");
+
+    return builder.CreateZExtOrTrunc(count, builder.getInt64Ty());
+  }
+
+  /**
+   * Counts the number of appends made to the collection PHI @phi on each
+   * iteration of the loop @L.
+   * Returns 0 if they could not be counted.
+   */
+  unsigned count_appends(llvm::Loop &L,
+                         llvm::PHINode &phi,
+                         llvm::DominatorTree &DT,
+                         llvm::LoopInfo &LI) {
+    auto *latch = L.getLoopLatch();
+    auto *preheader = L.getLoopPreheader();
+    if (latch == nullptr || preheader == nullptr
+        || phi.getNumIncomingValues() != 2) {
+      return 0;
+    }
+
+    // Walk back from the value carried around the loop to the PHI.
+    unsigned num_appends = 0;
+    auto *collection = phi.getIncomingValueForBlock(latch);
+    while (collection != &phi) {
+      auto *inst = dyn_cast<llvm::Instruction>(collection);
+      if (inst == nullptr || LI.getLoopFor(inst->getParent()) != &L
+          || inst->getParent() == L.getHeader()
+          || !DT.dominates(inst->getParent(), latch)) {
+        return 0;
+      }
+
+      if (auto *insert = into<SeqInsertInst>(inst)) {
+        if (!into<EndInst>(&insert->getInsertionPoint())) {
+          return 0;
+        }
+        ++num_appends;
+        collection = &insert->getBaseCollection();
+      } else if (auto *use_phi = into<UsePHIInst>(inst)) {
+        collection = &use_phi->getUsedCollection();
+      } else {
+        return 0;
+      }
+    }
+
+    return num_appends;
+  }
+
+  static bool is_reserved(llvm::Value &collection) {
+    for (auto *user : collection.users()) {
+      if (into<SeqReserveInst>(user)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Transformation.
+  bool reserve(llvm::Loop &L,
+               arcana::noelle::LoopStructure &LS,
+               arcana::noelle::InductionVariableManager &IVM,
+               llvm::DominatorTree &DT,
+               llvm::LoopInfo &LI) {
+    // Find the sequences appended to on each iteration.
+    auto *preheader = L.getLoopPreheader();
+    vector<std::pair<llvm::PHINode *, unsigned>> appended = {};
+    for (auto &phi : L.getHeader()->phis()) {
+      if (preheader == nullptr
+          || dyn_cast_or_null<SequenceType>(TypeAnalysis::analyze(phi))
+                 == nullptr
+          || is_reserved(*phi.getIncomingValueForBlock(preheader))) {
+        continue;
+      }
+
+      auto num_appends = this->count_appends(L, phi, DT, LI);
+      if (num_appends > 0) {
+        appended.emplace_back(&phi, num_appends);
+      }
+    }
+
+    if (appended.empty()) {
+      return false;
+    }
+
+    auto space = analyze_iteration_space(L, LS, IVM);
+    if (!space) {
+      return false;
+    }
+    auto *count = this->trip_count(*space);
+
+    MemOIRBuilder builder(preheader->getTerminator());
+    for (auto const &[phi, num_appends] : appended) {
+      auto *initial = phi->getIncomingValueForBlock(preheader);
+
+      infoln("Reserving ", num_appends, " elements per iteration for");
+      infoln("  ", *phi);
+
+      auto *size = builder.CreateSizeInst(initial, "reserve.size.");
+      auto *appends = builder.CreateMul(count, builder.getInt64(num_appends));
+      auto *capacity =
+          builder.CreateAdd(&size->getCallInst(), appends, "reserve.cap.");
+      builder.CreateSeqReserveInst(initial, capacity);
+    }
+
+    return true;
+  }
+
+  // Owned state.
+  bool _transformed;
+
+  // Borrowed state.
+  llvm::Module &M;
+  arcana::noelle::Noelle &noelle;
+};
+
+} // namespace llvm::memoir
+
+#endif
@@ -91,8 +91,6 @@ struct SSAConstructionPass : public ModulePass {
     infoln("BEGIN SSA construction pass");
     infoln();
 
-    TypeAnalysis::invalidate();
-
     SSAConstructionStats stats;
 
     for (auto &F : M) {
@@ -321,6 +319,9 @@ struct SSAConstructionPass : public ModulePass {
       infoln("Cleaning up dead mutable instructions.");
       MTIV.cleanup();
 
+      // Drop the cached types of the rewritten function.
+      TypeAnalysis::invalidate(F);
+
       infoln("END: ", F.getName());
       infoln("=========================");
     }
@@ -330,7 +331,6 @@ struct SSAConstructionPass : public ModulePass {
 
     infoln();
 
-    TypeAnalysis::invalidate();
     MemOIRInst::invalidate();
 
     return true;
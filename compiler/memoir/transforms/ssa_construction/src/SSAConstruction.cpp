@@ -468,6 +468,42 @@ void SSAConstructionVisitor::visitMutSeqRemoveInst(MutSeqRemoveInst &I) {
   return;
 }
 
+void SSAConstructionVisitor::visitMutSeqFillInst(MutSeqFillInst &I) {
+  MemOIRBuilder builder(I);
+
+  // Fetch type information.
+  auto *type = TypeAnalysis::analyze(I.getCollection());
+  MEMOIR_NULL_CHECK(type, "Couldn't determine type of seq_fill!");
+  auto *collection_type = dyn_cast<CollectionType>(type);
+  MEMOIR_NULL_CHECK(collection_type,
+                    "seq_fill not operating on a collection type");
+  auto &element_type = collection_type->getElementType();
+
+  // Fetch operand information.
+  auto *collection_orig = &I.getCollection();
+  auto *collection_value = update_reaching_definition(collection_orig, I);
+  auto *write_value = &I.getValueWritten();
+  auto *begin_value = &I.getBeginIndex();
+  auto *end_value = &I.getEndIndex();
+
+  // Create SeqFillInst.
+  auto *ssa_fill = builder.CreateSeqFillInst(element_type,
+                                             write_value,
+                                             collection_value,
+                                             begin_value,
+                                             end_value,
+                                             "seq.fill.");
+
+  // Update reaching definitions.
+  this->set_reaching_definition(collection_orig, ssa_fill);
+  this->set_reaching_definition(ssa_fill, collection_value);
+
+  // Mark old instruction for cleanup.
+  this->mark_for_cleanup(I);
+
+  return;
+}
+
 void SSAConstructionVisitor::visitMutSeqAppendInst(MutSeqAppendInst &I) {
   MemOIRBuilder builder(I);
 
@@ -647,6 +683,26 @@ void SSAConstructionVisitor::visitMutAssocRemoveInst(MutAssocRemoveInst &I) {
   return;
 }
 
+void SSAConstructionVisitor::visitMutClearInst(MutClearInst &I) {
+  MemOIRBuilder builder(I);
+
+  // Split the live range of the collection being cleared.
+  auto *collection_orig = &I.getCollection();
+  auto *collection_value = update_reaching_definition(collection_orig, I);
+
+  // Replace the MUT operation with its SSA form.
+  auto *ssa_clear = builder.CreateClearInst(collection_value, "clear.");
+  auto *ssa_clear_value = &ssa_clear->getCallInst();
+
+  // Update the reaching definitions.
+  this->set_reaching_definition(collection_orig, ssa_clear_value);
+  this->set_reaching_definition(ssa_clear_value, collection_value);
+
+  this->mark_for_cleanup(I);
+
+  return;
+}
+
 void SSAConstructionVisitor::visitMutAssocInsertInst(MutAssocInsertInst &I) {
   MemOIRBuilder builder(I);
 
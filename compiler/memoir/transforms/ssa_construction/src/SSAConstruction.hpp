@@ -53,6 +53,7 @@ public:
   void visitMutSeqInsertInst(MutSeqInsertInst &I);
   void visitMutSeqInsertSeqInst(MutSeqInsertSeqInst &I);
   void visitMutSeqRemoveInst(MutSeqRemoveInst &I);
+  void visitMutSeqFillInst(MutSeqFillInst &I);
   void visitMutSeqAppendInst(MutSeqAppendInst &I);
   void visitMutSeqSwapInst(MutSeqSwapInst &I);
   void visitMutSeqSwapWithinInst(MutSeqSwapWithinInst &I);
@@ -62,6 +63,8 @@ public:
   // MUT Assoc operations
   void visitMutAssocInsertInst(MutAssocInsertInst &I);
   void visitMutAssocRemoveInst(MutAssocRemoveInst &I);
+  // MUT Collection operations
+  void visitMutClearInst(MutClearInst &I);
 
   llvm::Value *update_reaching_definition(llvm::Value *variable,
                                           MemOIRInst &program_point);
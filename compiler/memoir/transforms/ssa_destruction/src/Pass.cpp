@@ -13,14 +13,10 @@
 
 #include "llvm/Transforms/IPO/PassManagerBuilder.h"
 
-#include "llvm/Analysis/DominanceFrontier.h"
-
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 
-// NOELLE
-#include "noelle/core/Noelle.hpp"
-
 // MemOIR
 #include "memoir/ir/Builder.hpp"
 #include "memoir/ir/InstVisitor.hpp"
@@ -53,6 +49,17 @@ static llvm::cl::opt<bool> DisableCollectionLowering(
     "disable-collection-lowering",
     llvm::cl::desc("Enable collection lowering"));
 
+static llvm::cl::opt<bool> EnableDirectSeqAccess(
+    "memoir-direct-seq-access",
+    llvm::cl::desc("Lower sequence index accesses to loads and stores through "
+                   "the sequence's data pointer"));
+
+static llvm::cl::opt<unsigned> SSADestructionThreads(
+    "memoir-ssa-destruction-threads",
+    llvm::cl::desc("Number of threads used to compute the per-function "
+                   "analyses of SSA destruction"),
+    llvm::cl::init(1));
+
 struct SSADestructionPass : public ModulePass {
   static char ID;
 
@@ -114,20 +121,65 @@ struct SSADestructionPass : public ModulePass {
     return std::move(dfs_postorder_traversal_helper(root_node));
   }
 
+  struct FunctionAnalyses {
+    std::unique_ptr<llvm::DominatorTree> DT;
+    std::unique_ptr<LivenessAnalysis> LA;
+  };
+
+  static FunctionAnalyses analyze_function(llvm::Function &F) {
+    FunctionAnalyses analyses;
+    analyses.DT = std::make_unique<llvm::DominatorTree>(F);
+    analyses.LA = std::make_unique<LivenessAnalysis>(F);
+    return analyses;
+  }
+
+  map<llvm::Function *, FunctionAnalyses> analyze_functions(
+      vector<llvm::Function *> &functions) {
+    map<llvm::Function *, FunctionAnalyses> analyses = {};
+
+    // Initialize the results serially, so that the workers never modify the
+    // map itself.
+    for (auto *F : functions) {
+      analyses[F];
+    }
+
+    if (SSADestructionThreads <= 1) {
+      for (auto *F : functions) {
+        analyses[F] = analyze_function(*F);
+      }
+      return analyses;
+    }
+
+    infoln("Analyzing ",
+           functions.size(),
+           " functions with ",
+           SSADestructionThreads,
+           " threads");
+
+    llvm::ThreadPool pool(SSADestructionThreads);
+    for (auto *F : functions) {
+      auto &result = analyses[F];
+      pool.async([F, &result]() { result = analyze_function(*F); });
+    }
+    pool.wait();
+
+    return analyses;
+  }
+
   bool runOnModule(llvm::Module &M) override {
     infoln("BEGIN SSA Destruction pass");
     infoln();
 
-    TypeAnalysis::invalidate();
-
-    // Get NOELLE.
-    auto &NOELLE = getAnalysis<arcana::noelle::Noelle>();
-
     SSADestructionStats stats;
 
     // Initialize the reaching definitions.
-    SSADestructionVisitor SSADV(M, &stats, !DisableCollectionLowering);
+    SSADestructionVisitor SSADV(M,
+                                &stats,
+                                !DisableCollectionLowering,
+                                EnableDirectSeqAccess);
 
+    // Collect the functions that contain MEMOIR.
+    vector<llvm::Function *> functions = {};
     for (auto &F : M) {
       if (F.empty()) {
         continue;
@@ -154,15 +206,23 @@ struct SSADestructionPass : public ModulePass {
         continue;
       }
 
+      functions.push_back(&F);
+    }
+
+    // Compute the per-function analyses up front. These only read the IR of
+    // their own function, so they can be computed in parallel.
+    auto analyses = this->analyze_functions(functions);
+
+    for (auto *F_ptr : functions) {
+      auto &F = *F_ptr;
+
       infoln();
       infoln("=========================");
       infoln("BEGIN: ", F.getName());
 
-      // Get the dominator forest.
-      auto &DT = getAnalysis<llvm::DominatorTreeWrapperPass>(F).getDomTree();
-
-      // Compute the liveness analysis.
-      auto LA = LivenessAnalysis(F, NOELLE.getDataFlowEngine());
+      // Get the dominator forest and liveness analysis.
+      auto &DT = *analyses[&F].DT;
+      auto &LA = *analyses[&F].LA;
 
       // Get a new value numbering instance.
       // auto VN = ValueNumbering(M);
@@ -184,6 +244,9 @@ struct SSADestructionPass : public ModulePass {
         }
       }
 
+      // Attach aliasing information to direct sequence accesses.
+      SSADV.annotate_direct_accesses();
+
       infoln("END: ", F.getName());
       infoln("=========================");
     }
@@ -215,9 +278,6 @@ struct SSADestructionPass : public ModulePass {
   }
 
   void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
-    AU.addRequired<arcana::noelle::Noelle>();
-    AU.addRequired<llvm::DominatorTreeWrapperPass>();
-    AU.addRequired<llvm::DominanceFrontierWrapperPass>();
     return;
   }
 };
@@ -1,3 +1,5 @@
+#include "llvm/IR/MDBuilder.h"
+
 #include "memoir/utility/FunctionNames.hpp"
 
 #include "memoir/support/Assert.hpp"
@@ -6,6 +8,7 @@
 
 #include "memoir/analysis/TypeAnalysis.hpp"
 
+#include "memoir/lowering/ImplLinker.hpp"
 #include "memoir/lowering/TypeLayout.hpp"
 
 #include "SSADestruction.hpp"
@@ -17,11 +20,13 @@ namespace llvm::memoir {
 
 SSADestructionVisitor::SSADestructionVisitor(llvm::Module &M,
                                              SSADestructionStats *stats,
-                                             bool enable_collection_lowering)
+                                             bool enable_collection_lowering,
+                                             bool enable_direct_seq_access)
   : M(M),
-    TC(M.getContext()),
+    TC(M),
     stats(stats),
-    enable_collection_lowering(enable_collection_lowering) {
+    enable_collection_lowering(enable_collection_lowering),
+    enable_direct_seq_access(enable_direct_seq_access) {
   // Do nothing.
 }
 
@@ -30,6 +35,11 @@ void SSADestructionVisitor::setAnalyses(llvm::DominatorTree &DT,
   this->DT = &DT;
   this->LA = &LA;
 
+  // Data pointers and sizes are only valid within their own function.
+  this->seq_data_pointers.clear();
+  this->seq_sizes.clear();
+  this->direct_accesses.clear();
+
   return;
 }
 
@@ -223,6 +233,27 @@ void SSADestructionVisitor::visitStructAllocInst(StructAllocInst &I) {
   // MEMOIR_NULL_CHECK(allocator_function, "Couldn't get the allocator
   // function!");
 
+  // If references are compressed, allocate the struct from its arena.
+  if (CompressReferences) {
+    auto allocator_name =
+        ImplLinker::get_arena_prefix(struct_type) + "__allocate";
+    auto allocator_callee =
+        this->M.getOrInsertFunction(allocator_name, llvm_ptr_type);
+    auto *allocation = builder.CreateCall(allocator_callee,
+                                          llvm::None,
+                                          "struct.");
+    MEMOIR_NULL_CHECK(allocation, "Couldn't create arena allocation");
+
+    auto *alloc_ptr =
+        builder.CreatePointerCast(allocation, I.getCallInst().getType());
+
+    this->coalesce(I, *alloc_ptr);
+
+    this->markForCleanup(I);
+
+    return;
+  }
+
   // Create the allocation.
   auto *insertion_point = &I.getCallInst();
   auto *allocation = llvm::CallInst::CreateMalloc(insertion_point,
@@ -245,6 +276,36 @@ void SSADestructionVisitor::visitStructAllocInst(StructAllocInst &I) {
   return;
 }
 
+void SSADestructionVisitor::visitDeleteStructInst(DeleteStructInst &I) {
+  // If references are compressed, return the struct to its arena.
+  if (CompressReferences) {
+    MemOIRBuilder builder(I);
+
+    auto &struct_type =
+        MEMOIR_SANITIZE(dyn_cast_or_null<StructType>(
+                            TypeAnalysis::analyze(I.getDeletedStruct())),
+                        "Couldn't determine type of deleted struct");
+    auto &type_layout = TC.convert(struct_type);
+    auto *llvm_ptr_type =
+        llvm::PointerType::get(&type_layout.get_llvm_type(), 0);
+
+    auto free_name = ImplLinker::get_arena_prefix(struct_type) + "__free";
+    auto free_callee = this->M.getOrInsertFunction(free_name,
+                                                   builder.getVoidTy(),
+                                                   llvm_ptr_type);
+
+    auto *deleted =
+        builder.CreatePointerCast(&I.getDeletedStruct(), llvm_ptr_type);
+    auto *llvm_call =
+        builder.CreateCall(free_callee, llvm::ArrayRef({ deleted }));
+    MEMOIR_NULL_CHECK(llvm_call, "Could not create the call to arena free");
+
+    this->markForCleanup(I);
+  }
+
+  return;
+}
+
 void SSADestructionVisitor::visitDeleteCollectionInst(DeleteCollectionInst &I) {
   if (this->enable_collection_lowering) {
     auto &collection_type =
@@ -309,6 +370,63 @@ void SSADestructionVisitor::visitDeleteCollectionInst(DeleteCollectionInst &I) {
   return;
 }
 
+void SSADestructionVisitor::visitClearInst(ClearInst &I) {
+  MemOIRBuilder builder(I);
+
+  if (this->enable_collection_lowering) {
+    auto &collection_type =
+        MEMOIR_SANITIZE(dyn_cast_or_null<CollectionType>(
+                            TypeAnalysis::analyze(I.getBaseCollection())),
+                        "Couldn't determine type of cleared collection");
+
+    std::string name;
+    if (auto *seq_type = dyn_cast<SequenceType>(&collection_type)) {
+      auto &element_type = seq_type->getElementType();
+      auto element_code = element_type.get_code();
+      name = *element_code + "_" SEQ_IMPL "__clear";
+    } else if (auto *assoc_type = dyn_cast<AssocArrayType>(&collection_type)) {
+      auto key_code = assoc_type->getKeyType().get_code();
+      auto value_code = assoc_type->getValueType().get_code();
+      name = *key_code + "_" + *value_code + "_" ASSOC_IMPL "__clear";
+    } else {
+      MEMOIR_UNREACHABLE("Attempt to clear a collection of fixed size");
+    }
+
+    auto *function = this->M.getFunction(name);
+    auto function_callee = FunctionCallee(function);
+    if (function == nullptr) {
+      warnln("Couldn't find function for ", name);
+      return;
+    }
+
+    auto *function_type = function_callee.getFunctionType();
+    auto *collection =
+        builder.CreatePointerCast(&I.getBaseCollection(),
+                                  function_type->getParamType(0));
+    auto *llvm_call =
+        builder.CreateCall(function_callee, llvm::ArrayRef({ collection }));
+    MEMOIR_NULL_CHECK(llvm_call, "Could not create the call for clear");
+
+    // Coalesce the result with the input operand.
+    this->coalesce(I, I.getBaseCollection());
+
+    // Mark the old instruction for cleanup.
+    this->markForCleanup(I);
+  } else {
+    auto &collection = I.getBaseCollection();
+
+    // Construct the Mut instruction.
+    builder.CreateMutClearInst(&collection);
+
+    // Coalesce the original collection with the operand.
+    this->coalesce(I, collection);
+
+    // Cleanup the old instruction.
+    this->markForCleanup(I);
+  }
+  return;
+}
+
 void SSADestructionVisitor::visitSizeInst(SizeInst &I) {
   if (this->enable_collection_lowering) {
     auto &collection_type =
@@ -318,6 +436,13 @@ void SSADestructionVisitor::visitSizeInst(SizeInst &I) {
 
     std::string name;
     if (auto *seq_type = dyn_cast<SequenceType>(&collection_type)) {
+      // If the size is available at the definition of the storage, use it.
+      if (auto *size = this->get_size(*seq_type, I.getCollection())) {
+        this->coalesce(I, *size);
+        this->markForCleanup(I);
+        return;
+      }
+
       auto &element_type = seq_type->getElementType();
 
       auto element_code = element_type.get_code();
@@ -356,6 +481,45 @@ void SSADestructionVisitor::visitSizeInst(SizeInst &I) {
   return;
 }
 
+void SSADestructionVisitor::visitSeqReserveInst(SeqReserveInst &I) {
+  if (this->enable_collection_lowering) {
+    auto &seq_type =
+        MEMOIR_SANITIZE(dyn_cast_or_null<SequenceType>(
+                            TypeAnalysis::analyze(I.getCollection())),
+                        "Couldn't determine type of reserved collection");
+
+    auto &elem_type = seq_type.getElementType();
+
+    auto elem_code = elem_type.get_code();
+    auto name = *elem_code + "_" SEQ_IMPL "__reserve";
+
+    auto *function = this->M.getFunction(name);
+    auto function_callee = FunctionCallee(function);
+    if (function == nullptr) {
+      warnln("Couldn't find function for ", name);
+      return;
+    }
+
+    MemOIRBuilder builder(I);
+
+    auto *function_type = function_callee.getFunctionType();
+    auto *seq = builder.CreatePointerCast(&I.getCollection(),
+                                          function_type->getParamType(0));
+    auto *capacity =
+        builder.CreateZExtOrTrunc(&I.getCapacity(),
+                                  function_type->getParamType(1));
+    // Reserving never moves the collection, so it has no result to coalesce.
+    auto *llvm_call =
+        builder.CreateCall(function_callee, llvm::ArrayRef({ seq, capacity }));
+    MEMOIR_NULL_CHECK(llvm_call, "Could not create the call for reserve");
+
+    this->markForCleanup(I);
+  } else {
+    // Do nothing.
+  }
+  return;
+}
+
 static llvm::Value &contextualize_end(EndInst &end_inst,
                                       llvm::Use &use,
                                       InsertInst &insert_inst) {
@@ -385,6 +549,20 @@ static llvm::Value &contextualize_end(EndInst &end_inst,
   return size_inst->getCallInst();
 }
 
+static llvm::Value &contextualize_end(EndInst &end_inst,
+                                      llvm::Use &use,
+                                      SeqFillInst &fill_inst) {
+  MemOIRBuilder builder(fill_inst);
+
+  auto *size_inst = builder.CreateSizeInst(&fill_inst.getBaseCollection());
+  MEMOIR_NULL_CHECK(size_inst,
+                    "Could not contextualize EndInst for SeqFillInst!");
+
+  use.set(&size_inst->getCallInst());
+
+  return size_inst->getCallInst();
+}
+
 static llvm::Value &contextualize_end(EndInst &end_inst,
                                       llvm::Use &use,
                                       CopyInst &copy_inst) {
@@ -449,6 +627,8 @@ void SSADestructionVisitor::visitEndInst(EndInst &I) {
       auto &contextualized = contextualize_end(I, use, *insert_inst);
     } else if (auto *remove_inst = into<RemoveInst>(user_as_inst)) {
       auto &contextualized = contextualize_end(I, use, *remove_inst);
+    } else if (auto *fill_inst = into<SeqFillInst>(user_as_inst)) {
+      auto &contextualized = contextualize_end(I, use, *fill_inst);
     } else if (auto *copy_inst = into<CopyInst>(user_as_inst)) {
       auto &contextualized = contextualize_end(I, use, *copy_inst);
     } else if (auto *swap_inst = into<SeqSwapInst>(user_as_inst)) {
@@ -486,6 +666,26 @@ void SSADestructionVisitor::visitIndexReadInst(IndexReadInst &I) {
     auto &element_type = collection_type.getElementType();
 
     if (auto *sequence_type = dyn_cast<SequenceType>(&collection_type)) {
+      // If we can, load the element directly through the data pointer.
+      if (auto *data =
+              this->get_data_pointer(*sequence_type, I.getObjectOperand())) {
+        auto *index = builder.CreateZExtOrBitCast(&I.getIndexOfDimension(0),
+                                                  builder.getInt64Ty());
+        auto *gep = builder.CreateInBoundsGEP(data, index);
+        auto *load = builder.CreateLoad(gep);
+        this->record_direct_access(I.getObjectOperand(), *load);
+
+        // Cast the element to the type of the original read, if needed.
+        auto *read_type = I.getCallInst().getType();
+        auto *value = (read_type == load->getType())
+                          ? load
+                          : builder.CreateBitOrPointerCast(load, read_type);
+
+        this->coalesce(I, *value);
+        this->markForCleanup(I);
+        return;
+      }
+
       // Fetch the vector read function.
       auto element_code = element_type.get_code();
       auto vector_read_name = *element_code + "_" SEQ_IMPL "__read";
@@ -644,6 +844,29 @@ void SSADestructionVisitor::visitIndexWriteInst(IndexWriteInst &I) {
 
   if (this->enable_collection_lowering) {
     if (auto *sequence_type = dyn_cast<SequenceType>(&collection_type)) {
+      // If we can, store the element directly through the data pointer.
+      if (auto *data =
+              this->get_data_pointer(*sequence_type, I.getObjectOperand())) {
+        auto *index = builder.CreateZExtOrBitCast(&I.getIndexOfDimension(0),
+                                                  builder.getInt64Ty());
+        auto *gep = builder.CreateInBoundsGEP(data, index);
+
+        auto *element_type =
+            cast<llvm::PointerType>(data->getType())->getElementType();
+        auto *write_value =
+            (isa<llvm::IntegerType>(element_type))
+                ? &I.getValueWritten()
+                : builder.CreateBitOrPointerCast(&I.getValueWritten(),
+                                                 element_type);
+
+        auto *store = builder.CreateStore(write_value, gep);
+        this->record_direct_access(I.getObjectOperand(), *store);
+
+        this->coalesce(I.getCollection(), I.getObjectOperand());
+        this->markForCleanup(I);
+        return;
+      }
+
       auto &element_type = collection_type.getElementType();
 
       auto element_code = element_type.get_code();
@@ -979,6 +1202,17 @@ void SSADestructionVisitor::visitStructReadInst(StructReadInst &I) {
     // Construct the load.
     llvm::Value *load = builder.CreateLoad(gep, /* isVolatile = */ false);
 
+    // If the field is a compressed reference, decompress it.
+    if (struct_layout.is_compressed_reference(field_index)) {
+      auto &field_type = struct_type.getFieldType(field_index);
+      auto &ref_type = cast<ReferenceType>(field_type);
+      auto &referenced_type = cast<StructType>(ref_type.getReferencedType());
+      load = &this->decompress_reference(builder,
+                                         referenced_type,
+                                         *load,
+                                         *I.getCallInst().getType());
+    }
+
     // If the field is a bit field, pay the bit twiddler their due.
     if (struct_layout.is_bit_field(field_index)) {
       // Fetch the bit field range.
@@ -996,9 +1230,9 @@ void SSADestructionVisitor::visitStructReadInst(StructReadInst &I) {
           is_signed = true;
 
           // Get the size of the containing bit field.
-          auto *llvm_field_type = I.getCallInst().getType();
+          auto *llvm_field_type = load->getType();
           auto *llvm_int_field_type = cast<llvm::IntegerType>(llvm_field_type);
-          auto llvm_field_width = int_field_type->getBitWidth();
+          auto llvm_field_width = llvm_int_field_type->getBitWidth();
 
           // SHIFT the bit field over to the top bits.
           auto left_shift_distance = llvm_field_width - bit_field_end;
@@ -1015,12 +1249,14 @@ void SSADestructionVisitor::visitStructReadInst(StructReadInst &I) {
         load = builder.CreateLShr(load, bit_field_start);
       }
 
-      // MASK the value.
-      uint64_t mask = 0;
-      for (int i = 0; i < bit_field_width; ++i) {
-        mask |= 1 << i;
+      // MASK the value, the arithmetic shift has already sign extended it.
+      if (!is_signed) {
+        uint64_t mask = 0;
+        for (unsigned i = 0; i < bit_field_width; ++i) {
+          mask |= uint64_t(1) << i;
+        }
+        load = builder.CreateAnd(load, mask);
       }
-      load = builder.CreateAnd(load, mask);
 
       // BITCAST the value, if needed.
       load = builder.CreateIntCast(load, I.getCallInst().getType(), is_signed);
@@ -1070,6 +1306,15 @@ void SSADestructionVisitor::visitStructWriteInst(StructWriteInst &I) {
     // Get the value being written.
     auto *value_written = &I.getValueWritten();
 
+    // If the field is a compressed reference, compress the value written.
+    if (struct_layout.is_compressed_reference(field_index)) {
+      auto &field_type = struct_type.getFieldType(field_index);
+      auto &ref_type = cast<ReferenceType>(field_type);
+      auto &referenced_type = cast<StructType>(ref_type.getReferencedType());
+      value_written =
+          &this->compress_reference(builder, referenced_type, *value_written);
+    }
+
     // If the field is a bit field, load the resident value, perform the
     // requisite bit twiddling, and then store the value.
     if (struct_layout.is_bit_field(field_index)) {
@@ -1088,7 +1333,7 @@ void SSADestructionVisitor::visitStructWriteInst(StructWriteInst &I) {
       uint64_t mask = 0;
       auto bit_field_width = bit_field_end - bit_field_start;
       for (unsigned i = 0; i < bit_field_width; ++i) {
-        mask |= 1 << i;
+        mask |= uint64_t(1) << i;
       }
       value_written = builder.CreateAnd(value_written, mask);
 
@@ -1100,7 +1345,7 @@ void SSADestructionVisitor::visitStructWriteInst(StructWriteInst &I) {
       // MASK out the bits from the loaded value.
       mask = 0;
       for (auto i = bit_field_start; i < bit_field_end; ++i) {
-        mask |= 1 << i;
+        mask |= uint64_t(1) << i;
       }
 
       load = builder.CreateAnd(load, ~mask);
@@ -1391,6 +1636,76 @@ void SSADestructionVisitor::visitSeqRemoveInst(SeqRemoveInst &I) {
   return;
 }
 
+void SSADestructionVisitor::visitSeqFillInst(SeqFillInst &I) {
+  auto &seq_type =
+      MEMOIR_SANITIZE(dyn_cast_or_null<SequenceType>(
+                          TypeAnalysis::analyze(I.getBaseCollection())),
+                      "Couldn't determine type of filled collection");
+
+  auto &elem_type = seq_type.getElementType();
+
+  MemOIRBuilder builder(I);
+
+  if (this->enable_collection_lowering) {
+    auto elem_code = elem_type.get_code();
+    auto name = *elem_code + "_" SEQ_IMPL "__fill";
+
+    auto *function = this->M.getFunction(name);
+    auto function_callee = FunctionCallee(function);
+    if (function == nullptr) {
+      warnln("Couldn't find function for ", name);
+      return;
+    }
+
+    auto *function_type = function_callee.getFunctionType();
+    auto *seq = builder.CreatePointerCast(&I.getBaseCollection(),
+                                          function_type->getParamType(0));
+    auto *begin =
+        builder.CreateBitOrPointerCast(&I.getBeginIndex(),
+                                       function_type->getParamType(1));
+    auto *end = builder.CreateBitOrPointerCast(&I.getEndIndex(),
+                                               function_type->getParamType(2));
+
+    auto *value_param_type = function_type->getParamType(3);
+    auto *value =
+        (isa<llvm::IntegerType>(value_param_type))
+            ? builder.CreateZExtOrTrunc(&I.getValueWritten(), value_param_type)
+            : builder.CreateBitOrPointerCast(&I.getValueWritten(),
+                                             value_param_type);
+
+    auto *llvm_call =
+        builder.CreateCall(function_callee,
+                           llvm::ArrayRef({ seq, begin, end, value }));
+    MEMOIR_NULL_CHECK(llvm_call, "Could not create the call for SeqFillInst");
+
+    // Coalesce the result with the input operand.
+    this->coalesce(I, I.getBaseCollection());
+
+    // Mark the old instruction for cleanup.
+    this->markForCleanup(I);
+  } else {
+    // Get operands.
+    auto &value_written = I.getValueWritten();
+    auto &collection = I.getBaseCollection();
+    auto &begin_index = I.getBeginIndex();
+    auto &end_index = I.getEndIndex();
+
+    // Construct the Mut instruction.
+    auto *mut_inst = builder.CreateMutSeqFillInst(elem_type,
+                                                  &value_written,
+                                                  &collection,
+                                                  &begin_index,
+                                                  &end_index);
+
+    // Coalesce the original collection with the operand.
+    this->coalesce(I, collection);
+
+    // Cleanup the old instruction.
+    this->markForCleanup(I);
+  }
+  return;
+}
+
 void SSADestructionVisitor::visitSeqCopyInst(SeqCopyInst &I) {
   MemOIRBuilder builder(I);
 
@@ -1917,6 +2232,310 @@ void SSADestructionVisitor::visitTypeInst(TypeInst &I) {
   return;
 }
 
+// Direct sequence access implementation.
+/*
+ * In direct access mode, index reads and writes on a sequence are lowered to a
+ * load/store through the data pointer of its storage. The data pointer (and
+ * size) is only invalidated by operations that resize the sequence, so we
+ * compute it once at the definition of the storage root, i.e. the closest
+ * resizing definition along the SSA def chain. For loops that do not resize
+ * the sequence this lands outside of the loop, leaving the loop body with
+ * plain GEP+load/store that LLVM is able to vectorize.
+ */
+static llvm::Instruction *definition_insertion_point(llvm::Value &V) {
+  if (auto *arg = dyn_cast<llvm::Argument>(&V)) {
+    return &*(arg->getParent()->getEntryBlock().getFirstInsertionPt());
+  } else if (auto *phi = dyn_cast<llvm::PHINode>(&V)) {
+    return &*(phi->getParent()->getFirstInsertionPt());
+  } else if (auto *inst = dyn_cast<llvm::Instruction>(&V)) {
+    if (inst->isTerminator()) {
+      return nullptr;
+    }
+    return inst->getNextNode();
+  }
+  return nullptr;
+}
+
+static llvm::Value *find_storage_root_helper(llvm::Value &V,
+                                             set<llvm::Value *> &visited) {
+  // If we have already visited this value, it imposes no new constraint.
+  if (visited.count(&V) > 0) {
+    return nullptr;
+  }
+  visited.insert(&V);
+
+  // PHIs preserve the storage if all incoming values share the same root.
+  if (auto *phi = dyn_cast<llvm::PHINode>(&V)) {
+    llvm::Value *root = nullptr;
+    for (auto &incoming : phi->incoming_values()) {
+      auto *incoming_root = find_storage_root_helper(*incoming.get(), visited);
+      if (incoming_root == nullptr || incoming_root == root) {
+        continue;
+      } else if (root == nullptr) {
+        root = incoming_root;
+      } else {
+        return phi;
+      }
+    }
+    return (root == nullptr) ? phi : root;
+  }
+
+  // Writes and uses do not resize the sequence.
+  if (auto *write_inst = into<IndexWriteInst>(&V)) {
+    return find_storage_root_helper(write_inst->getObjectOperand(), visited);
+  } else if (auto *use_phi = into<UsePHIInst>(&V)) {
+    return find_storage_root_helper(use_phi->getUsedCollection(), visited);
+  }
+
+  // Otherwise, this value may have new storage.
+  return &V;
+}
+
+llvm::Value &SSADestructionVisitor::find_storage_root(llvm::Value &V) {
+  set<llvm::Value *> visited = {};
+  auto *root = find_storage_root_helper(V, visited);
+  return (root == nullptr) ? V : *root;
+}
+
+llvm::Value *SSADestructionVisitor::find_allocation(llvm::Value &V) {
+  set<llvm::Value *> visited = {};
+  list<llvm::Value *> worklist = { &V };
+  llvm::Value *allocation = nullptr;
+
+  while (!worklist.empty()) {
+    auto *value = worklist.front();
+    worklist.pop_front();
+
+    if (visited.count(value) > 0) {
+      continue;
+    }
+    visited.insert(value);
+
+    if (auto *phi = dyn_cast<llvm::PHINode>(value)) {
+      for (auto &incoming : phi->incoming_values()) {
+        worklist.push_back(incoming.get());
+      }
+    } else if (auto *write_inst = into<IndexWriteInst>(value)) {
+      worklist.push_back(&write_inst->getObjectOperand());
+    } else if (auto *use_phi = into<UsePHIInst>(value)) {
+      worklist.push_back(&use_phi->getUsedCollection());
+    } else if (auto *insert_inst = into<InsertInst>(value)) {
+      worklist.push_back(&insert_inst->getBaseCollection());
+    } else if (auto *remove_inst = into<RemoveInst>(value)) {
+      worklist.push_back(&remove_inst->getBaseCollection());
+    } else if (into<SequenceAllocInst>(value) && allocation == nullptr) {
+      allocation = value;
+    } else {
+      // Either the storage escapes our view, or it comes from more than one
+      // allocation.
+      return nullptr;
+    }
+  }
+
+  return allocation;
+}
+
+llvm::Value *SSADestructionVisitor::get_data_pointer(SequenceType &type,
+                                                     llvm::Value &V) {
+  if (!this->enable_direct_seq_access) {
+    return nullptr;
+  }
+
+  // Boolean sequences are bit-packed by the backend, so they have no data
+  // pointer to access directly.
+  auto &element_type = type.getElementType();
+  if (auto *integer_type = dyn_cast<IntegerType>(&element_type)) {
+    if (integer_type->getBitWidth() == 1) {
+      return nullptr;
+    }
+  }
+
+  // If we have already fetched the data pointer for this storage, reuse it.
+  auto &root = this->find_storage_root(V);
+  auto found = this->seq_data_pointers.find(&root);
+  if (found != this->seq_data_pointers.end()) {
+    return found->second;
+  }
+
+  auto element_code = element_type.get_code();
+  auto name = *element_code + "_" SEQ_IMPL "__data";
+
+  auto *function = this->M.getFunction(name);
+  auto function_callee = FunctionCallee(function);
+  if (function == nullptr) {
+    warnln("Couldn't find vector data for ", name);
+    return nullptr;
+  }
+
+  auto *insertion_point = definition_insertion_point(root);
+  if (insertion_point == nullptr) {
+    return nullptr;
+  }
+
+  // Fetch the data pointer at the definition of the storage.
+  MemOIRBuilder builder(insertion_point);
+
+  auto *function_type = function_callee.getFunctionType();
+  auto *vector_value =
+      builder.CreatePointerCast(&root, function_type->getParamType(0));
+  auto *llvm_call =
+      builder.CreateCall(function_callee, llvm::ArrayRef({ vector_value }));
+  MEMOIR_NULL_CHECK(llvm_call, "Could not create the call for vector data");
+
+  this->seq_data_pointers[&root] = llvm_call;
+
+  return llvm_call;
+}
+
+llvm::Value *SSADestructionVisitor::get_size(SequenceType &type,
+                                             llvm::Value &V) {
+  if (!this->enable_direct_seq_access) {
+    return nullptr;
+  }
+
+  // If we have already fetched the size for this storage, reuse it.
+  auto &root = this->find_storage_root(V);
+  auto found = this->seq_sizes.find(&root);
+  if (found != this->seq_sizes.end()) {
+    return found->second;
+  }
+
+  auto element_code = type.getElementType().get_code();
+  auto name = *element_code + "_" SEQ_IMPL "__size";
+
+  auto *function = this->M.getFunction(name);
+  auto function_callee = FunctionCallee(function);
+  if (function == nullptr) {
+    return nullptr;
+  }
+
+  auto *insertion_point = definition_insertion_point(root);
+  if (insertion_point == nullptr) {
+    return nullptr;
+  }
+
+  // Fetch the size at the definition of the storage.
+  MemOIRBuilder builder(insertion_point);
+
+  auto *function_type = function_callee.getFunctionType();
+  auto *vector_value =
+      builder.CreatePointerCast(&root, function_type->getParamType(0));
+  auto *llvm_call =
+      builder.CreateCall(function_callee, llvm::ArrayRef({ vector_value }));
+  MEMOIR_NULL_CHECK(llvm_call, "Could not create the call for vector size");
+
+  this->seq_sizes[&root] = llvm_call;
+
+  return llvm_call;
+}
+
+void SSADestructionVisitor::record_direct_access(llvm::Value &V,
+                                                 llvm::Instruction &access) {
+  // We can only reason about aliasing if the storage comes from a single
+  // allocation in this function.
+  if (auto *allocation = this->find_allocation(V)) {
+    this->direct_accesses[allocation].push_back(&access);
+  }
+}
+
+llvm::Value &SSADestructionVisitor::get_arena_base(MemOIRBuilder &builder,
+                                                   StructType &type) {
+  // Get the global holding the base address of the arena.
+  auto base_name = ImplLinker::get_arena_prefix(type) + "__base";
+  auto *base_type = builder.getInt8PtrTy();
+  auto *base_global = this->M.getOrInsertGlobal(base_name, base_type);
+
+  // Load the base address.
+  return MEMOIR_SANITIZE(builder.CreateLoad(base_type, base_global),
+                         "Could not load the arena base");
+}
+
+llvm::Value &SSADestructionVisitor::compress_reference(
+    MemOIRBuilder &builder,
+    StructType &referenced_type,
+    llvm::Value &reference) {
+  auto &data_layout = this->M.getDataLayout();
+  auto *int_ptr_type = builder.getIntPtrTy(data_layout);
+  auto *offset_type = builder.getInt32Ty();
+
+  // Compute the offset of the reference from the base of the arena.
+  auto &base = this->get_arena_base(builder, referenced_type);
+  auto *reference_int = builder.CreatePtrToInt(&reference, int_ptr_type);
+  auto *base_int = builder.CreatePtrToInt(&base, int_ptr_type);
+  auto *offset = builder.CreateTrunc(builder.CreateSub(reference_int, base_int),
+                                     offset_type);
+
+  // Null references are stored as offset 0.
+  auto *is_null = builder.CreateIsNull(&reference);
+  auto *null_offset = llvm::ConstantInt::get(offset_type, 0);
+  return MEMOIR_SANITIZE(builder.CreateSelect(is_null, null_offset, offset),
+                         "Could not compress the reference");
+}
+
+llvm::Value &SSADestructionVisitor::decompress_reference(
+    MemOIRBuilder &builder,
+    StructType &referenced_type,
+    llvm::Value &offset,
+    llvm::Type &reference_type) {
+  auto &data_layout = this->M.getDataLayout();
+  auto *int_ptr_type = builder.getIntPtrTy(data_layout);
+
+  // Add the offset to the base of the arena.
+  auto &base = this->get_arena_base(builder, referenced_type);
+  auto *extended_offset = builder.CreateZExt(&offset, int_ptr_type);
+  auto *address = builder.CreateInBoundsGEP(&base, extended_offset);
+  auto *reference = builder.CreatePointerCast(address, &reference_type);
+
+  // Offset 0 is the null reference.
+  auto *is_null = builder.CreateIsNull(&offset);
+  auto *null_reference =
+      llvm::ConstantPointerNull::get(cast<llvm::PointerType>(&reference_type));
+  auto *decompressed = builder.CreateSelect(is_null, null_reference, reference);
+  return MEMOIR_SANITIZE(decompressed, "Could not decompress the reference");
+}
+
+void SSADestructionVisitor::annotate_direct_accesses() {
+  // Distinct allocations never share storage, so we give each of them an alias
+  // scope and mark their accesses as noalias with all other allocations.
+  if (this->direct_accesses.size() > 1) {
+    auto &context = this->M.getContext();
+    llvm::MDBuilder md_builder(context);
+
+    auto *domain = md_builder.createAnonymousAliasScopeDomain("memoir.seq");
+
+    vector<llvm::MDNode *> scopes = {};
+    for (auto &[allocation, accesses] : this->direct_accesses) {
+      scopes.push_back(md_builder.createAnonymousAliasScope(domain));
+    }
+
+    unsigned scope_idx = 0;
+    for (auto &[allocation, accesses] : this->direct_accesses) {
+      auto *scope = scopes[scope_idx];
+
+      vector<llvm::Metadata *> other_scopes = {};
+      for (auto *other_scope : scopes) {
+        if (other_scope != scope) {
+          other_scopes.push_back(other_scope);
+        }
+      }
+
+      auto *scope_list = llvm::MDNode::get(context, { scope });
+      auto *noalias_list = llvm::MDNode::get(context, other_scopes);
+
+      for (auto *access : accesses) {
+        access->setMetadata(llvm::LLVMContext::MD_alias_scope, scope_list);
+        access->setMetadata(llvm::LLVMContext::MD_noalias, noalias_list);
+      }
+
+      ++scope_idx;
+    }
+  }
+
+  this->direct_accesses.clear();
+
+  return;
+}
+
 // Logistics implementation.
 void SSADestructionVisitor::cleanup() {
   for (auto *inst : instructions_to_delete) {
@@ -58,7 +58,8 @@ class SSADestructionVisitor
 public:
   SSADestructionVisitor(llvm::Module &M,
                         SSADestructionStats *stats = nullptr,
-                        bool enable_collection_lowering = false);
+                        bool enable_collection_lowering = false,
+                        bool enable_direct_seq_access = false);
 
   void setAnalyses(llvm::DominatorTree &DT, LivenessAnalysis &LA);
 
@@ -71,8 +72,12 @@ public:
   void visitStructAllocInst(StructAllocInst &I);
 
   // Deallocation operationts
+  void visitDeleteStructInst(DeleteStructInst &I);
   void visitDeleteCollectionInst(DeleteCollectionInst &I);
 
+  // Clear operations
+  void visitClearInst(ClearInst &I);
+
   // Access operations
   //// Index accesses
   void visitIndexReadInst(IndexReadInst &I);
@@ -92,6 +97,7 @@ public:
   void visitSeqInsertInst(SeqInsertInst &I);
   void visitSeqInsertSeqInst(SeqInsertSeqInst &I);
   void visitSeqRemoveInst(SeqRemoveInst &I);
+  void visitSeqFillInst(SeqFillInst &I);
   void visitSeqCopyInst(SeqCopyInst &I);
   void visitSeqSwapInst(SeqSwapInst &I);
   void visitSeqSwapWithinInst(SeqSwapWithinInst &I);
@@ -108,6 +114,7 @@ public:
   void visitRetPHIInst(RetPHIInst &I);
   void visitSizeInst(SizeInst &I);
   void visitEndInst(EndInst &I);
+  void visitSeqReserveInst(SeqReserveInst &I);
 
   // Typechecking
   void visitTypeInst(TypeInst &I);
@@ -117,6 +124,8 @@ public:
 
   void do_coalesce(llvm::Value &V);
 
+  void annotate_direct_accesses();
+
   void cleanup();
 
 protected:
@@ -129,6 +138,12 @@ protected:
   // Owned state.
   map<MemOIRInst *, detail::View *> inst_to_view;
   bool enable_collection_lowering;
+  bool enable_direct_seq_access;
+
+  // Direct sequence access state, reset for each function.
+  map<llvm::Value *, llvm::Value *> seq_data_pointers;
+  map<llvm::Value *, llvm::Value *> seq_sizes;
+  llvm::MapVector<llvm::Value *, list<llvm::Instruction *>> direct_accesses;
 
   // Borrowed state.
   map<llvm::Value *, llvm::Value *> coalesced_values;
@@ -145,6 +160,23 @@ protected:
   void markForCleanup(MemOIRInst &I);
   void markForCleanup(llvm::Instruction &I);
 
+  // Direct sequence access helpers.
+  llvm::Value &find_storage_root(llvm::Value &V);
+  llvm::Value *find_allocation(llvm::Value &V);
+  llvm::Value *get_data_pointer(SequenceType &type, llvm::Value &V);
+  llvm::Value *get_size(SequenceType &type, llvm::Value &V);
+  void record_direct_access(llvm::Value &V, llvm::Instruction &access);
+
+  // Compressed reference helpers.
+  llvm::Value &get_arena_base(MemOIRBuilder &builder, StructType &type);
+  llvm::Value &compress_reference(MemOIRBuilder &builder,
+                                  StructType &referenced_type,
+                                  llvm::Value &reference);
+  llvm::Value &decompress_reference(MemOIRBuilder &builder,
+                                    StructType &referenced_type,
+                                    llvm::Value &offset,
+                                    llvm::Type &reference_type);
+
   // Statistics
   SSADestructionStats *stats;
 };
@@ -124,6 +124,14 @@ public:
     stats.inc_ssa();
   }
 
+  void visitSeqFillInst(SeqFillInst &I) {
+    stats.inc_ssa();
+  }
+
+  void visitClearInst(ClearInst &I) {
+    stats.inc_ssa();
+  }
+
   void visitCopyInst(CopyInst &I) {
     stats.inc_mut();
   }
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/ValueNumbering.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+#include "StoreForwarding.hpp"
+
+namespace llvm::memoir {
+
+/*
+ * This pass forwards values written to collection elements to their reads.
+ */
+
+struct StoreForwardingPass : public ModulePass {
+  static char ID;
+
+  StoreForwardingPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN store forwarding pass");
+    infoln();
+
+    ValueNumbering VN(M);
+
+    // Forwarding only erases reads, whose type analysis entries are dropped
+    // along with them, so no results need to be invalidated.
+    StoreForwarding SF(M, VN);
+
+    infoln();
+    infoln("END store forwarding pass");
+    infoln("========================");
+
+    return SF.transformed();
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    return;
+  }
+};
+
+// Next there is code to register your pass to "opt"
+char StoreForwardingPass::ID = 0;
+static llvm::RegisterPass<StoreForwardingPass> X(
+    "memoir-sf",
+    "Forwards values written to collection elements to their reads.");
+
+} // namespace llvm::memoir
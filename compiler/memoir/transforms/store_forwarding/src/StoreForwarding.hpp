@@ -0,0 +1,225 @@
+#ifndef MEMOIR_STOREFORWARDING_H
+#define MEMOIR_STOREFORWARDING_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+// MemOIR
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/ValueExpression.hpp"
+#include "memoir/analysis/ValueNumbering.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/Casting.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class forwards the value written to a collection element to the
+ * reads of that same element.
+ *
+ * Starting from the collection being read, we walk back through the SSA
+ * versions of the collection. Writes, insertions and removals of elements
+ * that are provably distinct from the one being read are skipped over. If
+ * we reach a write to an equal index or key, the read is replaced with the
+ * value written.
+ */
+
+namespace llvm::memoir {
+
+class StoreForwarding {
+public:
+  /**
+   * Forwards stored values to reads of collection elements in the program
+   * @M, using @VN to determine the equality of indices and keys.
+   */
+  StoreForwarding(llvm::Module &M, ValueNumbering &VN) : M(M), VN(VN) {
+    this->_transformed = this->run();
+  }
+
+  /**
+   * Queries wether the transformation modified the program or not.
+   */
+  bool transformed() const {
+    return this->_transformed;
+  }
+
+protected:
+  enum Alias { MUST, NO, MAY };
+
+  // Top-level driver.
+  bool run() {
+    // Gather all of the reads in the program.
+    vector<MemOIRInst *> reads = {};
+    for (auto &F : this->M) {
+      for (auto &BB : F) {
+        for (auto &I : BB) {
+          if (auto *read_inst = into<IndexReadInst>(I)) {
+            reads.push_back(read_inst);
+          } else if (auto *read_inst = into<AssocReadInst>(I)) {
+            reads.push_back(read_inst);
+          }
+        }
+      }
+    }
+
+    // Forward the written value to each read, if we can.
+    vector<llvm::Instruction *> forwarded = {};
+    for (auto *read_inst : reads) {
+      auto &read = read_inst->getCallInst();
+
+      auto *value = this->find_stored_value(*read_inst);
+      if (value == nullptr || value->getType() != read.getType()) {
+        continue;
+      }
+
+      infoln("Forwarding ", *value);
+      infoln("  to ", read);
+
+      read.replaceAllUsesWith(value);
+      forwarded.push_back(&read);
+    }
+
+    for (auto *read : forwarded) {
+      read->eraseFromParent();
+    }
+
+    if (!forwarded.empty()) {
+      MemOIRInst::invalidate();
+    }
+
+    return !forwarded.empty();
+  }
+
+  // Analysis.
+  Alias alias(ValueExpression *key1, ValueExpression *key2) {
+    if (key1 == nullptr || key2 == nullptr) {
+      return MAY;
+    } else if (key1 == key2 || key1->equals(*key2)) {
+      return MUST;
+    } else if (is_distinct(*key1, *key2)) {
+      return NO;
+    }
+    return MAY;
+  }
+
+  Alias alias(vector<ValueExpression *> &indices1,
+              vector<ValueExpression *> &indices2) {
+    if (indices1.size() != indices2.size()) {
+      return MAY;
+    }
+
+    // If any dimension is distinct, the elements are distinct. If every
+    // dimension is equal, the elements are the same.
+    auto result = MUST;
+    for (unsigned dim_idx = 0; dim_idx < indices1.size(); ++dim_idx) {
+      auto dim_alias = this->alias(indices1[dim_idx], indices2[dim_idx]);
+      if (dim_alias == NO) {
+        return NO;
+      } else if (dim_alias == MAY) {
+        result = MAY;
+      }
+    }
+
+    return result;
+  }
+
+  vector<ValueExpression *> get_indices(IndexReadInst &I) {
+    vector<ValueExpression *> indices = {};
+    for (unsigned dim_idx = 0; dim_idx < I.getNumberOfDimensions();
+         ++dim_idx) {
+      indices.push_back(this->VN.get(I.getIndexOfDimension(dim_idx)));
+    }
+    return indices;
+  }
+
+  vector<ValueExpression *> get_indices(IndexWriteInst &I) {
+    vector<ValueExpression *> indices = {};
+    for (unsigned dim_idx = 0; dim_idx < I.getNumberOfDimensions();
+         ++dim_idx) {
+      indices.push_back(this->VN.get(I.getIndexOfDimension(dim_idx)));
+    }
+    return indices;
+  }
+
+  /**
+   * Walks back from the collection read by @read_inst to find the value
+   * last written to the element being read.
+   * Returns NULL if the value could not be determined.
+   */
+  llvm::Value *find_stored_value(MemOIRInst &read_inst) {
+    llvm::Value *collection = nullptr;
+    if (auto *index_read = dyn_cast<IndexReadInst>(&read_inst)) {
+      auto indices = this->get_indices(*index_read);
+      collection = &index_read->getObjectOperand();
+
+      while (collection != nullptr) {
+        if (auto *write_inst = into<IndexWriteInst>(collection)) {
+          auto write_indices = this->get_indices(*write_inst);
+          auto result = this->alias(indices, write_indices);
+          if (result == MUST) {
+            return &write_inst->getValueWritten();
+          } else if (result == MAY) {
+            return nullptr;
+          }
+          collection = &write_inst->getObjectOperand();
+        } else if (auto *use_phi = into<UsePHIInst>(collection)) {
+          collection = &use_phi->getUsedCollection();
+        } else {
+          return nullptr;
+        }
+      }
+    } else if (auto *assoc_read = dyn_cast<AssocReadInst>(&read_inst)) {
+      auto *key = this->VN.get(assoc_read->getKeyOperand());
+      collection = &assoc_read->getObjectOperand();
+
+      while (collection != nullptr) {
+        if (auto *write_inst = into<AssocWriteInst>(collection)) {
+          auto result =
+              this->alias(key, this->VN.get(write_inst->getKeyOperand()));
+          if (result == MUST) {
+            return &write_inst->getValueWritten();
+          } else if (result == MAY) {
+            return nullptr;
+          }
+          collection = &write_inst->getObjectOperand();
+        } else if (auto *insert_inst = into<AssocInsertInst>(collection)) {
+          auto result =
+              this->alias(key, this->VN.get(insert_inst->getInsertionPoint()));
+          if (result != NO) {
+            return nullptr;
+          }
+          collection = &insert_inst->getBaseCollection();
+        } else if (auto *remove_inst = into<AssocRemoveInst>(collection)) {
+          auto result = this->alias(key, this->VN.get(remove_inst->getKey()));
+          if (result != NO) {
+            return nullptr;
+          }
+          collection = &remove_inst->getBaseCollection();
+        } else if (auto *use_phi = into<UsePHIInst>(collection)) {
+          collection = &use_phi->getUsedCollection();
+        } else {
+          return nullptr;
+        }
+      }
+    }
+
+    return nullptr;
+  }
+
+  // Owned state.
+  bool _transformed;
+
+  // Borrowed state.
+  llvm::Module &M;
+  ValueNumbering &VN;
+};
+
+} // namespace llvm::memoir
+
+#endif
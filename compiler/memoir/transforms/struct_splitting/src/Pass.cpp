@@ -0,0 +1,99 @@
+#include <iostream>
+#include <string>
+
+// LLVM
+#include "llvm/IR/Function.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Metadata.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+
+// MemOIR
+#include "memoir/ir/InstVisitor.hpp"
+#include "memoir/ir/Instructions.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+// Struct Splitting
+#include "StructSplitting.hpp"
+
+using namespace llvm::memoir;
+
+/*
+ * This pass splits the cold fields of struct types into an out-of-line struct,
+ * using profile counts of the field accesses.
+ */
+
+static llvm::cl::opt<double> SplitColdRatio(
+    "split-cold-ratio",
+    llvm::cl::desc("Fields accessed at most this fraction as often as the "
+                   "hottest field of their struct are split out as cold"),
+    llvm::cl::init(0.05));
+
+namespace llvm::memoir {
+
+struct StructSplittingPass : public ModulePass {
+  static char ID;
+
+  StructSplittingPass() : ModulePass(ID) {}
+
+  bool doInitialization(llvm::Module &M) override {
+    return false;
+  }
+
+  bool runOnModule(llvm::Module &M) override {
+    infoln("========================");
+    infoln("BEGIN struct splitting pass");
+    infoln();
+
+    // Collect the profile count of each basic block.
+    StructSplitting::BlockCountsTy block_counts = {};
+    for (auto &F : M) {
+      if (F.empty()) {
+        continue;
+      }
+
+      auto &BFI = getAnalysis<llvm::BlockFrequencyInfoWrapperPass>(F).getBFI();
+      for (auto &BB : F) {
+        if (auto profile_count = BFI.getBlockProfileCount(&BB)) {
+          block_counts[&BB] = *profile_count;
+        }
+      }
+    }
+
+    auto SS = StructSplitting(M, block_counts, SplitColdRatio);
+
+    // Splitting changes the struct types, drop all cached types.
+    if (SS.transformed) {
+      TypeAnalysis::invalidate();
+    }
+
+    infoln();
+    infoln("END struct splitting pass");
+    infoln("========================");
+
+    return SS.transformed;
+  }
+
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override {
+    AU.addRequired<llvm::BlockFrequencyInfoWrapperPass>();
+    return;
+  }
+};
+
+} // namespace llvm::memoir
+
+// Next there is code to register your pass to "opt"
+char StructSplittingPass::ID = 0;
+static RegisterPass<StructSplittingPass> X(
+    "memoir-split",
+    "Splits cold fields out of struct types using profile counts.");
@@ -0,0 +1,435 @@
+#ifndef MEMOIR_STRUCTSPLITTING_H
+#define MEMOIR_STRUCTSPLITTING_H
+#pragma once
+
+// LLVM
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+
+// MemOIR
+#include "memoir/ir/Builder.hpp"
+#include "memoir/ir/Instructions.hpp"
+#include "memoir/ir/Types.hpp"
+
+#include "memoir/analysis/TypeAnalysis.hpp"
+
+#include "memoir/support/Assert.hpp"
+#include "memoir/support/InternalDatatypes.hpp"
+#include "memoir/support/Print.hpp"
+
+/*
+ * This class splits the cold fields of a struct type into an out-of-line cold
+ * struct, reached through a reference stored in the last field of the hot
+ * struct.
+ *
+ * The hotness of each field is the sum of the profile counts of its
+ * Struct{Read,Write,Get}Inst sites. A field is cold if its count is no more
+ * than the cold ratio times the count of the hottest field of its struct.
+ * Fields with an access that has no profile count are kept hot, so a partial
+ * profile never moves a field out of line. Without profile counts for a
+ * struct type's accesses, it is left untouched.
+ *
+ * Struct types are only split if every struct of that type is allocated by a
+ * StructAllocInst and does not escape, so that we can allocate the cold struct
+ * alongside it.
+ */
+
+namespace llvm::memoir {
+
+class StructSplitting {
+  using AccessSetTy = set<AccessInst *>;
+  using FieldToAccessMapTy = map<unsigned, AccessSetTy>;
+  using FieldToCountMapTy = map<unsigned, uint64_t>;
+  using StructTypeSetTy = set<StructType *>;
+  using IndexListTy = vector<unsigned>;
+
+public:
+  using BlockCountsTy = map<llvm::BasicBlock *, uint64_t>;
+
+  bool transformed;
+
+  /**
+   * Splits the struct types of @M.
+   * @block_counts holds the profile count of each basic block, it is used for
+   * accesses that do not have a profile count of their own.
+   */
+  StructSplitting(llvm::Module &M,
+                  const BlockCountsTy &block_counts,
+                  double cold_ratio)
+    : M(M),
+      block_counts(block_counts),
+      cold_ratio(cold_ratio) {
+    this->transformed = this->run();
+  }
+
+protected:
+  struct TypeInfo {
+    FieldToAccessMapTy accesses;
+    FieldToCountMapTy counts;
+    set<unsigned> unprofiled;
+    set<StructAllocInst *> allocations;
+    set<DeleteStructInst *> deletions;
+    bool has_profile = false;
+  };
+
+  // Top-level driver.
+  bool run() {
+    this->analyze();
+
+    bool transformed = false;
+    for (auto &[struct_type, type_info] : this->type_info) {
+      if (this->unsplittable.count(struct_type) > 0) {
+        continue;
+      }
+
+      transformed |= this->split(*struct_type, type_info);
+    }
+
+    // Cleanup instructions.
+    for (auto *inst : this->instructions_to_delete) {
+      inst->eraseFromParent();
+    }
+
+    return transformed;
+  }
+
+  // Helpers
+  static inline bool value_escapes(llvm::Value &V) {
+    for (auto *user : V.users()) {
+      if (auto *user_as_call = dyn_cast_or_null<llvm::CallBase>(user)) {
+        // If the user is a memoir instruction, continue.
+        if (auto *user_as_memoir = MemOIRInst::get(*user_as_call)) {
+          continue;
+        }
+
+        // Get the called function.
+        auto *called_function = user_as_call->getCalledFunction();
+
+        // If it is an indirect call, then the value escapes.
+        if (called_function == nullptr) {
+          return true;
+        }
+
+        // If it is empty, then the value escapes.
+        if (called_function->empty()) {
+          return true;
+        }
+      }
+    }
+
+    return false;
+  }
+
+  // Returns the profile count of the instruction, if there is one.
+  opt<uint64_t> get_profile_count(llvm::Instruction &I) const {
+    // Prefer the count attached to the call site.
+    uint64_t total_weight;
+    if (I.extractProfTotalWeight(total_weight)) {
+      return total_weight;
+    }
+
+    // Otherwise, use the count of its basic block.
+    auto found = this->block_counts.find(I.getParent());
+    if (found != this->block_counts.end()) {
+      return found->second;
+    }
+
+    return {};
+  }
+
+  static unsigned get_field_index(AccessInst &access) {
+    if (auto *struct_read = dyn_cast<StructReadInst>(&access)) {
+      return struct_read->getFieldIndex();
+    } else if (auto *struct_write = dyn_cast<StructWriteInst>(&access)) {
+      return struct_write->getFieldIndex();
+    } else if (auto *struct_get = dyn_cast<StructGetInst>(&access)) {
+      return struct_get->getFieldIndex();
+    }
+    MEMOIR_UNREACHABLE("Access is not a Struct{Read,Write,Get}Inst!");
+  }
+
+  static llvm::Use &get_field_index_use(AccessInst &access) {
+    if (auto *struct_read = dyn_cast<StructReadInst>(&access)) {
+      return struct_read->getFieldIndexOperandAsUse();
+    } else if (auto *struct_write = dyn_cast<StructWriteInst>(&access)) {
+      return struct_write->getFieldIndexOperandAsUse();
+    } else if (auto *struct_get = dyn_cast<StructGetInst>(&access)) {
+      return struct_get->getFieldIndexOperandAsUse();
+    }
+    MEMOIR_UNREACHABLE("Access is not a Struct{Read,Write,Get}Inst!");
+  }
+
+  void analyze_value(llvm::Value &V) {
+    // Check if this value is a struct type.
+    if (!Type::value_is_struct_type(V)) {
+      return;
+    }
+
+    // Get the type of this struct.
+    auto *struct_type = dyn_cast_or_null<StructType>(TypeAnalysis::analyze(V));
+    MEMOIR_NULL_CHECK(struct_type,
+                      "Could not determine the StructType of a struct value!");
+
+    // If the struct escapes, we cannot split its type.
+    if (value_escapes(V)) {
+      infoln("Value escapes! ", V);
+      this->unsplittable.insert(struct_type);
+      return;
+    }
+
+    // If the struct is nested within another object, it was not allocated by
+    // a StructAllocInst, so we cannot split its type.
+    if (auto *inst = dyn_cast<llvm::Instruction>(&V)) {
+      if (dyn_cast_or_null<GetInst>(MemOIRInst::get(*inst)) != nullptr) {
+        this->unsplittable.insert(struct_type);
+        return;
+      }
+    }
+
+    auto &type_info = this->type_info[struct_type];
+
+    // Gather the field accesses of this struct.
+    for (auto *user : V.users()) {
+      auto *user_as_inst = dyn_cast<llvm::Instruction>(user);
+      if (user_as_inst == nullptr) {
+        continue;
+      }
+
+      auto *access =
+          dyn_cast_or_null<AccessInst>(MemOIRInst::get(*user_as_inst));
+      if (access == nullptr) {
+        continue;
+      }
+
+      if (!isa<StructReadInst>(access) && !isa<StructWriteInst>(access)
+          && !isa<StructGetInst>(access)) {
+        continue;
+      }
+
+      // Skip uses of the struct as the value being written.
+      if (&access->getObjectOperand() != &V) {
+        continue;
+      }
+
+      auto field_index = get_field_index(*access);
+      type_info.accesses[field_index].insert(access);
+
+      auto &count = type_info.counts[field_index];
+      if (auto profile_count = this->get_profile_count(*user_as_inst)) {
+        count += *profile_count;
+        type_info.has_profile = true;
+      } else {
+        type_info.unprofiled.insert(field_index);
+      }
+    }
+  }
+
+  // Analysis
+  void analyze() {
+    for (auto &F : this->M) {
+      // Ignore function declarations.
+      if (F.empty()) {
+        continue;
+      }
+
+      // Check the arguments.
+      for (auto &A : F.args()) {
+        this->analyze_value(A);
+      }
+
+      // Check the function.
+      for (auto &BB : F) {
+        for (auto &I : BB) {
+          this->analyze_value(I);
+
+          auto *memoir_inst = MemOIRInst::get(I);
+          if (auto *alloc_inst =
+                  dyn_cast_or_null<StructAllocInst>(memoir_inst)) {
+            auto &struct_type = alloc_inst->getStructType();
+            this->type_info[&struct_type].allocations.insert(alloc_inst);
+          } else if (auto *delete_inst =
+                         dyn_cast_or_null<DeleteStructInst>(memoir_inst)) {
+            auto *struct_type = dyn_cast_or_null<StructType>(
+                TypeAnalysis::analyze(delete_inst->getDeletedStruct()));
+            MEMOIR_NULL_CHECK(struct_type,
+                              "Could not determine the StructType of a "
+                              "deleted struct!");
+            this->type_info[struct_type].deletions.insert(delete_inst);
+          }
+        }
+      }
+    }
+  }
+
+  // Transformation
+  bool split(StructType &struct_type, TypeInfo &type_info) {
+    if (!type_info.has_profile) {
+      debugln("No profile counts for ", struct_type.getName());
+      return false;
+    }
+
+    if (type_info.allocations.empty()) {
+      return false;
+    }
+
+    // Find the count of the hottest field.
+    uint64_t max_count = 0;
+    for (auto const &[field_index, count] : type_info.counts) {
+      max_count = std::max(max_count, count);
+    }
+
+    // Partition the fields into hot and cold.
+    auto num_fields = struct_type.getNumFields();
+    IndexListTy hot_fields = {};
+    IndexListTy cold_fields = {};
+    for (unsigned field_index = 0; field_index < num_fields; ++field_index) {
+      auto found_count = type_info.counts.find(field_index);
+
+      // Unaccessed fields are left to dead field elimination, and fields
+      // with unprofiled accesses may be hot.
+      if (found_count == type_info.counts.end()
+          || type_info.unprofiled.count(field_index) > 0) {
+        hot_fields.push_back(field_index);
+        continue;
+      }
+
+      auto count = found_count->second;
+      if (count <= this->cold_ratio * max_count) {
+        cold_fields.push_back(field_index);
+      } else {
+        hot_fields.push_back(field_index);
+      }
+    }
+
+    if (cold_fields.empty() || hot_fields.empty()) {
+      return false;
+    }
+
+    infoln("Splitting ",
+           cold_fields.size(),
+           " cold fields from ",
+           struct_type.getName());
+
+    // Map each field to its index in the hot or cold struct.
+    map<unsigned, unsigned> new_field_index = {};
+    set<unsigned> is_cold = {};
+    for (unsigned i = 0; i < hot_fields.size(); ++i) {
+      new_field_index[hot_fields[i]] = i;
+    }
+    for (unsigned i = 0; i < cold_fields.size(); ++i) {
+      new_field_index[cold_fields[i]] = i;
+      is_cold.insert(cold_fields[i]);
+    }
+    unsigned cold_ref_index = hot_fields.size();
+
+    // Define the cold struct type alongside the original definition.
+    auto &definition = struct_type.getDefinition();
+    auto &definition_as_call = definition.getCallInst();
+    MemOIRBuilder builder(&definition_as_call);
+
+    auto cold_name = struct_type.getName() + ".cold";
+    vector<Type *> cold_field_types = {};
+    vector<llvm::Value *> cold_field_type_values = {};
+    for (auto field_index : cold_fields) {
+      cold_field_types.push_back(&struct_type.getFieldType(field_index));
+      cold_field_type_values.push_back(
+          &definition.getFieldTypeOperand(field_index));
+    }
+    auto *cold_definition =
+        builder.CreateDefineStructTypeInst(cold_name.c_str(),
+                                           cold_fields.size(),
+                                           cold_field_type_values);
+    auto &cold_type =
+        Type::define_struct_type(*cold_definition, cold_name, cold_field_types);
+    auto &cold_ref_type = Type::get_ref_type(cold_type);
+    auto *cold_ref_type_inst =
+        builder.CreateReferenceTypeInst(&cold_definition->getCallInst());
+
+    // Redefine the hot struct type, with a reference to the cold struct as
+    // its last field.
+    auto *num_fields_type = definition.getNumberOfFieldsOperand().getType();
+    vector<llvm::Value *> hot_arguments = {
+      &definition.getNameOperand(),
+      llvm::ConstantInt::get(num_fields_type, hot_fields.size() + 1)
+    };
+    for (auto field_index : hot_fields) {
+      hot_arguments.push_back(&definition.getFieldTypeOperand(field_index));
+    }
+    hot_arguments.push_back(&cold_ref_type_inst->getCallInst());
+
+    auto *hot_definition =
+        llvm::CallInst::Create(definition_as_call.getFunctionType(),
+                               definition_as_call.getCalledFunction(),
+                               hot_arguments,
+                               /*NameStr=*/"split.",
+                               /*InsertBefore=*/&definition_as_call);
+    definition_as_call.replaceAllUsesWith(hot_definition);
+    this->instructions_to_delete.insert(&definition_as_call);
+
+    // Allocate the cold struct alongside each hot struct.
+    for (auto *alloc_inst : type_info.allocations) {
+      MemOIRBuilder alloc_builder(*alloc_inst, /* InsertAfter = */ true);
+      auto *cold_alloc =
+          alloc_builder.CreateStructAllocInst(cold_type, "cold.");
+      auto *cold_ref_index_value = alloc_builder.getInt32(cold_ref_index);
+      alloc_builder.CreateStructWriteInst(cold_ref_type,
+                                          &cold_alloc->getCallInst(),
+                                          &alloc_inst->getCallInst(),
+                                          cold_ref_index_value);
+    }
+
+    // Delete the cold struct alongside each hot struct.
+    for (auto *delete_inst : type_info.deletions) {
+      MemOIRBuilder delete_builder(*delete_inst);
+      auto *cold_ref = delete_builder.CreateStructReadInst(
+          cold_ref_type,
+          &delete_inst->getDeletedStruct(),
+          delete_builder.getInt32(cold_ref_index),
+          "cold.");
+      delete_builder.CreateDeleteStructInst(&cold_ref->getCallInst());
+    }
+
+    // Update the field accesses.
+    for (auto const &[field_index, accesses] : type_info.accesses) {
+      auto new_index = new_field_index.at(field_index);
+      for (auto *access : accesses) {
+        auto &field_index_use = get_field_index_use(*access);
+        auto *field_index_type = field_index_use.get()->getType();
+
+        // Accesses to cold fields go through the cold reference.
+        if (is_cold.count(field_index) > 0) {
+          MemOIRBuilder access_builder(*access);
+          auto *cold_ref = access_builder.CreateStructReadInst(
+              cold_ref_type,
+              &access->getObjectOperand(),
+              llvm::ConstantInt::get(field_index_type, cold_ref_index),
+              "cold.");
+          access->getObjectOperandAsUse().set(&cold_ref->getCallInst());
+        }
+
+        auto *new_index_value =
+            llvm::ConstantInt::get(field_index_type, new_index);
+        field_index_use.set(new_index_value);
+      }
+    }
+
+    return true;
+  }
+
+  // Owned state.
+  map<StructType *, TypeInfo> type_info;
+  StructTypeSetTy unsplittable;
+  set<llvm::Instruction *> instructions_to_delete;
+
+  // Borrowed state.
+  llvm::Module &M;
+  const BlockCountsTy &block_counts;
+  double cold_ratio;
+};
+
+} // namespace llvm::memoir
+
+#endif
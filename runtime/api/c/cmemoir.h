@@ -89,6 +89,11 @@ namespace memoir {
 
 #define memoir_end() MEMOIR_FUNC(end)()
 
+#define memoir_seq_reserve(object, capacity)                                   \
+  MEMOIR_FUNC(sequence_reserve)(object, capacity)
+
+#define memoir_clear(object) MUT_FUNC(clear)(object)
+
 // Immutable sequence operations.
 #define memoir_sequence_slice(object, left, right)                             \
   MEMOIR_FUNC(sequence_copy)(object, (size_t)left, (size_t)right)
@@ -112,6 +117,9 @@ namespace memoir {
 #define memoir_seq_remove_range(object, begin, end)                            \
   MUT_FUNC(sequence_remove)(object, begin, end)
 
+#define memoir_seq_fill(ty, value, object, begin, end)                         \
+  MUT_FUNC(sequence_fill_##ty)(value, object, begin, end)
+
 #define memoir_seq_append(object, other)                                       \
   MUT_FUNC(sequence_append)(object, other)
 
@@ -158,7 +166,8 @@ namespace memoir {
 #define memoir_struct_read(ty, strct, field_index)                             \
   MEMOIR_FUNC(struct_read_##ty)(strct, (unsigned)field_index)
 #define memoir_index_read(ty, cllct, ...)                                      \
-  MEMOIR_FUNC(index_read_##ty)(cllct, MEMOIR_CAST_TO_SIZE_T(__VA_ARGS__))
+  MEMOIR_ARITY_FUNC(MEMOIR_FUNC(index_read_##ty), __VA_ARGS__)                 \
+  (cllct, MEMOIR_CAST_TO_SIZE_T(__VA_ARGS__))
 #define memoir_assoc_read(ty, cllct, key)                                      \
   MEMOIR_FUNC(assoc_read_##ty)(cllct, key)
 
@@ -168,7 +177,8 @@ namespace memoir {
 #define memoir_struct_write(ty, val, strct, field_index)                       \
   MUT_FUNC(struct_write_##ty)(val, strct, (unsigned)field_index)
 #define memoir_index_write(ty, val, cllct, ...)                                \
-  MUT_FUNC(index_write_##ty)(val, cllct, MEMOIR_CAST_TO_SIZE_T(__VA_ARGS__))
+  MEMOIR_ARITY_FUNC(MUT_FUNC(index_write_##ty), __VA_ARGS__)                   \
+  (val, cllct, MEMOIR_CAST_TO_SIZE_T(__VA_ARGS__))
 #define memoir_assoc_write(ty, val, cllct, key)                                \
   MUT_FUNC(assoc_write_##ty)(val, cllct, key)
 
@@ -178,7 +188,8 @@ namespace memoir {
 #define memoir_struct_get(ty, strct, field_index)                              \
   MEMOIR_FUNC(struct_get_##ty)(strct, (unsigned)field_index)
 #define memoir_index_get(ty, cllct, ...)                                       \
-  MEMOIR_FUNC(index_get_##ty)(cllct, MEMOIR_CAST_TO_SIZE_T(__VA_ARGS__))
+  MEMOIR_ARITY_FUNC(MEMOIR_FUNC(index_get_##ty), __VA_ARGS__)                  \
+  (cllct, MEMOIR_CAST_TO_SIZE_T(__VA_ARGS__))
 #define memoir_assoc_get(ty, cllct, key) MEMOIR_FUNC(assoc_get_##ty)(cllct, key)
 
 #if defined(__cplusplus)
@@ -0,0 +1,81 @@
+#ifndef MEMOIR_BACKEND_ARENA_H
+#define MEMOIR_BACKEND_ARENA_H
+
+// Region-based struct allocator, addressed by 32-bit offsets.
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <atomic>
+#include <mutex>
+
+#include <sys/mman.h>
+
+#define cname extern "C"
+#define alwaysinline __attribute__((always_inline)) inline
+#define used __attribute__((used))
+
+// Each arena reserves the full range addressable by a 32-bit offset, pages are
+// only backed once they are touched.
+#define ARENA_CAPACITY ((size_t)1 << 32)
+#define ARENA_ALIGN 8
+
+extern "C" {
+
+// Offset 0 is reserved for the null reference, so allocation begins at the
+// first aligned offset. Freed objects are kept on a free list, threaded
+// through their own storage, and are handed out again before the region
+// grows.
+#define INSTANTIATE_arena(T, C_TYPE)                                           \
+  cname used char *T##_arena__base = NULL;                                     \
+  static std::once_flag T##_arena__reserved;                                   \
+  static std::atomic<size_t> T##_arena__next(ARENA_ALIGN);                     \
+  static std::atomic<void *> T##_arena__free_list(NULL);                       \
+  static std::mutex T##_arena__free_lock;                                      \
+                                                                               \
+  static void T##_arena__reserve(void) {                                       \
+    void *region = mmap(NULL,                                                  \
+                        ARENA_CAPACITY,                                        \
+                        PROT_READ | PROT_WRITE,                                \
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,           \
+                        -1,                                                    \
+                        0);                                                    \
+    if (region == MAP_FAILED) {                                                \
+      fprintf(stderr, "arena: could not reserve region for " #T "\n");         \
+      abort();                                                                 \
+    }                                                                          \
+    T##_arena__base = (char *)region;                                          \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used C_TYPE *T##_arena__allocate(void) {                  \
+    std::call_once(T##_arena__reserved, T##_arena__reserve);                   \
+    if (T##_arena__free_list.load(std::memory_order_acquire) != NULL) {        \
+      std::lock_guard<std::mutex> guard(T##_arena__free_lock);                 \
+      void *object = T##_arena__free_list.load(std::memory_order_relaxed);     \
+      if (object != NULL) {                                                    \
+        T##_arena__free_list.store(*(void **)object,                           \
+                                   std::memory_order_relaxed);                 \
+        return (C_TYPE *)object;                                               \
+      }                                                                        \
+    }                                                                          \
+    size_t size = (sizeof(C_TYPE) + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);     \
+    size_t offset =                                                            \
+      T##_arena__next.fetch_add(size, std::memory_order_relaxed);              \
+    if (offset + size > ARENA_CAPACITY) {                                      \
+      fprintf(stderr, "arena: region exhausted for " #T "\n");                 \
+      abort();                                                                 \
+    }                                                                          \
+    return (C_TYPE *)(T##_arena__base + offset);                               \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used void T##_arena__free(C_TYPE *object) {               \
+    if (object == NULL) {                                                      \
+      return;                                                                  \
+    }                                                                          \
+    std::lock_guard<std::mutex> guard(T##_arena__free_lock);                   \
+    *(void **)object = T##_arena__free_list.load(std::memory_order_relaxed);   \
+    T##_arena__free_list.store(object, std::memory_order_release);             \
+  }
+}
+
+#endif // MEMOIR_BACKEND_ARENA_H
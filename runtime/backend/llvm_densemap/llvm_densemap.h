@@ -29,6 +29,12 @@ extern "C" {
     delete map;                                                                \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void K##_##V##_llvm_densemap__clear(                 \
+      K##_##V##_llvm_densemap_p map) {                                         \
+    map->clear();                                                              \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used bool K##_##V##_llvm_densemap__has(                   \
       K##_##V##_llvm_densemap_p map,                                           \
       C_KEY key) {                                                             \
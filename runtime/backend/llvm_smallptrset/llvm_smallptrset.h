@@ -38,6 +38,12 @@ extern "C" {
     return;                                                                    \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void K##_##V##_llvm_smallptrset__clear(              \
+      K##_##V##_llvm_smallptrset_p set) {                                      \
+    set->_set.clear();                                                         \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used C_VALUE K##_##V##_llvm_smallptrset__has(             \
       K##_##V##_llvm_smallptrset_p set,                                        \
       C_KEY key) {                                                             \
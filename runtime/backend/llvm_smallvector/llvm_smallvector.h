@@ -1,6 +1,7 @@
 // Simple hash table implemented in C.
 #include "llvm/ADT/SmallVector.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 
@@ -35,6 +36,12 @@ extern "C" {
     delete vec;                                                                \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void T##_llvm_smallvector__clear(                    \
+      T##_llvm_smallvector_p vec) {                                            \
+    vec->clear();                                                              \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used C_TYPE *T##_llvm_smallvector__get(                   \
       T##_llvm_smallvector_p vec,                                              \
       size_t index) {                                                          \
@@ -121,6 +128,25 @@ extern "C" {
     return;                                                                    \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void T##_llvm_smallvector__fill(                     \
+      T##_llvm_smallvector_p vec,                                              \
+      size_t begin_index,                                                      \
+      size_t end_index,                                                        \
+      C_TYPE value) {                                                          \
+    std::fill(vec->begin() + begin_index, vec->begin() + end_index, value);    \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used void T##_llvm_smallvector__reserve(                  \
+      T##_llvm_smallvector_p vec,                                              \
+      size_t capacity) {                                                       \
+    /* Grow geometrically, so repeated reserves stay amortized. */             \
+    if (capacity > vec->capacity()) {                                          \
+      vec->reserve(std::max(capacity, 2 * vec->capacity()));                   \
+    }                                                                          \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used size_t T##_llvm_smallvector__size(                   \
       T##_llvm_smallvector_p vec) {                                            \
     return vec->size();                                                        \
@@ -28,6 +28,12 @@ extern "C" {
     delete table;                                                              \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void K##_##V##_stl_unordered_map__clear(             \
+      K##_##V##_stl_unordered_map_p table) {                                   \
+    table->clear();                                                            \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used bool K##_##V##_stl_unordered_map__has(               \
       K##_##V##_stl_unordered_map_p table,                                     \
       C_KEY key) {                                                             \
@@ -1,4 +1,5 @@
 // Simple hash table implemented in C.
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 
@@ -12,6 +13,18 @@
 #define B 60
 #define RESERVE_SIZE K + B + 1
 
+// std::vector<bool> is bit-packed and has no data pointer, so only other
+// element types expose their storage. Boolean sequences are never accessed
+// through it by the compiler.
+template <typename C_TYPE>
+alwaysinline C_TYPE *stl_vector_data(std::vector<C_TYPE> *vec) {
+  return vec->data();
+}
+
+alwaysinline bool *stl_vector_data(std::vector<bool> *vec) {
+  return nullptr;
+}
+
 extern "C" {
 
 #define INSTANTIATE_stl_vector(T, C_TYPE)                                      \
@@ -32,6 +45,11 @@ extern "C" {
     delete vec;                                                                \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void T##_stl_vector__clear(T##_stl_vector_p vec) {   \
+    vec->clear();                                                              \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used C_TYPE *T##_stl_vector__get(T##_stl_vector_p vec,    \
                                                       size_t index) {          \
     return (C_TYPE *)(&((*vec)[index]));                                       \
@@ -112,8 +130,29 @@ extern "C" {
     return;                                                                    \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void T##_stl_vector__fill(T##_stl_vector_p vec,      \
+                                                    size_t begin_index,        \
+                                                    size_t end_index,          \
+                                                    C_TYPE value) {            \
+    std::fill(vec->begin() + begin_index, vec->begin() + end_index, value);    \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used void T##_stl_vector__reserve(T##_stl_vector_p vec,   \
+                                                       size_t capacity) {      \
+    /* Grow geometrically, so repeated reserves stay amortized. */             \
+    if (capacity > vec->capacity()) {                                          \
+      vec->reserve(std::max(capacity, 2 * vec->capacity()));                   \
+    }                                                                          \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used size_t T##_stl_vector__size(T##_stl_vector_p vec) {  \
     return vec->size();                                                        \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used C_TYPE *T##_stl_vector__data(T##_stl_vector_p vec) { \
+    return stl_vector_data(vec);                                               \
   }
 
 } // extern "C"
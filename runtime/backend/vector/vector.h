@@ -50,6 +50,12 @@
     return;                                                                    \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void T##_vector__clear(T##_vector_p vec) {           \
+    vec->_front = 0;                                                           \
+    vec->_back = 0;                                                            \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used size_t T##_vector__size(T##_vector_p vec) {          \
     return vec->_back - vec->_front;                                           \
   }                                                                            \
@@ -304,6 +310,12 @@
     return;                                                                    \
   }                                                                            \
                                                                                \
+  cname alwaysinline used void T##_vector__clear(T##_vector_p vec) {           \
+    vec->_front = 0;                                                           \
+    vec->_back = 0;                                                            \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
   cname alwaysinline used size_t T##_vector__size(T##_vector_p vec) {          \
     return vec->_back - vec->_front;                                           \
   }                                                                            \
@@ -528,4 +540,35 @@
       vec->_storage[from + idx] = tmp;                                         \
     }                                                                          \
     return;                                                                    \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used void T##_vector__fill(T##_vector_p vec,              \
+                                                size_t begin_index,            \
+                                                size_t end_index,              \
+                                                C_TYPE value) {                \
+    C_TYPE *storage = &vec->_storage[vec->_front];                             \
+    for (size_t idx = begin_index; idx < end_index; idx++) {                   \
+      storage[idx] = value;                                                    \
+    }                                                                          \
+    return;                                                                    \
+  }                                                                            \
+                                                                               \
+  cname alwaysinline used void T##_vector__reserve(T##_vector_p vec,           \
+                                                  size_t capacity) {           \
+    /* The storage is allocated along with the vector, so growing it would     \
+       move the vector out from under its users. Instead, we only make room    \
+       at the back of the storage we already have. */                          \
+    size_t vec_size = vec->_back - vec->_front;                                \
+    if (capacity <= vec->_max_size - vec->_front                               \
+        || capacity > vec->_max_size) {                                        \
+      return;                                                                  \
+    }                                                                          \
+                                                                               \
+    memmove((void *)&vec->_storage[0],                                         \
+            (const void *)&vec->_storage[vec->_front],                         \
+            sizeof(C_TYPE) * vec_size);                                        \
+    vec->_front = 0;                                                           \
+    vec->_back = vec_size;                                                     \
+                                                                               \
+    return;                                                                    \
   }
@@ -4,7 +4,7 @@
 #include <cstdio>
 #include <memory>
 
-#define MEMOIR_ASSERT(cond, msg)                                               \
+#define MEMOIR__ASSERT(cond, msg)                                              \
   if (!cond) {                                                                 \
     fprintf(stderr, "\x1b[31m-----[ MemOIR Assert Failed ]-----\x1b[0m\n");    \
     fprintf(stderr, "%s @ line %d\n", __FILE__, __LINE__);                     \
@@ -14,7 +14,17 @@
     exit(EXIT_FAILURE);                                                        \
   }
 
-#define MEMOIR_UNREACHABLE(msg) MEMOIR_ASSERT(false, msg);
+// Runtime checks are compiled out when MEMOIR_DISABLE_CHECKS is defined,
+// unreachable code still aborts.
+#ifdef MEMOIR_DISABLE_CHECKS
+#  define MEMOIR_ASSERT(cond, msg)                                             \
+    if (false) {                                                               \
+    }
+#else
+#  define MEMOIR_ASSERT(cond, msg) MEMOIR__ASSERT(cond, msg)
+#endif
+
+#define MEMOIR_UNREACHABLE(msg) MEMOIR__ASSERT(false, msg);
 
 #define MEMOIR_ACCESS_CHECK(obj)                                               \
   MEMOIR_ASSERT((obj != nullptr), "Attempt to access NULL object")
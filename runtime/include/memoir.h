@@ -20,9 +20,16 @@
 namespace memoir {
 extern "C" {
 
-#define __RUNTIME_ATTR                                                         \
-  __declspec(noalias) __attribute__((nothrow)) __attribute__((noinline))       \
-      __attribute__((optnone)) __attribute__((used))
+// The release runtime lets the compiler optimize and inline runtime calls,
+// so it can only be used by programs that are not compiled by MEMOIR.
+#ifdef MEMOIR_RELEASE_RUNTIME
+#  define __RUNTIME_ATTR                                                       \
+    __declspec(noalias) __attribute__((nothrow)) __attribute__((used))
+#else
+#  define __RUNTIME_ATTR                                                       \
+    __declspec(noalias) __attribute__((nothrow)) __attribute__((noinline))     \
+        __attribute__((optnone)) __attribute__((used))
+#endif
 #define __ALLOC_ATTR __declspec(allocator)
 #define __IMMUT_ATTR __attribute__((pure))
 
@@ -124,6 +131,15 @@ __IMMUT_ATTR
 __RUNTIME_ATTR
 size_t MEMOIR_FUNC(end)();
 
+__RUNTIME_ATTR
+void MEMOIR_FUNC(sequence_reserve)(const collection_ref collection,
+                                   size_t capacity);
+
+__IMMUT_ATTR
+__ALLOC_ATTR
+__RUNTIME_ATTR
+collection_ref MEMOIR_FUNC(clear)(const collection_ref collection);
+
 // Immutable sequence operations.
 __IMMUT_ATTR
 __ALLOC_ATTR
@@ -157,6 +173,17 @@ collection_ref MEMOIR_FUNC(sequence_remove)(const collection_ref collection,
                                             size_t begin_index,
                                             size_t end_index);
 
+#define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(sequence_fill_##TYPE_NAME)(                       \
+      C_TYPE value,                                                            \
+      const collection_ref collection,                                         \
+      size_t begin_index,                                                      \
+      size_t end_index);
+#include "types.def"
+
 __IMMUT_ATTR
 __RUNTIME_ATTR
 const collection_pair MEMOIR_FUNC(sequence_swap)(
@@ -175,6 +202,10 @@ collection_ref MEMOIR_FUNC(sequence_swap_within)(
     size_t from_end,
     size_t to_begin);
 
+// Mutable collection operations.
+__RUNTIME_ATTR
+void MUT_FUNC(clear)(collection_ref collection);
+
 // Mutable sequence operations.
 #define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
   __RUNTIME_ATTR                                                               \
@@ -193,6 +224,14 @@ void MUT_FUNC(sequence_remove)(collection_ref collection,
                                size_t begin,
                                size_t end);
 
+#define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(sequence_fill_##TYPE_NAME)(C_TYPE value,                       \
+                                           collection_ref collection,          \
+                                           size_t begin,                       \
+                                           size_t end);
+#include "types.def"
+
 __RUNTIME_ATTR
 void MUT_FUNC(sequence_append)(collection_ref collection,
                                collection_ref collection_to_append);
@@ -295,7 +334,62 @@ void MUT_FUNC(assoc_remove)(collection_ref collection, ...);
   __RUNTIME_ATTR                                                               \
   void MUT_FUNC(assoc_write_##TYPE_NAME)(C_TYPE value,                         \
                                          collection_ref collection_to_access,  \
-                                         ...);
+                                         ...);                                 \
+  /* Arity-specialized access */                                               \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_read_##TYPE_NAME##_1d)(                             \
+      const collection_ref collection_to_access,                               \
+      size_t index);                                                           \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_read_##TYPE_NAME##_2d)(                             \
+      const collection_ref collection_to_access,                               \
+      size_t index0,                                                           \
+      size_t index1);                                                          \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(assoc_read_##TYPE_NAME##_1d)(                             \
+      const collection_ref collection_to_access,                               \
+      uint64_t key);                                                           \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(index_write_##TYPE_NAME##_1d)(                    \
+      C_TYPE value,                                                            \
+      const collection_ref collection_to_access,                               \
+      size_t index);                                                           \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(index_write_##TYPE_NAME##_2d)(                    \
+      C_TYPE value,                                                            \
+      const collection_ref collection_to_access,                               \
+      size_t index0,                                                           \
+      size_t index1);                                                          \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(assoc_write_##TYPE_NAME##_1d)(                    \
+      C_TYPE value,                                                            \
+      const collection_ref collection_to_access,                               \
+      uint64_t key);                                                           \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(index_write_##TYPE_NAME##_1d)(                                 \
+      C_TYPE value,                                                            \
+      collection_ref collection_to_access,                                     \
+      size_t index);                                                           \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(index_write_##TYPE_NAME##_2d)(                                 \
+      C_TYPE value,                                                            \
+      collection_ref collection_to_access,                                     \
+      size_t index0,                                                           \
+      size_t index1);                                                          \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(assoc_write_##TYPE_NAME##_1d)(                                 \
+      C_TYPE value,                                                            \
+      collection_ref collection_to_access,                                     \
+      uint64_t key);
 
 // Nested object access
 #define HANDLE_NESTED_TYPE(TYPE_NAME, C_TYPE, CLASS_PREFIX)                    \
@@ -311,7 +405,23 @@ void MUT_FUNC(assoc_remove)(collection_ref collection, ...);
   __IMMUT_ATTR                                                                 \
   __RUNTIME_ATTR                                                               \
   C_TYPE MEMOIR_FUNC(                                                          \
-      assoc_get_##TYPE_NAME)(const collection_ref collection_to_access, ...);
+      assoc_get_##TYPE_NAME)(const collection_ref collection_to_access, ...);  \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_get_##TYPE_NAME##_1d)(                              \
+      const collection_ref collection_to_access,                               \
+      size_t index);                                                           \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_get_##TYPE_NAME##_2d)(                              \
+      const collection_ref collection_to_access,                               \
+      size_t index0,                                                           \
+      size_t index1);                                                          \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(assoc_get_##TYPE_NAME##_1d)(                              \
+      const collection_ref collection_to_access,                               \
+      uint64_t key);
 #include "types.def"
 
 // SSA renaming
@@ -16,6 +16,7 @@
 #include <stdint.h>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "objects.h"
@@ -45,6 +46,7 @@ public:
   // Construction
   static Object *init(Type *type);
   Object(Type *type);
+  virtual ~Object() = default;
   virtual void free() = 0;
 
   // Access
@@ -61,19 +63,25 @@ public:
 } // namespace detail
 
 namespace detail {
+/*
+ * The fields of a struct are stored inline, directly after the Struct itself,
+ * so structs must be created with Struct::create.
+ */
 struct Struct : public detail::Object {
 public:
   // Owned state
-  std::vector<uint64_t> fields;
+  uint64_t num_fields;
 
   // Borrowed state
 
   // Construction
-  Struct(Type *type);
-  Struct(Struct *other);
+  static Struct *create(Type *type);
+  static Struct *create(Struct *other);
   void free() override;
   ~Struct() = default;
 
+  void operator delete(void *ptr);
+
   // Access
   uint64_t get_field(uint64_t field_index) const;
   void set_field(uint64_t value, uint64_t field_index);
@@ -82,6 +90,15 @@ public:
 
   // Debug
   std::string to_string() override;
+
+protected:
+  Struct(Type *type);
+  Struct(Struct *other);
+
+  static void *allocate(uint64_t num_fields);
+
+  uint64_t *fields();
+  const uint64_t *fields() const;
 };
 } // namespace detail
 
@@ -91,6 +108,10 @@ public:
   // Access
   virtual uint64_t get_element(va_list args) = 0;
   virtual void set_element(uint64_t value, va_list args) = 0;
+  virtual uint64_t get_element_1d(uint64_t index) = 0;
+  virtual void set_element_1d(uint64_t value, uint64_t index) = 0;
+  virtual uint64_t get_element_2d(uint64_t index0, uint64_t index1);
+  virtual void set_element_2d(uint64_t value, uint64_t index0, uint64_t index1);
   virtual bool has_element(va_list args) = 0;
   virtual void remove_element(va_list args) = 0;
   virtual Collection *get_slice(va_list args) = 0;
@@ -99,23 +120,30 @@ public:
   bool is_collection() const override;
   virtual uint64_t size() const = 0;
 
+  // Mutable operations
+  virtual void clear();
+
   // Construction
   Collection(Type *type);
 };
 
+/*
+ * Tensors, sequences and assoc arrays store their elements at the storage
+ * size of their element type, see get_storage_size. Each has a subclass,
+ * templated on the storage type, which is selected by its create method.
+ * Elements are still passed to and from the accessors as uint64_t.
+ */
 struct Tensor : public Collection {
 public:
   // Owned state
-  std::vector<uint64_t> tensor;
   std::vector<uint64_t> length_of_dimensions;
 
   // Borrowed state
 
   // Construction
-  Tensor(Type *type);
-  Tensor(Type *type, std::vector<uint64_t> &length_of_dimensions);
+  static Tensor *create(Type *type,
+                        std::vector<uint64_t> &length_of_dimensions);
   ~Tensor() = default;
-  void free() override;
 
   // Operations
   Collection *get_slice(va_list args) override;
@@ -123,10 +151,18 @@ public:
   uint64_t size() const override;
 
   // Access
+  virtual uint64_t get_flat_element(uint64_t flat_index) const = 0;
+  virtual void set_flat_element(uint64_t value, uint64_t flat_index) = 0;
   uint64_t get_tensor_element(std::vector<uint64_t> &indices) const;
   uint64_t get_element(va_list args) override;
+  uint64_t get_element_1d(uint64_t index) override;
+  uint64_t get_element_2d(uint64_t index0, uint64_t index1) override;
   void set_tensor_element(uint64_t value, std::vector<uint64_t> &indices);
   void set_element(uint64_t value, va_list args) override;
+  void set_element_1d(uint64_t value, uint64_t index) override;
+  void set_element_2d(uint64_t value,
+                      uint64_t index0,
+                      uint64_t index1) override;
   bool has_tensor_element(std::vector<uint64_t> &indices) const;
   bool has_element(va_list args) override;
   void remove_element(va_list args) override;
@@ -136,6 +172,31 @@ public:
 
   // Debug
   std::string to_string() override;
+
+protected:
+  Tensor(Type *type, std::vector<uint64_t> &length_of_dimensions);
+
+  uint64_t get_flattened_length() const;
+  uint64_t flatten(std::vector<uint64_t> &indices) const;
+  uint64_t flatten(va_list args) const;
+  uint64_t flatten(uint64_t index) const;
+  uint64_t flatten(uint64_t index0, uint64_t index1) const;
+};
+
+template <typename T>
+struct TypedTensor : public Tensor {
+public:
+  // Owned state
+  std::vector<T> tensor;
+
+  // Construction
+  TypedTensor(Type *type, std::vector<uint64_t> &length_of_dimensions);
+  ~TypedTensor() = default;
+  void free() override;
+
+  // Access
+  uint64_t get_flat_element(uint64_t flat_index) const override;
+  void set_flat_element(uint64_t value, uint64_t flat_index) override;
 };
 
 struct AssocArray : public detail::Collection {
@@ -143,26 +204,28 @@ public:
   using key_t = uint64_t;
   using value_t = uint64_t;
 
-  // Owned state
-  std::unordered_map<key_t, value_t> assoc_array;
-
   // Borrowed state
 
   // Construction
-  AssocArray(Type *type);
+  static AssocArray *create(Type *type);
   ~AssocArray() = default;
-  void free() override;
+  virtual AssocArray *copy() const = 0;
 
   // Operations
   Collection *join(va_list args, uint8_t num_args) override;
   Collection *get_slice(va_list args) override;
-  uint64_t size() const override;
-  Collection *keys() const;
+  virtual Collection *keys() const = 0;
 
   // Access
+  virtual uint64_t get_assoc_element(key_t key) = 0;
   uint64_t get_element(va_list args) override;
+  uint64_t get_element_1d(uint64_t key) override;
+  virtual void set_assoc_element(uint64_t value, key_t key) = 0;
   void set_element(uint64_t value, va_list args) override;
+  void set_element_1d(uint64_t value, uint64_t key) override;
+  virtual bool has_assoc_element(key_t key) const = 0;
   bool has_element(va_list args) override;
+  virtual void remove_assoc_element(key_t key) = 0;
   void remove_element(va_list args) override;
   Type *get_element_type() const override;
   Type *get_key_type() const;
@@ -172,13 +235,40 @@ public:
 
   // Debug
   std::string to_string() override;
-};
 
-struct Sequence : public detail::Collection {
 protected:
-  using seq_iter = std::vector<uint64_t>::iterator;
-  using const_seq_iter = std::vector<uint64_t>::const_iterator;
+  AssocArray(Type *type);
+
+  key_t read_key(va_list args) const;
+};
 
+template <typename T>
+struct TypedAssocArray : public AssocArray {
+public:
+  // Owned state
+  std::unordered_map<key_t, T> assoc_array;
+
+  // Construction
+  TypedAssocArray(Type *type);
+  ~TypedAssocArray() = default;
+  void free() override;
+  AssocArray *copy() const override;
+
+  // Operations
+  uint64_t size() const override;
+  Collection *keys() const override;
+
+  // Access
+  uint64_t get_assoc_element(key_t key) override;
+  void set_assoc_element(uint64_t value, key_t key) override;
+  bool has_assoc_element(key_t key) const override;
+  void remove_assoc_element(key_t key) override;
+  void clear() override;
+};
+
+struct SequenceAlloc;
+
+struct Sequence : public detail::Collection {
 public:
   // Construction
   Sequence(SequenceType *type);
@@ -190,45 +280,63 @@ public:
   virtual Collection *get_sequence_slice(int64_t left_index,
                                          int64_t right_index) = 0;
   Collection *get_slice(va_list args) override;
+  virtual SequenceAlloc *copy(uint64_t from, uint64_t to) = 0;
 
   // Access
   virtual uint64_t get_sequence_element(uint64_t index) = 0;
   uint64_t get_element(va_list args) override;
+  uint64_t get_element_1d(uint64_t index) override;
   virtual void set_sequence_element(uint64_t value, uint64_t index) = 0;
   void set_element(uint64_t value, va_list args) override;
+  void set_element_1d(uint64_t value, uint64_t index) override;
   virtual bool has_sequence_element(uint64_t index) = 0;
   bool has_element(va_list args) override;
   void remove_element(va_list args) override;
 
   Type *get_element_type() const override;
 
-  // Iterators
-  virtual seq_iter begin() = 0;
-  virtual seq_iter end() = 0;
-  virtual const_seq_iter cbegin() const = 0;
-  virtual const_seq_iter cend() const = 0;
-
   // Mutable operations
   virtual void insert(uint64_t index, uint64_t value) = 0;
   virtual void insert(uint64_t start, Sequence *seq) = 0;
   virtual void erase(uint64_t from, uint64_t to) = 0;
   virtual void grow(uint64_t size) = 0;
+  virtual void fill(uint64_t from, uint64_t to, uint64_t value) = 0;
+  virtual void reserve(uint64_t capacity) = 0;
+  void clear() override;
+  void swap(uint64_t from, uint64_t to, Sequence *other, uint64_t other_from);
 };
 
 struct SequenceAlloc : public detail::Sequence {
-  // Owned state
-  std::vector<uint64_t> _sequence;
-
   // Construction
-  SequenceAlloc(SequenceType *type, size_t initial_size);
-  SequenceAlloc(SequenceType *type, std::vector<uint64_t> &&initial);
+  static SequenceAlloc *create(SequenceType *type, size_t initial_size);
   ~SequenceAlloc() = default;
-  void free() override;
 
   // Operations
   Collection *get_sequence_slice(int64_t left_index,
                                  int64_t right_index) override;
 
+  bool equals(const Object *other) const override;
+
+  // Debug
+  std::string to_string() override;
+
+protected:
+  SequenceAlloc(SequenceType *type);
+};
+
+template <typename T>
+struct TypedSequence : public detail::SequenceAlloc {
+  // Owned state
+  std::vector<T> _sequence;
+
+  // Construction
+  TypedSequence(SequenceType *type, size_t initial_size);
+  ~TypedSequence() = default;
+  void free() override;
+
+  // Operations
+  SequenceAlloc *copy(uint64_t from, uint64_t to) override;
+
   // Access
   uint64_t get_sequence_element(uint64_t index) override;
   void set_sequence_element(uint64_t value, uint64_t index) override;
@@ -236,22 +344,13 @@ struct SequenceAlloc : public detail::Sequence {
 
   uint64_t size() const override;
 
-  bool equals(const Object *other) const override;
-
-  // Iterators
-  Sequence::seq_iter begin() override;
-  Sequence::seq_iter end() override;
-  Sequence::const_seq_iter cbegin() const override;
-  Sequence::const_seq_iter cend() const override;
-
   // Mutable operations
   void insert(uint64_t index, uint64_t value) override;
   void insert(uint64_t start, Sequence *seq) override;
   void erase(uint64_t from, uint64_t to) override;
   void grow(uint64_t size) override;
-
-  // Debug
-  std::string to_string() override;
+  void fill(uint64_t from, uint64_t to, uint64_t value) override;
+  void reserve(uint64_t capacity) override;
 };
 
 struct SequenceView : public detail::Sequence {
@@ -271,6 +370,7 @@ struct SequenceView : public detail::Sequence {
   // Operations
   Collection *get_sequence_slice(int64_t left_index,
                                  int64_t right_index) override;
+  SequenceAlloc *copy(uint64_t from, uint64_t to) override;
 
   // Access
   uint64_t get_sequence_element(uint64_t index) override;
@@ -278,17 +378,13 @@ struct SequenceView : public detail::Sequence {
   bool has_sequence_element(uint64_t index) override;
   uint64_t size() const override;
 
-  // Iterators
-  Sequence::seq_iter begin() override;
-  Sequence::seq_iter end() override;
-  Sequence::const_seq_iter cbegin() const override;
-  Sequence::const_seq_iter cend() const override;
-
   // Mutable operations
   void insert(uint64_t index, uint64_t value) override;
   void insert(uint64_t start, Sequence *seq) override;
   void erase(uint64_t from, uint64_t to) override;
   void grow(uint64_t size) override;
+  void fill(uint64_t from, uint64_t to, uint64_t value) override;
+  void reserve(uint64_t capacity) override;
 
   // Debug
   bool equals(const Object *other) const override;
@@ -296,7 +392,6 @@ struct SequenceView : public detail::Sequence {
 };
 
 uint64_t init_element(Type *type);
-std::vector<uint64_t> init_elements(Type *type, size_t num = 1);
 
 } // namespace detail
 
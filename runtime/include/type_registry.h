@@ -0,0 +1,115 @@
+#ifndef MEMOIR_TYPEREGISTRY_H
+#define MEMOIR_TYPEREGISTRY_H
+#pragma once
+
+/*
+ * Registry of uniqued types, keyed by the contents of the type.
+ * Lookups of an existing type read an immutable snapshot of the registry
+ * without locking. Creating a type publishes a new snapshot under a lock, so
+ * types can be constructed from multiple threads.
+ */
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace memoir {
+
+/*
+ * Content hashing of type keys
+ */
+struct TypeKeyHash {
+  static size_t combine(size_t seed, size_t hash) {
+    return seed ^ (hash + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+  }
+
+  template <typename T>
+  size_t operator()(const T &value) const {
+    return std::hash<T>{}(value);
+  }
+
+  template <typename T>
+  size_t operator()(const std::vector<T> &values) const {
+    size_t seed = values.size();
+    for (const auto &value : values) {
+      seed = combine(seed, (*this)(value));
+    }
+    return seed;
+  }
+
+  template <typename A, typename B>
+  size_t operator()(const std::pair<A, B> &pair) const {
+    return combine((*this)(pair.first), (*this)(pair.second));
+  }
+
+  template <typename... Ts>
+  size_t operator()(const std::tuple<Ts...> &tuple) const {
+    size_t seed = 0;
+    std::apply(
+        [&](const auto &... elements) {
+          ((seed = combine(seed, (*this)(elements))), ...);
+        },
+        tuple);
+    return seed;
+  }
+};
+
+template <typename KeyTy, typename TypeTy>
+struct TypeRegistry {
+public:
+  /*
+   * Get the type for the given key, calling create to construct it if it
+   * has not been registered yet. The type is only created once.
+   */
+  template <typename CreateFn>
+  TypeTy *get_or_create(const KeyTy &key, CreateFn create) {
+    auto *type = find(*this->snapshot.load(std::memory_order_acquire), key);
+    if (type != nullptr) {
+      return type;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    // Another thread may have created the type while we were waiting.
+    auto &current = *this->snapshot.load(std::memory_order_relaxed);
+    type = find(current, key);
+    if (type != nullptr) {
+      return type;
+    }
+
+    // Publish a copy of the registry with the new type. Readers may still
+    // hold the old snapshot, so it is kept alive with the registry.
+    type = create();
+    auto next = std::make_unique<TypeMapTy>(current);
+    (*next)[key] = type;
+    this->snapshot.store(next.get(), std::memory_order_release);
+    this->snapshots.push_back(std::move(next));
+    return type;
+  }
+
+protected:
+  using TypeMapTy = std::unordered_map<KeyTy, TypeTy *, TypeKeyHash>;
+
+  static TypeTy *find(const TypeMapTy &types, const KeyTy &key) {
+    auto found = types.find(key);
+    if (found == types.end()) {
+      return nullptr;
+    }
+    return found->second;
+  }
+
+  std::mutex mutex;
+  TypeMapTy empty = {};
+  std::vector<std::unique_ptr<TypeMapTy>> snapshots = {};
+  std::atomic<const TypeMapTy *> snapshot = { &empty };
+};
+
+} // namespace memoir
+
+#endif
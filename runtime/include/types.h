@@ -11,12 +11,13 @@
  * Created: Mar 7, 2022
  */
 
-#include <list>
 #include <string>
-#include <unordered_map>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "objects.h"
+#include "type_registry.h"
 
 namespace memoir {
 
@@ -44,6 +45,8 @@ public:
   virtual bool equals(Type *other) = 0;
   virtual std::string to_string() = 0;
 
+  virtual ~Type() = default;
+
 protected:
   Type(TypeCode code, const char *name);
   Type(TypeCode code);
@@ -69,7 +72,7 @@ public:
 private:
   StructType(const char *name, std::vector<Type *> &field_types);
 
-  static std::unordered_map<const char *, Type *> &struct_types();
+  static TypeRegistry<std::string, StructType> &struct_types();
 };
 
 /*
@@ -99,23 +102,19 @@ private:
              std::vector<uint64_t> &length_of_dimensions);
 
   // clang-format off
-  using static_tensor_type_list =
-    std::list<
-      std::tuple<
-        Type *,                /* element type */
-        uint64_t,              /* num dimensions */
-        std::vector<uint64_t>, /* length of dimensions */
-        TensorType *>>;
-  using tensor_type_list =
-    std::list<
-      std::tuple<
-        Type *,         /* element type */
-        uint64_t,       /* num dimensions */
-        TensorType *>>;
+  using static_tensor_key =
+    std::tuple<
+      Type *,                 /* element type */
+      uint64_t,               /* num dimensions */
+      std::vector<uint64_t>>; /* length of dimensions */
+  using tensor_key =
+    std::pair<
+      Type *,    /* element type */
+      uint64_t>; /* num dimensions */
   // clang-format on
 
-  static static_tensor_type_list &get_static_tensor_types();
-  static tensor_type_list &get_tensor_types();
+  static TypeRegistry<static_tensor_key, TensorType> &static_tensor_types();
+  static TypeRegistry<tensor_key, TensorType> &tensor_types();
 };
 
 struct AssocArrayType : public Type {
@@ -130,6 +129,9 @@ public:
 
 private:
   AssocArrayType(Type *key_type, Type *value_type);
+
+  static TypeRegistry<std::pair<Type *, Type *>, AssocArrayType> &
+  assoc_array_types();
 };
 
 struct SequenceType : public Type {
@@ -144,7 +146,7 @@ public:
 private:
   SequenceType(Type *element_type);
 
-  static std::unordered_map<Type *, SequenceType *> &sequence_types();
+  static TypeRegistry<Type *, SequenceType> &sequence_types();
 };
 
 /*
@@ -208,6 +210,8 @@ public:
 
 private:
   ReferenceType(Type *referenced_type);
+
+  static TypeRegistry<Type *, ReferenceType> &reference_types();
 };
 
 /*
@@ -221,6 +225,9 @@ bool is_collection_type(Type *type);
 
 bool is_intrinsic_type(Type *type);
 
+// The number of bytes needed to store an element of the given type.
+size_t get_storage_size(Type *type);
+
 } // namespace memoir
 
 #endif
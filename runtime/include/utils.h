@@ -77,4 +77,22 @@
 #define MEMOIR_CAST_TO_SIZE_T(...)                                             \
   MEMOIR_apply(MEMOIR_CAST_TO_SIZE_T_, __VA_ARGS__)
 
+/*
+ * Select the arity-specialized entry point for an access with the given
+ * indices, falling back to the variadic entry point for 3 or more indices.
+ */
+#define MEMOIR_CAT_EXPANDED(a, b) MEMOIR_CAT(a, b)
+#define MEMOIR_ARITY_SUFFIX(...)                                               \
+  MEMOIR_CAT_EXPANDED(MEMOIR__ARITY_SUFFIX_, MEMOIR_NARGS(__VA_ARGS__))
+#define MEMOIR__ARITY_SUFFIX_1 _1d
+#define MEMOIR__ARITY_SUFFIX_2 _2d
+#define MEMOIR__ARITY_SUFFIX_3
+#define MEMOIR__ARITY_SUFFIX_4
+#define MEMOIR__ARITY_SUFFIX_5
+#define MEMOIR__ARITY_SUFFIX_6
+#define MEMOIR__ARITY_SUFFIX_7
+#define MEMOIR__ARITY_SUFFIX_8
+#define MEMOIR_ARITY_FUNC(func, ...)                                           \
+  MEMOIR_CAT_EXPANDED(func, MEMOIR_ARITY_SUFFIX(__VA_ARGS__))
+
 #endif
@@ -13,7 +13,7 @@ __IMMUT_ATTR
 __ALLOC_ATTR
 __RUNTIME_ATTR
 struct_ref MEMOIR_FUNC(allocate_struct)(const type_ref type) {
-  auto strct = new struct detail::Struct(type);
+  auto strct = detail::Struct::create(type);
 
   return (struct_ref)strct;
 }
@@ -39,7 +39,7 @@ collection_ref MEMOIR_FUNC(allocate_tensor)(const type_ref element_type,
 
   auto tensor_type = TensorType::get(element_type, num_dimensions);
 
-  auto tensor = new struct detail::Tensor(tensor_type, length_of_dimensions);
+  auto tensor = detail::Tensor::create(tensor_type, length_of_dimensions);
 
   return (collection_ref)tensor;
 }
@@ -51,7 +51,7 @@ collection_ref MEMOIR_FUNC(allocate_assoc_array)(const type_ref key_type,
                                                  const type_ref value_type) {
   auto assoc_array_type = AssocArrayType::get(key_type, value_type);
 
-  auto assoc_array = new struct detail::AssocArray(assoc_array_type);
+  auto assoc_array = detail::AssocArray::create(assoc_array_type);
 
   return (collection_ref)assoc_array;
 }
@@ -63,7 +63,7 @@ collection_ref MEMOIR_FUNC(allocate_sequence)(const type_ref element_type,
                                               uint64_t init_size) {
   auto sequence_type = SequenceType::get(element_type);
 
-  auto sequence = new struct detail::SequenceAlloc(sequence_type, init_size);
+  auto sequence = detail::SequenceAlloc::create(sequence_type, init_size);
 
   return (collection_ref)sequence;
 }
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 
 #include "internal.h"
@@ -6,6 +7,25 @@
 namespace memoir {
 namespace detail {
 
+/*
+ * Storage selection
+ *   Creates the subclass of BaseTy that stores elements of the given type at
+ *   their storage size.
+ */
+template <template <typename> class TypedTy, typename BaseTy, typename... Args>
+static BaseTy *create_typed(Type *element_type, Args &&... args) {
+  switch (get_storage_size(element_type)) {
+    case 1:
+      return new TypedTy<uint8_t>(std::forward<Args>(args)...);
+    case 2:
+      return new TypedTy<uint16_t>(std::forward<Args>(args)...);
+    case 4:
+      return new TypedTy<uint32_t>(std::forward<Args>(args)...);
+    default:
+      return new TypedTy<uint64_t>(std::forward<Args>(args)...);
+  }
+}
+
 /*
  * Collection Objects
  */
@@ -17,29 +37,34 @@ bool Collection::is_collection() const {
   return true;
 }
 
+uint64_t Collection::get_element_2d(uint64_t index0, uint64_t index1) {
+  MEMOIR_UNREACHABLE("Two-dimensional access of a one-dimensional collection");
+  return 0;
+}
+
+void Collection::set_element_2d(uint64_t value,
+                                uint64_t index0,
+                                uint64_t index1) {
+  MEMOIR_UNREACHABLE("Two-dimensional access of a one-dimensional collection");
+}
+
+void Collection::clear() {
+  MEMOIR_UNREACHABLE("Attempt to clear a collection of fixed size");
+}
+
 /*
  * Tensor Objects
  */
-Tensor::Tensor(Type *type) : Collection(type) {
-  MEMOIR_ASSERT((this->type->getCode() == TypeCode::TensorTy),
+Tensor *Tensor::create(Type *type,
+                       std::vector<uint64_t> &length_of_dimensions) {
+  MEMOIR_ASSERT((type->getCode() == TypeCode::TensorTy),
                 "Trying to create a tensor of non-tensor type");
 
-  auto tensor_type = (TensorType *)(this->type);
-  auto element_type = tensor_type->element_type;
-  auto num_dimensions = tensor_type->num_dimensions;
-  this->length_of_dimensions = tensor_type->length_of_dimensions;
+  auto *element_type = static_cast<TensorType *>(type)->element_type;
 
-  MEMOIR_ASSERT((num_dimensions > 0),
-                "Trying to create a tensor with 0 dimensions");
-
-  // FIXME
-  // Initialize the tensor
-  // for (auto dimension_length : this->length_of_dimensions) {
-  //   for (auto i = 0; i < dimension_length; i++) {
-  //     auto field = Element::create(element_type);
-  //     this->tensor.push_back(field);
-  //   }
-  // }
+  return create_typed<TypedTensor, Tensor>(element_type,
+                                           type,
+                                           length_of_dimensions);
 }
 
 Tensor::Tensor(Type *type, std::vector<uint64_t> &length_of_dimensions)
@@ -50,39 +75,27 @@ Tensor::Tensor(Type *type, std::vector<uint64_t> &length_of_dimensions)
                 "Trying to create a tensor of non-tensor type");
 
   auto tensor_type = (TensorType *)(this->type);
-  auto element_type = tensor_type->element_type;
   auto num_dimensions = tensor_type->num_dimensions;
 
   MEMOIR_ASSERT((num_dimensions > 0),
                 "Trying to create a tensor with 0 dimensions");
+}
 
-  // Initialize the tensor
+uint64_t Tensor::get_flattened_length() const {
   auto flattened_length = 0;
   auto last_dimension_length = 1;
-  for (auto i = 0; i < length_of_dimensions.size(); i++) {
-    auto dimension_length = length_of_dimensions[i];
+  for (auto i = 0; i < this->length_of_dimensions.size(); i++) {
+    auto dimension_length = this->length_of_dimensions[i];
 
     flattened_length *= last_dimension_length;
     flattened_length += dimension_length;
     last_dimension_length = dimension_length;
   }
 
-  // FIXME
-  auto init_vector = init_elements(element_type, flattened_length);
-  this->tensor.resize(init_vector.size());
-  std::move(init_vector.begin(), init_vector.end(), this->tensor.begin());
-}
-
-void Tensor::free() {
-  auto *element_type = this->get_element_type();
-  if (is_object_type(element_type)) {
-    for (auto it = this->tensor.begin(); it != this->tensor.end(); ++it) {
-      ((Object *)(*it))->free();
-    }
-  }
+  return flattened_length;
 }
 
-uint64_t Tensor::get_tensor_element(std::vector<uint64_t> &indices) const {
+uint64_t Tensor::flatten(std::vector<uint64_t> &indices) const {
   auto flattened_index = 0;
   auto last_dimension_length = 1;
   for (auto i = 0; i < this->length_of_dimensions.size(); i++) {
@@ -96,28 +109,15 @@ uint64_t Tensor::get_tensor_element(std::vector<uint64_t> &indices) const {
     last_dimension_length = dimension_length;
   }
 
-  return this->tensor[flattened_index];
+  return flattened_index;
 }
 
-uint64_t Tensor::get_element(va_list args) {
-  auto num_dimensions = this->length_of_dimensions.size();
-
-  std::vector<uint64_t> indices = {};
-  for (auto i = 0; i < num_dimensions; i++) {
-    auto index = va_arg(args, uint64_t);
-    indices.push_back(index);
-  }
-
-  return this->get_tensor_element(indices);
-}
-
-void Tensor::set_tensor_element(uint64_t value,
-                                std::vector<uint64_t> &indices) {
+uint64_t Tensor::flatten(va_list args) const {
   auto flattened_index = 0;
   auto last_dimension_length = 1;
   for (auto i = 0; i < this->length_of_dimensions.size(); i++) {
     auto dimension_length = this->length_of_dimensions[i];
-    auto index = indices[i];
+    auto index = va_arg(args, uint64_t);
     MEMOIR_ASSERT((index < dimension_length),
                   "Index out of range for tensor access");
 
@@ -126,60 +126,78 @@ void Tensor::set_tensor_element(uint64_t value,
     last_dimension_length = dimension_length;
   }
 
-  this->tensor[flattened_index] = value;
+  return flattened_index;
+}
+
+uint64_t Tensor::flatten(uint64_t index) const {
+  MEMOIR_ASSERT((this->length_of_dimensions.size() == 1),
+                "Wrong number of dimensions for tensor access");
+  MEMOIR_ASSERT((index < this->length_of_dimensions[0]),
+                "Index out of range for tensor access");
+
+  return index;
+}
+
+uint64_t Tensor::flatten(uint64_t index0, uint64_t index1) const {
+  MEMOIR_ASSERT((this->length_of_dimensions.size() == 2),
+                "Wrong number of dimensions for tensor access");
+  auto dimension_length = this->length_of_dimensions[0];
+  MEMOIR_ASSERT((index0 < dimension_length),
+                "Index out of range for tensor access");
+  MEMOIR_ASSERT((index1 < this->length_of_dimensions[1]),
+                "Index out of range for tensor access");
+
+  return index0 * dimension_length + index1;
+}
+
+uint64_t Tensor::get_tensor_element(std::vector<uint64_t> &indices) const {
+  return this->get_flat_element(this->flatten(indices));
+}
+
+uint64_t Tensor::get_element(va_list args) {
+  return this->get_flat_element(this->flatten(args));
+}
+
+uint64_t Tensor::get_element_1d(uint64_t index) {
+  return this->get_flat_element(this->flatten(index));
+}
+
+uint64_t Tensor::get_element_2d(uint64_t index0, uint64_t index1) {
+  return this->get_flat_element(this->flatten(index0, index1));
+}
+
+void Tensor::set_tensor_element(uint64_t value,
+                                std::vector<uint64_t> &indices) {
+  this->set_flat_element(value, this->flatten(indices));
 }
 
 void Tensor::set_element(uint64_t value, va_list args) {
-  auto num_dimensions = this->length_of_dimensions.size();
+  this->set_flat_element(value, this->flatten(args));
+}
 
-  std::vector<uint64_t> indices = {};
-  for (auto i = 0; i < num_dimensions; i++) {
-    auto index = va_arg(args, uint64_t);
-    indices.push_back(index);
-  }
+void Tensor::set_element_1d(uint64_t value, uint64_t index) {
+  this->set_flat_element(value, this->flatten(index));
+}
 
-  this->set_tensor_element(value, indices);
+void Tensor::set_element_2d(uint64_t value, uint64_t index0, uint64_t index1) {
+  this->set_flat_element(value, this->flatten(index0, index1));
 }
 
 bool Tensor::has_tensor_element(std::vector<uint64_t> &indices) const {
-  auto flattened_index = 0;
-  auto last_dimension_length = 1;
-  for (auto i = 0; i < this->length_of_dimensions.size(); i++) {
-    auto dimension_length = this->length_of_dimensions[i];
-    auto index = indices[i];
-    MEMOIR_ASSERT((index < dimension_length),
-                  "Index out of range for tensor access");
-
-    flattened_index *= last_dimension_length;
-    flattened_index += index;
-    last_dimension_length = dimension_length;
-  }
+  this->flatten(indices);
 
   // TODO.
   return true;
 }
 
 bool Tensor::has_element(va_list args) {
-  auto num_dimensions = this->length_of_dimensions.size();
-
-  std::vector<uint64_t> indices = {};
-  for (auto i = 0; i < num_dimensions; i++) {
-    auto index = va_arg(args, uint64_t);
-    indices.push_back(index);
-  }
+  this->flatten(args);
 
-  return this->has_tensor_element(indices);
+  // TODO.
+  return true;
 }
 
 void Tensor::remove_element(va_list args) {
-  auto num_dimensions = this->length_of_dimensions.size();
-
-  std::vector<uint64_t> indices = {};
-  for (auto i = 0; i < num_dimensions; i++) {
-    auto index = va_arg(args, uint64_t);
-    indices.push_back(index);
-  }
-
   return;
 }
 
@@ -211,28 +229,72 @@ bool Tensor::equals(const Object *other) const {
   return (this == other);
 }
 
+/*
+ * Typed Tensor implementation
+ */
+template <typename T>
+TypedTensor<T>::TypedTensor(Type *type,
+                            std::vector<uint64_t> &length_of_dimensions)
+  : Tensor(type, length_of_dimensions) {
+  // Initialize the tensor
+  this->tensor.resize(this->get_flattened_length());
+
+  auto *element_type = this->get_element_type();
+  if (is_object_type(element_type)) {
+    for (auto &element : this->tensor) {
+      element = (T)init_element(element_type);
+    }
+  }
+}
+
+template <typename T>
+void TypedTensor<T>::free() {
+  // Only pointer-width elements can hold an object.
+  if constexpr (sizeof(T) == sizeof(void *)) {
+    auto *element_type = this->get_element_type();
+    if (is_object_type(element_type)) {
+      for (auto it = this->tensor.begin(); it != this->tensor.end(); ++it) {
+        ((Object *)(*it))->free();
+      }
+    }
+  }
+}
+
+template <typename T>
+uint64_t TypedTensor<T>::get_flat_element(uint64_t flat_index) const {
+  return (uint64_t)this->tensor[flat_index];
+}
+
+template <typename T>
+void TypedTensor<T>::set_flat_element(uint64_t value, uint64_t flat_index) {
+  this->tensor[flat_index] = (T)value;
+}
+
+template struct TypedTensor<uint8_t>;
+template struct TypedTensor<uint16_t>;
+template struct TypedTensor<uint32_t>;
+template struct TypedTensor<uint64_t>;
+
 /*
  * Associative Array implementation
  */
-AssocArray::AssocArray(Type *type) : Collection(type) {
+AssocArray *AssocArray::create(Type *type) {
   MEMOIR_ASSERT(
       (type->getCode() == TypeCode::AssocArrayTy),
       "Trying to create an associative array of non-associative array type\n");
 
-  this->assoc_array.clear();
+  auto *value_type = static_cast<AssocArrayType *>(type)->value_type;
+
+  return create_typed<TypedAssocArray, AssocArray>(value_type, type);
 }
 
-void AssocArray::free() {
-  auto *element_type = this->get_element_type();
-  if (is_object_type(element_type)) {
-    for (auto it = this->assoc_array.begin(); it != this->assoc_array.end();
-         ++it) {
-      ((Object *)(it->second))->free();
-    }
-  }
+AssocArray::AssocArray(Type *type) : Collection(type) {
+  MEMOIR_ASSERT(
+      (type->getCode() == TypeCode::AssocArrayTy),
+      "Trying to create an associative array of non-associative array type\n");
 }
 
-uint64_t AssocArray::get_element(va_list args) {
+AssocArray::key_t AssocArray::read_key(va_list args) const {
   key_t key;
 
   auto key_type = this->get_key_type();
@@ -273,22 +335,18 @@ uint64_t AssocArray::get_element(va_list args) {
       break;
     }
     case TypeCode::FloatTy: {
-      auto type = static_cast<FloatType *>(key_type);
       key = (key_t)((float)va_arg(args, double));
       break;
     }
     case TypeCode::DoubleTy: {
-      auto type = static_cast<DoubleType *>(key_type);
       key = (key_t)va_arg(args, double);
       break;
     }
     case TypeCode::PointerTy: {
-      auto type = static_cast<PointerType *>(key_type);
       key = (key_t)va_arg(args, void *);
       break;
     }
     case TypeCode::ReferenceTy: {
-      auto type = static_cast<ReferenceType *>(key_type);
       key = (key_t)va_arg(args, Object *);
       break;
     }
@@ -297,217 +355,32 @@ uint64_t AssocArray::get_element(va_list args) {
     }
   }
 
-  auto found_key = this->assoc_array.find(key);
-  if (found_key != this->assoc_array.end()) {
-    return found_key->second;
-  } else {
-    // Create a new key-value pair and return it.
-    auto new_elem = init_element(this->get_value_type());
-    this->assoc_array[key] = new_elem;
-    return new_elem;
-  }
+  return key;
 }
 
-void AssocArray::set_element(uint64_t value, va_list args) {
-  key_t key;
-
-  auto key_type = this->get_key_type();
-  switch (key_type->getCode()) {
-    case TypeCode::StructTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::TensorTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::AssocArrayTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::SequenceTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::IntegerTy: {
-      auto integer_type = static_cast<IntegerType *>(key_type);
-      auto bitwidth = integer_type->bitwidth;
-      if (bitwidth < 32) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int)
-                                                : va_arg(args, int));
-      } else if (bitwidth <= 32) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int32_t)
-                                                : va_arg(args, uint32_t));
-      } else if (bitwidth <= 64) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int64_t)
-                                                : va_arg(args, uint64_t));
-      }
-      break;
-    }
-    case TypeCode::FloatTy: {
-      auto type = static_cast<FloatType *>(key_type);
-      key = (key_t)((float)va_arg(args, double));
-      break;
-    }
-    case TypeCode::DoubleTy: {
-      auto type = static_cast<DoubleType *>(key_type);
-      key = (key_t)va_arg(args, double);
-      break;
-    }
-    case TypeCode::PointerTy: {
-      auto type = static_cast<PointerType *>(key_type);
-      key = (key_t)va_arg(args, void *);
-      break;
-    }
-    case TypeCode::ReferenceTy: {
-      auto type = static_cast<ReferenceType *>(key_type);
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    default: {
-      MEMOIR_UNREACHABLE("Attempt to get element with unknown key type");
-    }
-  }
+uint64_t AssocArray::get_element(va_list args) {
+  return this->get_assoc_element(this->read_key(args));
+}
 
-  // FIXME
-  this->assoc_array[key] = (value_t)value;
-  this->assoc_array.find(key);
+uint64_t AssocArray::get_element_1d(uint64_t key) {
+  return this->get_assoc_element((key_t)key);
 }
 
-bool AssocArray::has_element(va_list args) {
-  key_t key;
+void AssocArray::set_element(uint64_t value, va_list args) {
+  this->set_assoc_element(value, this->read_key(args));
+}
 
-  auto key_type = this->get_key_type();
-  switch (key_type->getCode()) {
-    case TypeCode::StructTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::TensorTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::AssocArrayTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::SequenceTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::IntegerTy: {
-      auto integer_type = static_cast<IntegerType *>(key_type);
-      auto bitwidth = integer_type->bitwidth;
-      if (bitwidth < 32) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int)
-                                                : va_arg(args, int));
-      } else if (bitwidth <= 32) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int32_t)
-                                                : va_arg(args, uint32_t));
-      } else if (bitwidth <= 64) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int64_t)
-                                                : va_arg(args, uint64_t));
-      }
-      return (this->assoc_array.find(key) != this->assoc_array.end());
-    }
-    case TypeCode::FloatTy: {
-      auto type = static_cast<FloatType *>(key_type);
-      auto key_as_float = (float)va_arg(args, double);
-      key = (key_t)key_as_float;
-      break;
-    }
-    case TypeCode::DoubleTy: {
-      auto type = static_cast<DoubleType *>(key_type);
-      auto key_as_double = va_arg(args, double);
-      key = (key_t)key_as_double;
-      break;
-    }
-    case TypeCode::PointerTy: {
-      auto type = static_cast<PointerType *>(key_type);
-      auto key_as_ptr = va_arg(args, void *);
-      key = (key_t)key_as_ptr;
-      break;
-    }
-    case TypeCode::ReferenceTy: {
-      auto type = static_cast<ReferenceType *>(key_type);
-      auto key_as_ref = va_arg(args, Object *);
-      key = (key_t)key_as_ref;
-      break;
-    }
-    default: {
-      MEMOIR_UNREACHABLE("Attempt to get element with unknown key type");
-    }
-  }
+void AssocArray::set_element_1d(uint64_t value, uint64_t key) {
+  this->set_assoc_element(value, (key_t)key);
+}
 
+bool AssocArray::has_element(va_list args) {
   // FIXME: equality needs to be updated.
-  auto found_key = this->assoc_array.find(key);
-  return (found_key != this->assoc_array.end());
+  return this->has_assoc_element(this->read_key(args));
 }
 
 void AssocArray::remove_element(va_list args) {
-  key_t key;
-
-  auto key_type = this->get_key_type();
-  switch (key_type->getCode()) {
-    case TypeCode::StructTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::TensorTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::AssocArrayTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::SequenceTy: {
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    case TypeCode::IntegerTy: {
-      auto integer_type = static_cast<IntegerType *>(key_type);
-      auto bitwidth = integer_type->bitwidth;
-      if (bitwidth < 32) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int)
-                                                : va_arg(args, int));
-      } else if (bitwidth <= 32) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int32_t)
-                                                : va_arg(args, uint32_t));
-      } else if (bitwidth <= 64) {
-        key = (key_t)((integer_type->is_signed) ? va_arg(args, int64_t)
-                                                : va_arg(args, uint64_t));
-      }
-      // TODO: do this for all cases.
-      this->assoc_array.erase(key);
-      return;
-    }
-    case TypeCode::FloatTy: {
-      auto type = static_cast<FloatType *>(key_type);
-      key = (key_t)((float)va_arg(args, double));
-      break;
-    }
-    case TypeCode::DoubleTy: {
-      auto type = static_cast<DoubleType *>(key_type);
-      key = (key_t)va_arg(args, double);
-      break;
-    }
-    case TypeCode::PointerTy: {
-      auto type = static_cast<PointerType *>(key_type);
-      key = (key_t)va_arg(args, void *);
-      break;
-    }
-    case TypeCode::ReferenceTy: {
-      auto type = static_cast<ReferenceType *>(key_type);
-      key = (key_t)va_arg(args, Object *);
-      break;
-    }
-    default: {
-      MEMOIR_UNREACHABLE("Attempt to get element with unknown key type");
-    }
-  }
-
-  return;
+  this->remove_assoc_element(this->read_key(args));
 }
 
 Collection *AssocArray::get_slice(va_list args) {
@@ -539,24 +412,93 @@ Type *AssocArray::get_value_type() const {
   return assoc_array_type->value_type;
 }
 
-uint64_t AssocArray::size() const {
+bool AssocArray::equals(const Object *other) const {
+  return (this == other);
+}
+
+/*
+ * Typed Associative Array implementation
+ */
+template <typename T>
+TypedAssocArray<T>::TypedAssocArray(Type *type) : AssocArray(type) {
+  // Do nothing.
+}
+
+template <typename T>
+void TypedAssocArray<T>::free() {
+  // Only pointer-width elements can hold an object.
+  if constexpr (sizeof(T) == sizeof(void *)) {
+    auto *element_type = this->get_element_type();
+    if (is_object_type(element_type)) {
+      for (auto it = this->assoc_array.begin(); it != this->assoc_array.end();
+           ++it) {
+        ((Object *)(it->second))->free();
+      }
+    }
+  }
+}
+
+template <typename T>
+AssocArray *TypedAssocArray<T>::copy() const {
+  auto *new_assoc = new TypedAssocArray<T>(this->get_type());
+  new_assoc->assoc_array = this->assoc_array;
+  return new_assoc;
+}
+
+template <typename T>
+uint64_t TypedAssocArray<T>::size() const {
   return this->assoc_array.size();
 }
 
-Collection *AssocArray::keys() const {
-  std::vector<AssocArray::key_t> assoc_keys;
-  assoc_keys.reserve(this->assoc_array.size());
+template <typename T>
+Collection *TypedAssocArray<T>::keys() const {
+  auto *keys =
+      SequenceAlloc::create(SequenceType::get(this->get_key_type()), 0);
   for (auto const &[k, v] : this->assoc_array) {
-    assoc_keys.push_back(k);
+    keys->insert(keys->size(), k);
   }
-  return new SequenceAlloc(SequenceType::get(this->get_key_type()),
-                           std::move(assoc_keys));
+  return keys;
 }
 
-bool AssocArray::equals(const Object *other) const {
-  return (this == other);
+template <typename T>
+uint64_t TypedAssocArray<T>::get_assoc_element(key_t key) {
+  auto found_key = this->assoc_array.find(key);
+  if (found_key != this->assoc_array.end()) {
+    return (uint64_t)found_key->second;
+  } else {
+    // Create a new key-value pair and return it.
+    auto new_elem = (T)init_element(this->get_value_type());
+    this->assoc_array[key] = new_elem;
+    return (uint64_t)new_elem;
+  }
+}
+
+template <typename T>
+void TypedAssocArray<T>::set_assoc_element(uint64_t value, key_t key) {
+  this->assoc_array[key] = (T)value;
+}
+
+template <typename T>
+bool TypedAssocArray<T>::has_assoc_element(key_t key) const {
+  return (this->assoc_array.find(key) != this->assoc_array.end());
+}
+
+template <typename T>
+void TypedAssocArray<T>::remove_assoc_element(key_t key) {
+  this->assoc_array.erase(key);
+}
+
+template <typename T>
+void TypedAssocArray<T>::clear() {
+  // Keep the buckets around, so that the assoc can be refilled cheaply.
+  this->assoc_array.clear();
 }
 
+template struct TypedAssocArray<uint8_t>;
+template struct TypedAssocArray<uint16_t>;
+template struct TypedAssocArray<uint32_t>;
+template struct TypedAssocArray<uint64_t>;
+
 /*
  * Sequence implementation
  */
@@ -571,12 +513,20 @@ uint64_t Sequence::get_element(va_list args) {
   return this->get_sequence_element(index);
 }
 
+uint64_t Sequence::get_element_1d(uint64_t index) {
+  return this->get_sequence_element(index);
+}
+
 void Sequence::set_element(uint64_t value, va_list args) {
   auto index = va_arg(args, uint64_t);
 
   return this->set_sequence_element(value, index);
 }
 
+void Sequence::set_element_1d(uint64_t value, uint64_t index) {
+  return this->set_sequence_element(value, index);
+}
+
 bool Sequence::has_element(va_list args) {
   auto index = va_arg(args, uint64_t);
 
@@ -599,28 +549,18 @@ Collection *Sequence::get_slice(va_list args) {
 
 Collection *Sequence::join(SequenceType *type,
                            std::vector<Sequence *> sequences_to_join) {
-  uint64_t initial_size = 0;
-  for (auto sequence_to_join : sequences_to_join) {
-    initial_size += sequence_to_join->size();
-  }
-
-  std::vector<uint64_t> new_vector(sequences_to_join.at(0)->begin(),
-                                   sequences_to_join.at(0)->end());
+  auto *first_sequence = sequences_to_join.at(0);
+  auto *new_sequence = first_sequence->copy(0, first_sequence->size());
   if (sequences_to_join.size() > 1) {
     for (auto seq_it = sequences_to_join.begin() + 1;
          seq_it != sequences_to_join.end();
          ++seq_it) {
       // TODO: We need to make this an Element::clone, OR change structs to be
       // backed by persistent data structures as well.
-      for (auto elem_it = (*seq_it)->begin(); elem_it != (*seq_it)->end();
-           ++elem_it) {
-        new_vector.push_back(*elem_it);
-      }
+      new_sequence->insert(new_sequence->size(), *seq_it);
     }
   }
 
-  auto new_sequence = new SequenceAlloc(type, std::move(new_vector));
-
   return new_sequence;
 }
 
@@ -663,47 +603,32 @@ Type *Sequence::get_element_type() const {
   return sequence_type->element_type;
 }
 
-/*
- * SequenceAlloc implementation.
- */
-SequenceAlloc::SequenceAlloc(SequenceType *type, size_t initial_size)
-  : SequenceAlloc(type,
-                  std::move(init_elements(type->element_type, initial_size))) {
-  // Do nothing.
-}
-
-SequenceAlloc::SequenceAlloc(SequenceType *type,
-                             std::vector<uint64_t> &&initial)
-  : Sequence(type),
-    _sequence(initial) {
-  // Do nothing.
+void Sequence::clear() {
+  this->erase(0, this->size());
 }
 
-void SequenceAlloc::free() {
-  auto *element_type = this->get_element_type();
-  if (is_object_type(element_type)) {
-    for (auto it = this->_sequence.begin(); it != this->_sequence.end(); ++it) {
-      ((Object *)(*it))->free();
-    }
+void Sequence::swap(uint64_t from,
+                    uint64_t to,
+                    Sequence *other,
+                    uint64_t other_from) {
+  for (auto i = from, j = other_from; i < to; ++i, ++j) {
+    auto element = this->get_sequence_element(i);
+    this->set_sequence_element(other->get_sequence_element(j), i);
+    other->set_sequence_element(element, j);
   }
 }
 
-uint64_t SequenceAlloc::get_sequence_element(uint64_t index) {
-  MEMOIR_ASSERT((index < this->size()),
-                "Attempt to access out of range element of sequence");
-
-  return this->_sequence.at(index);
-}
-
-void SequenceAlloc::set_sequence_element(uint64_t value, uint64_t index) {
-  MEMOIR_ASSERT((index < this->size()),
-                "Attempt to access out of range element of sequence");
-
-  this->_sequence[index] = value;
+/*
+ * SequenceAlloc implementation.
+ */
+SequenceAlloc *SequenceAlloc::create(SequenceType *type, size_t initial_size) {
+  return create_typed<TypedSequence, SequenceAlloc>(type->element_type,
+                                                    type,
+                                                    initial_size);
 }
 
-bool SequenceAlloc::has_sequence_element(uint64_t index) {
-  return (index < this->size());
+SequenceAlloc::SequenceAlloc(SequenceType *type) : Sequence(type) {
+  // Do nothing.
 }
 
 Collection *SequenceAlloc::get_sequence_slice(int64_t left_index,
@@ -728,68 +653,141 @@ Collection *SequenceAlloc::get_sequence_slice(int64_t left_index,
    * Otherwise, get the slice inbetween the left and right index.
    */
   if (left_index > right_index) {
-    auto length = left_index - right_index;
-    auto type = static_cast<SequenceType *>(this->get_type());
-
-    return new SequenceAlloc(
-        type,
-        std::move(std::vector<uint64_t>(this->_sequence.begin() + right_index,
-                                        this->_sequence.begin() + left_index)));
+    return this->copy(right_index, left_index);
   } else {
-    auto length = right_index - left_index;
-    auto type = static_cast<SequenceType *>(this->get_type());
+    return this->copy(left_index, right_index);
+  }
+}
 
-    return new SequenceAlloc(type,
-                             std::move(std::vector<uint64_t>(
-                                 this->_sequence.begin() + left_index,
-                                 this->_sequence.begin() + right_index)));
+bool SequenceAlloc::equals(const Object *other) const {
+  return (this == other);
+}
+
+/*
+ * Typed SequenceAlloc implementation.
+ */
+template <typename T>
+TypedSequence<T>::TypedSequence(SequenceType *type, size_t initial_size)
+  : SequenceAlloc(type),
+    _sequence(initial_size) {
+  auto *element_type = this->get_element_type();
+  if (is_object_type(element_type)) {
+    for (auto &element : this->_sequence) {
+      element = (T)init_element(element_type);
+    }
   }
-  return nullptr;
 }
 
-uint64_t SequenceAlloc::size() const {
-  return this->_sequence.size();
+template <typename T>
+void TypedSequence<T>::free() {
+  // Only pointer-width elements can hold an object.
+  if constexpr (sizeof(T) == sizeof(void *)) {
+    auto *element_type = this->get_element_type();
+    if (is_object_type(element_type)) {
+      for (auto it = this->_sequence.begin(); it != this->_sequence.end();
+           ++it) {
+        ((Object *)(*it))->free();
+      }
+    }
+  }
 }
 
-Sequence::seq_iter SequenceAlloc::begin() {
-  return this->_sequence.begin();
+template <typename T>
+SequenceAlloc *TypedSequence<T>::copy(uint64_t from, uint64_t to) {
+  auto *type = static_cast<SequenceType *>(this->get_type());
+  auto *new_sequence = new TypedSequence<T>(type, 0);
+  new_sequence->_sequence.assign(this->_sequence.begin() + from,
+                                 this->_sequence.begin() + to);
+  return new_sequence;
 }
 
-Sequence::seq_iter SequenceAlloc::end() {
-  return this->_sequence.end();
+template <typename T>
+uint64_t TypedSequence<T>::get_sequence_element(uint64_t index) {
+  MEMOIR_ASSERT((index < this->size()),
+                "Attempt to access out of range element of sequence");
+
+  return (uint64_t)this->_sequence[index];
 }
 
-Sequence::const_seq_iter SequenceAlloc::cbegin() const {
-  return this->_sequence.cbegin();
+template <typename T>
+void TypedSequence<T>::set_sequence_element(uint64_t value, uint64_t index) {
+  MEMOIR_ASSERT((index < this->size()),
+                "Attempt to access out of range element of sequence");
+
+  this->_sequence[index] = (T)value;
 }
 
-Sequence::const_seq_iter SequenceAlloc::cend() const {
-  return this->_sequence.cend();
+template <typename T>
+bool TypedSequence<T>::has_sequence_element(uint64_t index) {
+  return (index < this->size());
 }
 
-// Mutable operations
-void SequenceAlloc::insert(uint64_t index, uint64_t value) {
-  this->_sequence.insert(this->_sequence.begin() + index, value);
+template <typename T>
+uint64_t TypedSequence<T>::size() const {
+  return this->_sequence.size();
 }
 
-void SequenceAlloc::insert(uint64_t start, Sequence *seq) {
+// Mutable operations
+template <typename T>
+void TypedSequence<T>::insert(uint64_t index, uint64_t value) {
+  this->_sequence.insert(this->_sequence.begin() + index, (T)value);
+}
+
+template <typename T>
+void TypedSequence<T>::insert(uint64_t start, Sequence *seq) {
+  auto *typed_seq = dynamic_cast<TypedSequence<T> *>(seq);
+  if (typed_seq != nullptr && typed_seq != this) {
+    this->_sequence.insert(this->_sequence.begin() + start,
+                           typed_seq->_sequence.begin(),
+                           typed_seq->_sequence.end());
+    return;
+  }
+
+  // Otherwise, gather the elements before inserting them.
+  std::vector<T> elements;
+  elements.reserve(seq->size());
+  for (uint64_t i = 0; i < seq->size(); ++i) {
+    elements.push_back((T)seq->get_sequence_element(i));
+  }
   this->_sequence.insert(this->_sequence.begin() + start,
-                         seq->begin(),
-                         seq->end());
+                         elements.begin(),
+                         elements.end());
 }
 
-void SequenceAlloc::erase(uint64_t from, uint64_t to) {
+template <typename T>
+void TypedSequence<T>::erase(uint64_t from, uint64_t to) {
   this->_sequence.erase(this->_sequence.begin() + from,
                         this->_sequence.begin() + to);
 };
 
-void SequenceAlloc::grow(uint64_t size) {
+template <typename T>
+void TypedSequence<T>::grow(uint64_t size) {
   this->_sequence.resize(this->_sequence.size() + size);
 };
 
-bool SequenceAlloc::equals(const Object *other) const {
-  return (this == other);
-}
+template <typename T>
+void TypedSequence<T>::fill(uint64_t from, uint64_t to, uint64_t value) {
+  MEMOIR_ASSERT((to <= this->size()),
+                "Attempt to fill out of range elements of sequence");
+
+  std::fill(this->_sequence.begin() + from,
+            this->_sequence.begin() + to,
+            (T)value);
+};
+
+template <typename T>
+void TypedSequence<T>::reserve(uint64_t capacity) {
+  // Grow geometrically, so repeated reserves stay amortized.
+  auto current = this->_sequence.capacity();
+  if (capacity > current) {
+    this->_sequence.reserve(std::max<uint64_t>(capacity, 2 * current));
+  }
+};
+
+template struct TypedSequence<uint8_t>;
+template struct TypedSequence<uint16_t>;
+template struct TypedSequence<uint32_t>;
+template struct TypedSequence<uint64_t>;
 
 /*
  * SequenceView implementation
@@ -838,24 +836,12 @@ Collection *SequenceView::get_sequence_slice(int64_t left_index,
                                              right_index + this->to);
 }
 
-uint64_t SequenceView::size() const {
-  return this->to - this->from;
+SequenceAlloc *SequenceView::copy(uint64_t from, uint64_t to) {
+  return this->_sequence->copy(from + this->from, to + this->from);
 }
 
-Sequence::seq_iter SequenceView::begin() {
-  return this->_sequence->begin() + this->from;
-}
-
-Sequence::seq_iter SequenceView::end() {
-  return this->_sequence->begin() + this->to;
-}
-
-Sequence::const_seq_iter SequenceView::cbegin() const {
-  return this->_sequence->cbegin() + this->from;
-}
-
-Sequence::const_seq_iter SequenceView::cend() const {
-  return this->_sequence->cbegin() + this->to;
+uint64_t SequenceView::size() const {
+  return this->to - this->from;
 }
 
 bool SequenceView::equals(const Object *other) const {
@@ -879,5 +865,14 @@ void SequenceView::grow(uint64_t size) {
   this->_sequence->grow(size);
 };
 
+void SequenceView::fill(uint64_t from, uint64_t to, uint64_t value) {
+  this->_sequence->fill(from + this->from, to + this->from, value);
+};
+
+void SequenceView::reserve(uint64_t capacity) {
+  // Views do not own their storage, there is nothing to reserve.
+  return;
+};
+
 } // namespace detail
 } // namespace memoir
@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <iostream>
+#include <new>
 
 #include "internal.h"
 #include "objects.h"
@@ -33,28 +35,55 @@ bool Object::is_element() const {
 /*
  * Struct Objects
  */
-Struct::Struct(Type *type) : Object(type) {
+void *Struct::allocate(uint64_t num_fields) {
+  static_assert((alignof(Struct) % alignof(uint64_t)) == 0,
+                "Inline fields are misaligned");
+  return ::operator new(sizeof(Struct) + num_fields * sizeof(uint64_t));
+}
+
+void Struct::operator delete(void *ptr) {
+  ::operator delete(ptr);
+}
+
+Struct *Struct::create(Type *type) {
   MEMOIR_ASSERT((type->getCode() == TypeCode::StructTy),
                 "Trying to create a struct of non-struct type");
 
+  auto *struct_type = static_cast<StructType *>(type);
+  auto *memory = Struct::allocate(struct_type->fields.size());
+  return new (memory) Struct(type);
+}
+
+Struct *Struct::create(Struct *other) {
+  auto *memory = Struct::allocate(other->num_fields);
+  return new (memory) Struct(other);
+}
+
+Struct::Struct(Type *type) : Object(type) {
   // Initialize the fields
   auto object_type = (StructType *)(type);
-  this->fields.reserve(object_type->fields.size());
+  this->num_fields = object_type->fields.size();
+  auto *fields = this->fields();
   for (auto field_type : object_type->fields) {
-    auto field = init_element(field_type);
-    this->fields.push_back(field);
+    *(fields++) = init_element(field_type);
   }
 }
 
 Struct::Struct(Struct *other) : Object(other->type) {
   // Clone the fields.
-  auto type = static_cast<StructType *>(other->get_type());
-  this->fields.reserve(other->fields.size());
-  for (auto i = 0; i < other->fields.size(); i++) {
-    auto other_field = other->fields[i];
-    // TODO: perform a deep copy of the other field if its a pointer.
-    this->fields.push_back(other_field);
-  }
+  // TODO: perform a deep copy of the other field if its a pointer.
+  this->num_fields = other->num_fields;
+  std::copy(other->fields(),
+            other->fields() + other->num_fields,
+            this->fields());
+}
+
+uint64_t *Struct::fields() {
+  return reinterpret_cast<uint64_t *>(this + 1);
+}
+
+const uint64_t *Struct::fields() const {
+  return reinterpret_cast<const uint64_t *>(this + 1);
 }
 
 void Struct::free() {
@@ -62,24 +91,24 @@ void Struct::free() {
   auto field_index = 0;
   for (auto *field_type : struct_type->fields) {
     if (is_object_type(field_type)) {
-      ((Object *)(this->fields[field_index]))->free();
+      ((Object *)(this->fields()[field_index]))->free();
     }
     field_index++;
   }
 }
 
 uint64_t Struct::get_field(uint64_t field_index) const {
-  MEMOIR_ASSERT((field_index < this->fields.size()),
+  MEMOIR_ASSERT((field_index < this->num_fields),
                 "Trying to read field from index outside of struct's range");
 
-  return this->fields.at(field_index);
+  return this->fields()[field_index];
 }
 
 void Struct::set_field(uint64_t value, uint64_t field_index) {
-  MEMOIR_ASSERT((field_index < this->fields.size()),
+  MEMOIR_ASSERT((field_index < this->num_fields),
                 "Trying to write field from index outside of struct's range");
 
-  this->fields[field_index] = value;
+  this->fields()[field_index] = value;
 }
 
 bool Struct::equals(const Object *other) const {
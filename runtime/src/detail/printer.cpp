@@ -9,7 +9,8 @@ namespace detail {
 
 std::string Struct::to_string() {
   std::string str = "(Struct: \n";
-  for (auto field : this->fields) {
+  for (uint64_t i = 0; i < this->num_fields; i++) {
+    auto field = this->get_field(i);
     str += "  (Field: ";
     str += "    ";
     // TODO: decode the element and print it.
@@ -1,3 +1,4 @@
+#include <atomic>
 #include <iostream>
 
 #include "internal.h"
@@ -60,6 +61,27 @@ bool is_intrinsic_type(Type *type) {
   }
 }
 
+size_t get_storage_size(Type *type) {
+  TypeCode code = type->getCode();
+  switch (code) {
+    case IntegerTy: {
+      auto bitwidth = static_cast<IntegerType *>(type)->bitwidth;
+      if (bitwidth <= 8) {
+        return 1;
+      } else if (bitwidth <= 16) {
+        return 2;
+      } else if (bitwidth <= 32) {
+        return 4;
+      }
+      return 8;
+    }
+    default:
+      // Floating point values are boxed by value conversion, so they are
+      // stored at full width along with pointers, references and objects.
+      return 8;
+  }
+}
+
 /*
  * Type base class
  */
@@ -74,28 +96,21 @@ Type::Type(TypeCode code) : Type::Type(code, "") {
 /*
  * Struct Type
  */
-std::unordered_map<const char *, Type *> &StructType::struct_types() {
-  static std::unordered_map<const char *, Type *> struct_types;
+TypeRegistry<std::string, StructType> &StructType::struct_types() {
+  static TypeRegistry<std::string, StructType> struct_types;
 
   return struct_types;
 }
 
 StructType *StructType::get(const char *name) {
-  auto found_type = StructType::struct_types().find(name);
-  if (found_type != StructType::struct_types().end()) {
-    return static_cast<StructType *>(found_type->second);
-  }
-
-  /*
-   * Create an empty struct type that will be resolved later.
-   */
-  std::vector<Type *> empty_fields;
-  empty_fields.clear();
-  auto empty_struct = new StructType(name, empty_fields);
-
-  StructType::struct_types()[name] = empty_struct;
-
-  return empty_struct;
+  // Struct types are keyed by the contents of their name, not its address.
+  return StructType::struct_types().get_or_create(name, [name]() {
+    /*
+     * Create an empty struct type that will be resolved later.
+     */
+    std::vector<Type *> empty_fields;
+    return new StructType(name, empty_fields);
+  });
 }
 
 StructType *StructType::define(const char *name,
@@ -125,60 +140,38 @@ bool StructType::equals(Type *other) {
  */
 const uint64_t TensorType::unknown_length = 0;
 
-TensorType::static_tensor_type_list &TensorType::get_static_tensor_types() {
-  static TensorType::static_tensor_type_list static_tensor_types;
+TypeRegistry<TensorType::static_tensor_key, TensorType> &
+TensorType::static_tensor_types() {
+  static TypeRegistry<static_tensor_key, TensorType> static_tensor_types;
   return static_tensor_types;
 }
 
-TensorType::tensor_type_list &TensorType::get_tensor_types() {
-  static TensorType::tensor_type_list tensor_types;
+TypeRegistry<TensorType::tensor_key, TensorType> &TensorType::tensor_types() {
+  static TypeRegistry<tensor_key, TensorType> tensor_types;
   return tensor_types;
 }
 
 TensorType *TensorType::get(Type *element_type, uint64_t num_dimensions) {
-  auto &tensor_types = TensorType::get_tensor_types();
-  for (auto const &[elem_type, num_dims, tensor_type] : tensor_types) {
-    if ((elem_type == element_type) && (num_dims == num_dimensions)) {
-      return tensor_type;
-    }
-  }
-
-  std::vector<uint64_t> length_of_dimensions;
-
-  for (auto i = 0; i < num_dimensions; i++) {
-    length_of_dimensions.push_back(TensorType::unknown_length);
-  }
+  auto key = std::make_pair(element_type, num_dimensions);
+  return TensorType::tensor_types().get_or_create(key, [&]() {
+    std::vector<uint64_t> length_of_dimensions;
 
-  auto *new_tensor_type =
-      new TensorType(element_type, num_dimensions, length_of_dimensions);
-
-  tensor_types.push_front(
-      std::tuple(element_type, num_dimensions, new_tensor_type));
+    for (auto i = 0; i < num_dimensions; i++) {
+      length_of_dimensions.push_back(TensorType::unknown_length);
+    }
 
-  return new_tensor_type;
+    return new TensorType(element_type, num_dimensions, length_of_dimensions);
+  });
 }
 
 TensorType *TensorType::get(Type *element_type,
                             uint64_t num_dimensions,
                             std::vector<uint64_t> &length_of_dimensions) {
-  auto &tensor_types = TensorType::get_static_tensor_types();
-  for (auto const &[elem_type, num_dims, len_of_dims, tensor_type] :
-       tensor_types) {
-    if ((elem_type == element_type) && (num_dims == num_dimensions)
-        && (len_of_dims == length_of_dimensions)) {
-      return tensor_type;
-    }
-  }
-
-  auto new_tensor_type =
-      new TensorType(element_type, num_dimensions, length_of_dimensions);
-
-  tensor_types.push_front(std::tuple(element_type,
-                                     num_dimensions,
-                                     length_of_dimensions,
-                                     new_tensor_type));
-
-  return new_tensor_type;
+  auto key =
+      std::make_tuple(element_type, num_dimensions, length_of_dimensions);
+  return TensorType::static_tensor_types().get_or_create(key, [&]() {
+    return new TensorType(element_type, num_dimensions, length_of_dimensions);
+  });
 }
 
 TensorType::TensorType(Type *element_type, uint64_t num_dimensions)
@@ -239,9 +232,18 @@ bool TensorType::equals(Type *other) {
 /*
  * Associative Array Type
  */
+TypeRegistry<std::pair<Type *, Type *>, AssocArrayType> &
+AssocArrayType::assoc_array_types() {
+  static TypeRegistry<std::pair<Type *, Type *>, AssocArrayType>
+      assoc_array_types;
+  return assoc_array_types;
+}
+
 AssocArrayType *AssocArrayType::get(Type *key_type, Type *value_type) {
-  // TODO, make these unique
-  return new AssocArrayType(key_type, value_type);
+  auto key = std::make_pair(key_type, value_type);
+  return AssocArrayType::assoc_array_types().get_or_create(key, [&]() {
+    return new AssocArrayType(key_type, value_type);
+  });
 }
 
 AssocArrayType::AssocArrayType(Type *key_type, Type *value_type)
@@ -265,25 +267,18 @@ bool AssocArrayType::equals(Type *other) {
  * Sequence Type
  */
 
-std::unordered_map<Type *, SequenceType *> &SequenceType::sequence_types() {
-  static std::unordered_map<Type *, SequenceType *> sequence_types;
+TypeRegistry<Type *, SequenceType> &SequenceType::sequence_types() {
+  static TypeRegistry<Type *, SequenceType> sequence_types;
 
   return sequence_types;
 }
 
 SequenceType *SequenceType::get(Type *element_type) {
-  // See if we already have a sequence type for this element type.
-  auto &sequence_types = SequenceType::sequence_types();
-  auto found_type = sequence_types.find(element_type);
-  if (found_type != sequence_types.end()) {
-    return static_cast<SequenceType *>(found_type->second);
-  }
-
-  // If we couldn't find a sequence type for this element type, create and
+  // If we don't have a sequence type for this element type yet, create and
   // memoize a new one.
-  auto new_type = new SequenceType(element_type);
-  sequence_types[element_type] = new_type;
-  return new_type;
+  return SequenceType::sequence_types().get_or_create(element_type, [&]() {
+    return new SequenceType(element_type);
+  });
 }
 
 SequenceType::SequenceType(Type *element_type)
@@ -305,27 +300,28 @@ bool SequenceType::equals(Type *other) {
  * Integer Type
  */
 IntegerType *IntegerType::get(unsigned bitwidth, bool is_signed) {
-  static std::unordered_map<
-      // bitwidth
-      unsigned,
-      std::unordered_map<
-          // is_signed
-          bool,
-          IntegerType *>>
-      integer_types;
-
-  auto found_bitwidth = integer_types.find(bitwidth);
-  if (found_bitwidth != integer_types.end()) {
-    auto bitwidth_types = found_bitwidth->second;
-    auto found_signed = bitwidth_types.find(is_signed);
-    if (found_signed != bitwidth_types.end()) {
-      auto integer_type = found_signed->second;
-      return integer_type;
-    }
+  MEMOIR_ASSERT((bitwidth <= 64),
+                "Attempt to get integer type wider than 64 bits.");
+
+  // Integer types are on the hot path, so they are looked up without locking.
+  static std::atomic<IntegerType *> integer_types[65][2];
+
+  auto &slot = integer_types[bitwidth][is_signed];
+  auto *integer_type = slot.load(std::memory_order_acquire);
+  if (integer_type != nullptr) {
+    return integer_type;
+  }
+
+  // If another thread registered the type first, use theirs.
+  auto *new_integer_type = new IntegerType(bitwidth, is_signed);
+  if (!slot.compare_exchange_strong(integer_type,
+                                    new_integer_type,
+                                    std::memory_order_acq_rel,
+                                    std::memory_order_acquire)) {
+    delete new_integer_type;
+    return integer_type;
   }
 
-  auto new_integer_type = new IntegerType(bitwidth, is_signed);
-  integer_types[bitwidth][is_signed] = new_integer_type;
   return new_integer_type;
 }
 
@@ -411,8 +407,16 @@ bool PointerType::equals(Type *other) {
 /*
  * Reference Type
  */
+TypeRegistry<Type *, ReferenceType> &ReferenceType::reference_types() {
+  static TypeRegistry<Type *, ReferenceType> reference_types;
+
+  return reference_types;
+}
+
 ReferenceType *ReferenceType::get(Type *referenced_type) {
-  return new ReferenceType(referenced_type);
+  return ReferenceType::reference_types().get_or_create(
+      referenced_type,
+      [&]() { return new ReferenceType(referenced_type); });
 }
 
 ReferenceType::ReferenceType(Type *referenced_type)
@@ -143,5 +143,43 @@ extern "C" {
 #undef HANDLE_PRIMITIVE_TYPE
 #undef HANDLE_REFERENCE_TYPE
 
+// Arity-specialized accesses, these avoid the va_list of the variadic accesses.
+#define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(index_write_##TYPE_NAME##_1d)(                                 \
+      C_TYPE value,                                                            \
+      collection_ref collection_to_access,                                     \
+      size_t index) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    ((detail::Collection *)collection_to_access)                               \
+        ->set_element_1d((uint64_t)value, index);                              \
+  }                                                                            \
+                                                                               \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(index_write_##TYPE_NAME##_2d)(                                 \
+      C_TYPE value,                                                            \
+      collection_ref collection_to_access,                                     \
+      size_t index0,                                                           \
+      size_t index1) {                                                         \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    ((detail::Collection *)collection_to_access)                               \
+        ->set_element_2d((uint64_t)value, index0, index1);                     \
+  }                                                                            \
+                                                                               \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(assoc_write_##TYPE_NAME##_1d)(                                 \
+      C_TYPE value,                                                            \
+      collection_ref collection_to_access,                                     \
+      uint64_t key) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    ((detail::Collection *)collection_to_access)                               \
+        ->set_element_1d((uint64_t)value, key);                                \
+  }
+
+#include "types.def"
+
 } // extern "C"
 } // namespace memoir
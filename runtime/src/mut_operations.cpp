@@ -14,6 +14,15 @@
 namespace memoir {
 extern "C" {
 
+// Mutable collection operations.
+__RUNTIME_ATTR
+void MUT_FUNC(clear)(collection_ref collection) {
+  // Remove all elements from the collection, keeping its storage.
+  MEMOIR_ACCESS_CHECK(collection);
+
+  ((detail::Collection *)collection)->clear();
+}
+
 // Mutable sequence operations.
 #define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
   __RUNTIME_ATTR                                                               \
@@ -55,6 +64,23 @@ void MUT_FUNC(sequence_remove)(collection_ref collection,
   seq->erase(begin, end);
 }
 
+#define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
+  __RUNTIME_ATTR                                                               \
+  void MUT_FUNC(sequence_fill_##TYPE_NAME)(C_TYPE value,                       \
+                                           collection_ref collection,          \
+                                           size_t begin,                       \
+                                           size_t end) {                       \
+    /* Fill a range of a sequence with a single value. */                      \
+    MEMOIR_ACCESS_CHECK(collection);                                           \
+    MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);                       \
+    auto *seq = (detail::Sequence *)(collection);                              \
+    if (end == (size_t)-1) {                                                   \
+      end = seq->size();                                                       \
+    }                                                                          \
+    seq->fill(begin, end, (uint64_t)value);                                    \
+  }
+#include "types.def"
+
 __RUNTIME_ATTR
 void MUT_FUNC(sequence_append)(collection_ref collection,
                                collection_ref collection_to_append) {
@@ -67,11 +93,7 @@ void MUT_FUNC(sequence_append)(collection_ref collection,
   auto *seq1 = (detail::Sequence *)(collection);
   auto *seq2 = (detail::Sequence *)(collection_to_append);
 
-  auto size1 = seq1->size();
-  auto size2 = seq2->size();
-  seq1->grow(size2);
-
-  std::copy(seq2->begin(), seq2->end(), seq1->begin() + size1);
+  seq1->insert(seq1->size(), seq2);
 
   delete seq2;
 }
@@ -98,11 +120,7 @@ void MUT_FUNC(sequence_swap)(collection_ref collection,
 
   MEMOIR_ASSERT((j2 <= seq2->size()), "Buffer overflow on copy.");
 
-  auto it1 = seq1->begin() + i;
-  auto it2 = seq2->begin() + i2;
-  for (auto k = 0; k < m; k++, ++it1, ++it2) {
-    std::swap(*it1, *it2);
-  }
+  seq1->swap(i, j, seq2, i2);
 }
 
 __RUNTIME_ATTR
@@ -124,11 +142,7 @@ void MUT_FUNC(sequence_swap_within)(collection_ref collection,
 
   MEMOIR_ASSERT((j2 <= seq->size()), "Buffer overflow on copy.");
 
-  auto it1 = seq->begin() + i;
-  auto it2 = seq->begin() + i2;
-  for (auto k = 0; k < m; k++, ++it1, ++it2) {
-    std::swap(*it1, *it2);
-  }
+  seq->swap(i, j, seq, i2);
 }
 
 __RUNTIME_ATTR
@@ -141,20 +155,14 @@ collection_ref MUT_FUNC(sequence_split)(collection_ref collection,
   MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);
 
   auto *seq = (detail::Sequence *)(collection);
-  auto *seq_type = static_cast<SequenceType *>(seq->get_type());
 
   MEMOIR_ASSERT((i <= j), "Reverse split is unsupported.");
 
-  auto m = j - i;
-
-  std::vector<uint64_t> new_container;
-  new_container.resize(m);
-  std::move(seq->begin() + i, seq->begin() + j, new_container.begin());
+  auto *new_seq = seq->copy(i, j);
 
   seq->erase(i, j);
 
-  return (collection_ref) new detail::SequenceAlloc(seq_type,
-                                                    std::move(new_container));
+  return (collection_ref)new_seq;
 }
 
 // Assoc operations.
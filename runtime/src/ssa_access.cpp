@@ -352,5 +352,133 @@ extern "C" {
 #undef HANDLE_REFERENCE_TYPE
 #undef HANDLE_NESTED_TYPE
 
+// Arity-specialized accesses, these avoid the va_list of the variadic accesses.
+#define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_read_##TYPE_NAME##_1d)(                             \
+      const collection_ref collection_to_access,                               \
+      size_t index) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    auto element = ((detail::Collection *)collection_to_access)                \
+                       ->get_element_1d(index);                                \
+                                                                               \
+    return (C_TYPE)element;                                                    \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_read_##TYPE_NAME##_2d)(                             \
+      const collection_ref collection_to_access,                               \
+      size_t index0,                                                           \
+      size_t index1) {                                                         \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    auto element = ((detail::Collection *)collection_to_access)                \
+                       ->get_element_2d(index0, index1);                       \
+                                                                               \
+    return (C_TYPE)element;                                                    \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(index_write_##TYPE_NAME##_1d)(                    \
+      C_TYPE value,                                                            \
+      const collection_ref collection_to_access,                               \
+      size_t index) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    ((detail::Collection *)collection_to_access)                               \
+        ->set_element_1d((uint64_t)value, index);                              \
+    return collection_to_access;                                               \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(index_write_##TYPE_NAME##_2d)(                    \
+      C_TYPE value,                                                            \
+      const collection_ref collection_to_access,                               \
+      size_t index0,                                                           \
+      size_t index1) {                                                         \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    ((detail::Collection *)collection_to_access)                               \
+        ->set_element_2d((uint64_t)value, index0, index1);                     \
+    return collection_to_access;                                               \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(assoc_read_##TYPE_NAME##_1d)(                             \
+      const collection_ref collection_to_access,                               \
+      uint64_t key) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    auto element =                                                             \
+        ((detail::Collection *)collection_to_access)->get_element_1d(key);     \
+                                                                               \
+    return (C_TYPE)element;                                                    \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(assoc_write_##TYPE_NAME##_1d)(                    \
+      C_TYPE value,                                                            \
+      const collection_ref collection_to_access,                               \
+      uint64_t key) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    ((detail::Collection *)collection_to_access)                               \
+        ->set_element_1d((uint64_t)value, key);                                \
+    return collection_to_access;                                               \
+  }
+
+#define HANDLE_NESTED_TYPE(TYPE_NAME, C_TYPE, CLASS_PREFIX)                    \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_get_##TYPE_NAME##_1d)(                              \
+      const collection_ref collection_to_access,                               \
+      size_t index) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    auto element = ((detail::Collection *)collection_to_access)                \
+                       ->get_element_1d(index);                                \
+                                                                               \
+    return (C_TYPE)element;                                                    \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(index_get_##TYPE_NAME##_2d)(                              \
+      const collection_ref collection_to_access,                               \
+      size_t index0,                                                           \
+      size_t index1) {                                                         \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    auto element = ((detail::Collection *)collection_to_access)                \
+                       ->get_element_2d(index0, index1);                       \
+                                                                               \
+    return (C_TYPE)element;                                                    \
+  }                                                                            \
+                                                                               \
+  __IMMUT_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  C_TYPE MEMOIR_FUNC(assoc_get_##TYPE_NAME##_1d)(                              \
+      const collection_ref collection_to_access,                               \
+      uint64_t key) {                                                          \
+    MEMOIR_ACCESS_CHECK(collection_to_access);                                 \
+                                                                               \
+    auto element =                                                             \
+        ((detail::Collection *)collection_to_access)->get_element_1d(key);     \
+                                                                               \
+    return (C_TYPE)element;                                                    \
+  }
+
+#include "types.def"
+
 } // extern "C"
 } // namespace memoir
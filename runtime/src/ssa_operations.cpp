@@ -56,6 +56,33 @@ size_t MEMOIR_FUNC(end)() {
   return -1;
 }
 
+__RUNTIME_ATTR
+void MEMOIR_FUNC(sequence_reserve)(const collection_ref collection,
+                                   size_t capacity) {
+  MEMOIR_ACCESS_CHECK(collection);
+  MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);
+
+  ((detail::Sequence *)collection)->reserve(capacity);
+}
+
+__IMMUT_ATTR
+__ALLOC_ATTR
+__RUNTIME_ATTR
+collection_ref MEMOIR_FUNC(clear)(const collection_ref collection) {
+  // Create an empty collection of the same type.
+  MEMOIR_ACCESS_CHECK(collection);
+
+  auto *type = ((detail::Object *)collection)->get_type();
+  if (type->getCode() == TypeCode::AssocArrayTy) {
+    return (collection_ref)(detail::AssocArray::create(type));
+  } else if (type->getCode() == TypeCode::SequenceTy) {
+    return (collection_ref)(
+        detail::SequenceAlloc::create(static_cast<SequenceType *>(type), 0));
+  }
+
+  MEMOIR_UNREACHABLE("Attempt to clear a collection of fixed size");
+}
+
 // Sequence operations.
 __IMMUT_ATTR
 __ALLOC_ATTR
@@ -63,13 +90,12 @@ __RUNTIME_ATTR
 collection_ref MEMOIR_FUNC(sequence_copy)(const collection_ref collection,
                                           size_t i,
                                           size_t j) {
-  // Split sequence, removing elements [i,j).
+  // Copy the elements [i,j) into a new sequence.
   MEMOIR_ACCESS_CHECK(collection);
 
   MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);
 
   auto *seq = (detail::Sequence *)(collection);
-  auto *seq_type = static_cast<SequenceType *>(seq->get_type());
 
   if (i == (size_t)-1) {
     i = seq->size();
@@ -81,16 +107,9 @@ collection_ref MEMOIR_FUNC(sequence_copy)(const collection_ref collection,
 
   MEMOIR_ASSERT((i <= j), "Reverse split is unsupported.");
 
-  auto m = j - i;
-
-  std::vector<uint64_t> new_container;
-  new_container.resize(m);
-  std::copy(seq->begin() + i, seq->begin() + j, new_container.begin());
+  auto *new_seq = seq->copy(i, j);
 
-  seq->erase(i, j);
-
-  return (collection_ref) new detail::SequenceAlloc(seq_type,
-                                                    std::move(new_container));
+  return (collection_ref)new_seq;
 }
 
 #define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
@@ -105,22 +124,14 @@ collection_ref MEMOIR_FUNC(sequence_copy)(const collection_ref collection,
     MEMOIR_ACCESS_CHECK(collection);                                           \
     MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);                       \
     auto *seq = (detail::Sequence *)(collection);                              \
-    auto *seq_type = static_cast<SequenceType *>(seq->get_type());             \
     if (index == (size_t)-1) {                                                 \
       index = seq->size();                                                     \
     }                                                                          \
                                                                                \
-    std::vector<uint64_t> new_container;                                       \
-    new_container.resize(seq->size() + 1);                                     \
-    std::copy(seq->cbegin(), seq->cbegin() + index, new_container.begin());    \
-    new_container[index] = (uint64_t)value;                                    \
-    std::copy(seq->cbegin() + index,                                           \
-              seq->cend(),                                                     \
-              new_container.begin() + index + 1);                              \
+    auto *new_seq = seq->copy(0, seq->size());                                 \
+    new_seq->insert(index, (uint64_t)value);                                   \
                                                                                \
-    return (collection_ref) new detail::SequenceAlloc(                         \
-        seq_type,                                                              \
-        std::move(new_container));                                             \
+    return (collection_ref)new_seq;                                            \
   }
 #include "types.def"
 
@@ -137,24 +148,15 @@ collection_ref MEMOIR_FUNC(sequence_insert)(
   MEMOIR_TYPE_CHECK(collection_to_insert, TypeCode::SequenceTy);
   auto *seq = (detail::Sequence *)(collection);
   auto *seq_to_insert = (detail::Sequence *)(collection_to_insert);
-  auto *seq_type = static_cast<SequenceType *>(seq->get_type());
 
   if (index == (size_t)(-1)) {
     index = seq->size();
   }
 
-  std::vector<uint64_t> new_container;
-  new_container.resize(seq->size() + seq_to_insert->size());
-  std::copy(seq->cbegin(), seq->cbegin() + index, new_container.begin());
-  std::copy(seq_to_insert->cbegin(),
-            seq_to_insert->cend(),
-            new_container.begin() + index);
-  std::copy(seq->cbegin() + index,
-            seq->cend(),
-            new_container.begin() + index + seq_to_insert->size());
-
-  return (collection_ref) new detail::SequenceAlloc(seq_type,
-                                                    std::move(new_container));
+  auto *new_seq = seq->copy(0, seq->size());
+  new_seq->insert(index, seq_to_insert);
+
+  return (collection_ref)new_seq;
 }
 __IMMUT_ATTR
 __ALLOC_ATTR
@@ -168,7 +170,6 @@ collection_ref MEMOIR_FUNC(sequence_remove)(const collection_ref collection,
   MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);
 
   auto *seq = (detail::Sequence *)(collection);
-  auto *seq_type = static_cast<SequenceType *>(seq->get_type());
 
   if (begin == (size_t)(-1)) {
     begin = seq->size();
@@ -178,15 +179,36 @@ collection_ref MEMOIR_FUNC(sequence_remove)(const collection_ref collection,
     end = seq->size();
   }
 
-  std::vector<uint64_t> new_container;
-  new_container.resize(seq->size() - (end - begin));
-  std::copy(seq->cbegin(), seq->cbegin() + begin, new_container.begin());
-  std::copy(seq->cbegin() + end, seq->cend(), new_container.begin() + begin);
+  auto *new_seq = seq->copy(0, seq->size());
+  new_seq->erase(begin, end);
 
-  return (collection_ref) new detail::SequenceAlloc(seq_type,
-                                                    std::move(new_container));
+  return (collection_ref)new_seq;
 }
 
+#define HANDLE_TYPE(TYPE_NAME, C_TYPE)                                         \
+  __IMMUT_ATTR                                                                 \
+  __ALLOC_ATTR                                                                 \
+  __RUNTIME_ATTR                                                               \
+  collection_ref MEMOIR_FUNC(sequence_fill_##TYPE_NAME)(                       \
+      C_TYPE value,                                                            \
+      const collection_ref collection,                                         \
+      size_t begin,                                                            \
+      size_t end) {                                                            \
+    /* Fill a range of a sequence with a single value. */                      \
+    MEMOIR_ACCESS_CHECK(collection);                                           \
+    MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);                       \
+    auto *seq = (detail::Sequence *)(collection);                              \
+    if (end == (size_t)-1) {                                                   \
+      end = seq->size();                                                       \
+    }                                                                          \
+                                                                               \
+    auto *new_seq = seq->copy(0, seq->size());                                 \
+    new_seq->fill(begin, end, (uint64_t)value);                                \
+                                                                               \
+    return (collection_ref)new_seq;                                            \
+  }
+#include "types.def"
+
 __IMMUT_ATTR
 __ALLOC_ATTR
 __RUNTIME_ATTR
@@ -204,7 +226,6 @@ const collection_pair MEMOIR_FUNC(sequence_swap)(
 
   auto *seq1 = (detail::Sequence *)(collection);
   auto *seq2 = (detail::Sequence *)(collection2);
-  auto *seq_type = static_cast<SequenceType *>(seq1->get_type());
 
   if (i == (size_t)(-1)) {
     i = seq1->size();
@@ -225,20 +246,14 @@ const collection_pair MEMOIR_FUNC(sequence_swap)(
 
   MEMOIR_ASSERT((j2 <= seq2->size()), "Buffer overflow on copy.");
 
-  std::vector<uint64_t> new1(seq1->cbegin(), seq1->cend());
-  std::vector<uint64_t> new2(seq2->cbegin(), seq2->cend());
+  auto *new1 = seq1->copy(0, seq1->size());
+  auto *new2 = seq2->copy(0, seq2->size());
 
-  auto it1 = new1.begin() + i;
-  auto it2 = new2.begin() + i2;
-  for (auto k = 0; k < m; ++k, ++it1, ++it2) {
-    std::swap(*it1, *it2);
-  }
+  new1->swap(i, j, new2, i2);
 
   collection_pair pair;
-  pair.first =
-      (collection_ref) new detail::SequenceAlloc(seq_type, std::move(new1));
-  pair.second =
-      (collection_ref) new detail::SequenceAlloc(seq_type, std::move(new2));
+  pair.first = (collection_ref)new1;
+  pair.second = (collection_ref)new2;
   return pair;
 }
 
@@ -256,7 +271,6 @@ collection_ref MEMOIR_FUNC(sequence_swap_within)(
   MEMOIR_TYPE_CHECK(collection, TypeCode::SequenceTy);
 
   auto *seq = (detail::Sequence *)(collection);
-  auto *seq_type = static_cast<SequenceType *>(seq->get_type());
 
   if (from_begin == (size_t)(-1)) {
     from_begin = seq->size();
@@ -277,18 +291,10 @@ collection_ref MEMOIR_FUNC(sequence_swap_within)(
 
   MEMOIR_ASSERT((to_end <= seq->size()), "Buffer overflow on copy.");
 
-  std::vector<uint64_t> new_container;
-  new_container.resize(seq->size());
-  std::copy(seq->cbegin(), seq->cend(), new_container.begin());
-
-  auto it1 = new_container.begin() + from_begin;
-  auto it2 = new_container.begin() + to_begin;
-  for (auto i = 0; i < m; ++i, ++it1, ++it2) {
-    std::swap(*it1, *it2);
-  }
+  auto *new_seq = seq->copy(0, seq->size());
+  new_seq->swap(from_begin, from_end, new_seq, to_begin);
 
-  return (collection_ref) new detail::SequenceAlloc(seq_type,
-                                                    std::move(new_container));
+  return (collection_ref)new_seq;
 }
 
 // Assoc operations.
@@ -319,11 +325,8 @@ collection_ref MEMOIR_FUNC(assoc_remove)(const collection_ref collection, ...) {
   va_start(args, collection);
 
   auto *assoc = (detail::AssocArray *)(collection);
-  auto *assoc_type = static_cast<AssocArrayType *>(assoc->get_type());
 
-  auto *new_assoc = new detail::AssocArray(assoc_type);
-  new_assoc->assoc_array.insert(assoc->assoc_array.cbegin(),
-                                assoc->assoc_array.cend());
+  auto *new_assoc = assoc->copy();
   new_assoc->remove_element(args);
 
   va_end(args);
@@ -342,11 +345,8 @@ collection_ref MEMOIR_FUNC(assoc_insert)(const collection_ref collection, ...) {
   va_start(args, collection);
 
   auto *assoc = (detail::AssocArray *)(collection);
-  auto *assoc_type = static_cast<AssocArrayType *>(assoc->get_type());
 
-  auto *new_assoc = new detail::AssocArray(assoc_type);
-  new_assoc->assoc_array.insert(assoc->assoc_array.cbegin(),
-                                assoc->assoc_array.cend());
+  auto *new_assoc = assoc->copy();
   new_assoc->get_element(args);
 
   va_end(args);
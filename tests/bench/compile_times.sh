@@ -33,8 +33,8 @@ END {
 }
 
 printf "%-20s ┃ %-20s\n" "" "# Collections" >> ${OUTPUT_FILE}
-printf "%-20s ┃ %-23s ┃ %-23s\n" "" "MemOIR" "LLVM" >> ${OUTPUT_FILE}
-printf "%-20s ┃ %-10s ┃ %-10s ┃ %-10s ┃ %-10s\n" "Benchmark" "O0" "O3" "O0" "O3" >> ${OUTPUT_FILE}
+printf "%-20s ┃ %-36s ┃ %-23s\n" "" "MemOIR" "LLVM" >> ${OUTPUT_FILE}
+printf "%-20s ┃ %-10s ┃ %-10s ┃ %-10s ┃ %-10s ┃ %-10s\n" "Benchmark" "O0" "O3" "SSA Destr." "O0" "O3" >> ${OUTPUT_FILE}
 for i in $(seq 1 21) ; do printf "━" >> ${OUTPUT_FILE} ; done
 printf "╋" >> ${OUTPUT_FILE}
 for i in $(seq 1 12) ; do printf "━" >> ${OUTPUT_FILE} ; done
@@ -44,6 +44,8 @@ printf "╋" >> ${OUTPUT_FILE}
 for i in $(seq 1 12) ; do printf "━" >> ${OUTPUT_FILE} ; done
 printf "╋" >> ${OUTPUT_FILE}
 for i in $(seq 1 12) ; do printf "━" >> ${OUTPUT_FILE} ; done
+printf "╋" >> ${OUTPUT_FILE}
+for i in $(seq 1 12) ; do printf "━" >> ${OUTPUT_FILE} ; done
 printf "\n" >> ${OUTPUT_FILE}
 
 
@@ -69,6 +71,14 @@ do
     MEMOIR_O3_MEDIAN="$(median ${TMP_FILE})"
     echo "" > ${TMP_FILE}
     
+    # MemOIR SSA destruction, dominated by the collection liveness analysis
+    for i in $(seq 1 ${NUM_RUNS}) ; do
+        2>&1 ${OPT} -time-passes --mut2immut --ssa-destruction ${IR_FILE} -disable-output | awk -v PASS="Destructs the MemOIR SSA form." -f pass_time.awk >> ${TMP_FILE}
+    done
+
+    MEMOIR_SSA_DESTRUCTION_MEDIAN="$(median ${TMP_FILE})"
+    echo "" > ${TMP_FILE}
+    
     # LLVM O0
     for i in $(seq 1 ${NUM_RUNS}) ; do
         2>&1 opt -time-passes -O0 ${IR_FILE} -disable-output | awk -f compile_times.awk >> ${TMP_FILE}
@@ -85,6 +95,6 @@ do
     LLVM_O3_MEDIAN="$(median ${TMP_FILE})"
     echo "" > ${TMP_FILE}
 
-    printf "%-20s ┃ %-10s ┃ %-10s ┃ %-10s ┃ %-10s\n" "${BENCH_NAME}" "${MEMOIR_O0_MEDIAN}" "${MEMOIR_O3_MEDIAN}" "${LLVM_O0_MEDIAN}" "${LLVM_O3_MEDIAN}" >> ${OUTPUT_FILE}
+    printf "%-20s ┃ %-10s ┃ %-10s ┃ %-10s ┃ %-10s ┃ %-10s\n" "${BENCH_NAME}" "${MEMOIR_O0_MEDIAN}" "${MEMOIR_O3_MEDIAN}" "${MEMOIR_SSA_DESTRUCTION_MEDIAN}" "${LLVM_O0_MEDIAN}" "${LLVM_O3_MEDIAN}" >> ${OUTPUT_FILE}
 
 done
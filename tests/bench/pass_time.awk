@@ -0,0 +1,15 @@
+BEGIN {
+  found=0
+}
+{
+  if (found) {
+    if (index($0, PASS) > 0) {
+      print $1 ;
+      found=0
+    }
+  } else {
+    if ($0 ~ /... Pass execution timing report .../) {
+      found=1
+    }
+  }
+}
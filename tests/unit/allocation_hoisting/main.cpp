@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 100
+#define M 20
+#define K 8
+
+int main() {
+  uint64_t total_size = 0;
+  uint64_t sum = 0;
+
+  for (uint64_t i = 0; i < N; ++i) {
+    auto scratch = memoir_allocate_assoc_array(memoir_u64_t, memoir_u64_t);
+
+    for (uint64_t j = 0; j < M; ++j) {
+      auto key = j % K;
+      if (!memoir_assoc_has(scratch, key)) {
+        memoir_assoc_insert(scratch, key);
+      }
+      memoir_assoc_write(u64, i + j, scratch, key);
+    }
+
+    total_size += memoir_size(scratch);
+    for (uint64_t k = 0; k < K; ++k) {
+      sum += memoir_assoc_read(u64, scratch, k);
+    }
+
+    memoir_delete_collection(scratch);
+  }
+
+  // If correct, this will print 800 52000.
+  printf("%lu %lu\n", total_size, sum);
+
+  return 0;
+}
@@ -0,0 +1,47 @@
+#include <cstdio>
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 1000
+#define K 10
+
+int main() {
+  auto counts = memoir_allocate_assoc_array(memoir_u64_t, memoir_u64_t);
+  auto sums = memoir_allocate_assoc_array(memoir_u64_t, memoir_u64_t);
+
+  for (uint64_t i = 0; i < N; ++i) {
+    auto key = i % K;
+    if (!memoir_assoc_has(counts, key)) {
+      memoir_assoc_insert(counts, key);
+      memoir_assoc_insert(sums, key);
+      memoir_assoc_write(u64, 0, counts, key);
+      memoir_assoc_write(u64, 0, sums, key);
+    }
+    memoir_assoc_write(u64,
+                       memoir_assoc_read(u64, counts, key) + 1,
+                       counts,
+                       key);
+    memoir_assoc_write(u64, memoir_assoc_read(u64, sums, key) + i, sums, key);
+  }
+
+  memoir_assoc_remove(counts, (uint64_t)0);
+  memoir_assoc_remove(sums, (uint64_t)0);
+
+  uint64_t total_count = 0;
+  uint64_t total_sum = 0;
+  for (uint64_t k = 1; k < K; ++k) {
+    total_count += memoir_assoc_read(u64, counts, k);
+    total_sum += memoir_assoc_read(u64, sums, k);
+  }
+
+  // If correct, this will print 9 900 450000.
+  printf("%lu %lu %lu\n", memoir_size(counts), total_count, total_sum);
+
+  memoir_delete_collection(counts);
+  memoir_delete_collection(sums);
+
+  return 0;
+}
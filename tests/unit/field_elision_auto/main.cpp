@@ -0,0 +1,38 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 1000
+
+// Field 1 is almost always zero, and should be selected for elision. Eliding
+// it does not change the output, so optcheck looks for its companion assoc.
+auto type = memoir_define_struct_type("Node", memoir_u64_t, memoir_u64_t);
+
+int main() {
+  auto seq = memoir_allocate_sequence(memoir_ref_t(type), N);
+
+  for (int i = 0; i < N; ++i) {
+    auto obj = memoir_allocate_struct(type);
+    memoir_struct_write(u64, i, obj, 0);
+    memoir_index_write(struct_ref, obj, seq, i);
+  }
+
+  auto first = memoir_index_read(struct_ref, seq, 0);
+  memoir_struct_write(u64, 42, first, 1);
+
+  uint64_t sum = 0;
+  for (int i = 0; i < N; ++i) {
+    auto obj = memoir_index_read(struct_ref, seq, i);
+    sum += memoir_struct_read(u64, obj, 0);
+  }
+
+  printf("Result:\n");
+  printf("%lu, %lu\n", sum, memoir_struct_read(u64, first, 1));
+
+  printf("Expected:\n");
+  printf("%lu, %lu\n", (uint64_t)(N * (N - 1) / 2), (uint64_t)42);
+
+  return 0;
+}
@@ -0,0 +1,41 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+// Fields 1 and 2 are elided together into a companion struct.
+auto objTy =
+    memoir_define_struct_type("Foo", memoir_u64_t, memoir_u64_t, memoir_u32_t);
+
+void update(memoir::Struct *obj) {
+  memoir_assert_struct_type(objTy, obj);
+
+  auto read1 = memoir_struct_read(u64, obj, 1);
+  auto read2 = memoir_struct_read(u32, obj, 2);
+  memoir_struct_write(u64, read1 + read2, obj, 1);
+
+  return;
+}
+
+int main() {
+  auto *obj = memoir_allocate_struct(objTy);
+
+  memoir_struct_write(u64, 1, obj, 0);
+  memoir_struct_write(u64, 22, obj, 1);
+  memoir_struct_write(u32, 333, obj, 2);
+
+  update(obj);
+
+  auto read0 = memoir_struct_read(u64, obj, 0);
+  auto read1 = memoir_struct_read(u64, obj, 1);
+  auto read2 = memoir_struct_read(u32, obj, 2);
+
+  printf("Result:\n");
+  printf("%lu, %lu, %u\n", read0, read1, read2);
+
+  printf("Expected:\n");
+  printf("%lu, %lu, %u\n", (uint64_t)1, (uint64_t)355, (uint32_t)333);
+
+  return 0;
+}
@@ -0,0 +1,40 @@
+#include <cstdio>
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 100
+
+int main() {
+  auto src = memoir_allocate_sequence(memoir_u64_t, N);
+  auto dst = memoir_allocate_sequence(memoir_u64_t, 2 * N);
+
+  for (int i = 0; i < N; ++i) {
+    memoir_index_write(u64, i, src, i);
+  }
+
+  // Fill the destination.
+  for (int i = 0; i < 2 * N; ++i) {
+    memoir_index_write(u64, 1, dst, i);
+  }
+
+  // Copy the source into the back half of the destination.
+  for (int i = 0; i < N; ++i) {
+    memoir_index_write(u64, memoir_index_read(u64, src, i), dst, N + i);
+  }
+
+  uint64_t sum = 0;
+  for (int i = 0; i < 2 * N; ++i) {
+    sum += memoir_index_read(u64, dst, i);
+  }
+
+  // If correct, this will print 5050.
+  printf("%lu\n", sum);
+
+  memoir_delete_collection(src);
+  memoir_delete_collection(dst);
+
+  return 0;
+}
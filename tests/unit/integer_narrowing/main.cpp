@@ -0,0 +1,42 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 1000
+
+// Field 1 only ever holds a byte, and should be narrowed.
+auto objTy = memoir_define_struct_type("Foo", memoir_u64_t, memoir_u64_t);
+
+int main() {
+  // Every element is masked to 16 bits, the sequence should be narrowed.
+  auto seq = memoir_allocate_sequence(memoir_u64_t, N);
+  for (uint64_t i = 0; i < N; ++i) {
+    memoir_index_write(u64, (i * 31) & 0xFFFF, seq, i);
+  }
+
+  auto obj = memoir_allocate_struct(objTy);
+  memoir_struct_write(u64, (uint64_t)-1, obj, 0);
+  memoir_struct_write(u64, N & 0xFF, obj, 1);
+
+  uint64_t sum = 0;
+  for (uint64_t i = 0; i < N; ++i) {
+    sum += memoir_index_read(u64, seq, i);
+  }
+
+  printf("Result:\n");
+  printf("%lu, %lu, %lu\n",
+         sum,
+         memoir_struct_read(u64, obj, 0),
+         memoir_struct_read(u64, obj, 1));
+
+  uint64_t expected = 0;
+  for (uint64_t i = 0; i < N; ++i) {
+    expected += (i * 31) & 0xFFFF;
+  }
+  printf("Expected:\n");
+  printf("%lu, %lu, %lu\n", expected, (uint64_t)-1, (uint64_t)(N & 0xFF));
+
+  return 0;
+}
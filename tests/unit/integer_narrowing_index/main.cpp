@@ -0,0 +1,44 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 1000
+
+int main() {
+  // Every element is masked to a byte, the sequence should be narrowed to 8
+  // bits and accessed through the narrow single-index entry points.
+  auto bytes = memoir_allocate_sequence(memoir_u64_t, N);
+  for (uint64_t i = 0; i < N; ++i) {
+    memoir_index_write(u64, (i * 7) & 0xFF, bytes, i);
+  }
+
+  // Every element is masked to 20 bits, the sequence should be narrowed to 32
+  // bits.
+  auto words = memoir_allocate_sequence(memoir_u64_t, N);
+  for (uint64_t i = 0; i < N; ++i) {
+    memoir_index_write(u64, (i * 4099) & 0xFFFFF, words, i);
+  }
+
+  uint64_t byte_sum = 0;
+  uint64_t word_sum = 0;
+  for (uint64_t i = 0; i < N; ++i) {
+    byte_sum += memoir_index_read(u64, bytes, i);
+    word_sum += memoir_index_read(u64, words, i);
+  }
+
+  printf("Result:\n");
+  printf("%lu, %lu\n", byte_sum, word_sum);
+
+  uint64_t expected_bytes = 0;
+  uint64_t expected_words = 0;
+  for (uint64_t i = 0; i < N; ++i) {
+    expected_bytes += (i * 7) & 0xFF;
+    expected_words += (i * 4099) & 0xFFFFF;
+  }
+  printf("Expected:\n");
+  printf("%lu, %lu\n", expected_bytes, expected_words);
+
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include <cstdio>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define NUM_VALUES 1000
+#define NUM_BUCKETS 16
+
+int main() {
+  auto *histogram = memoir_allocate_assoc_array(memoir_u64_t, memoir_u64_t);
+
+  for (uint64_t i = 0; i < NUM_VALUES; i++) {
+    uint64_t bucket = (i * 7) % NUM_BUCKETS;
+    if (!memoir_assoc_has(histogram, bucket)) {
+      memoir_assoc_insert(histogram, bucket);
+    }
+    auto count = memoir_assoc_read(u64, histogram, bucket);
+    memoir_assoc_write(u64, count + 1, histogram, bucket);
+  }
+
+  uint64_t total = 0;
+  for (uint64_t bucket = 0; bucket < NUM_BUCKETS; bucket++) {
+    total += memoir_assoc_read(u64, histogram, bucket);
+  }
+
+  // Remove the odd buckets, the folded sequence must forget them.
+  for (uint64_t i = 0; i < NUM_BUCKETS / 2; i++) {
+    uint64_t bucket = ((i * 2) + 1) % NUM_BUCKETS;
+    memoir_assoc_remove(histogram, bucket);
+  }
+
+  uint64_t present = 0;
+  for (uint64_t i = 0; i < NUM_BUCKETS; i++) {
+    uint64_t bucket = i % NUM_BUCKETS;
+    if (memoir_assoc_has(histogram, bucket)) {
+      present++;
+    }
+  }
+
+  // Reinserted keys start over from the default value.
+  memoir_assoc_insert(histogram, 3);
+
+  printf(" Result:\n");
+  printf("  total = %lu\n", total);
+  printf("  present = %lu\n", present);
+  printf("  has 2 = %s\n", memoir_assoc_has(histogram, 2) ? "true" : "false");
+  printf("  has 3 = %s\n", memoir_assoc_has(histogram, 3) ? "true" : "false");
+  printf("  has 5 = %s\n", memoir_assoc_has(histogram, 5) ? "true" : "false");
+  printf("  read 3 = %lu\n", memoir_assoc_read(u64, histogram, 3));
+
+  printf(" Expected:\n");
+  printf("  total = %lu\n", (uint64_t)NUM_VALUES);
+  printf("  present = %lu\n", (uint64_t)NUM_BUCKETS / 2);
+  printf("  has 2 = true\n");
+  printf("  has 3 = true\n");
+  printf("  has 5 = false\n");
+  printf("  read 3 = 0\n");
+
+  return 0;
+}
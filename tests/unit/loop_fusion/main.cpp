@@ -0,0 +1,40 @@
+#include <cstdio>
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 100
+
+auto type = memoir_define_struct_type("Foo", memoir_u64_t, memoir_u64_t);
+
+int main() {
+  auto seq = memoir_allocate_sequence(type, N);
+
+  for (int i = 0; i < N; ++i) {
+    auto obj = memoir_index_get(struct, seq, i);
+    memoir_struct_write(u64, i, obj, 0);
+  }
+
+  for (int i = 0; i < N; ++i) {
+    auto obj = memoir_index_get(struct, seq, i);
+    auto val = memoir_struct_read(u64, obj, 0);
+    memoir_struct_write(u64, 2 * val, obj, 1);
+  }
+
+  printf("Result:\n");
+  for (int i = 0; i < 10; ++i) {
+    auto obj = memoir_index_get(struct, seq, i);
+    printf("(%lu, %lu),",
+           memoir_struct_read(u64, obj, 0),
+           memoir_struct_read(u64, obj, 1));
+  }
+  printf("\n");
+
+  printf("Expected:\n");
+  for (int i = 0; i < 10; ++i) {
+    printf("(%d, %d),", i, 2 * i);
+  }
+  printf("\n");
+}
@@ -0,0 +1,29 @@
+#include <cstdio>
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 1000
+
+int main() {
+  auto seq = memoir_allocate_sequence(memoir_u64_t, 0);
+
+  for (int i = 0; i < N; ++i) {
+    memoir_seq_insert(u64, i, seq, memoir_end());
+    memoir_seq_insert(u64, 1, seq, memoir_end());
+  }
+
+  uint64_t sum = 0;
+  for (size_t i = 0; i < memoir_size(seq); ++i) {
+    sum += memoir_index_read(u64, seq, i);
+  }
+
+  // If correct, this will print 2000 500500.
+  printf("%lu %lu\n", memoir_size(seq), sum);
+
+  memoir_delete_collection(seq);
+
+  return 0;
+}
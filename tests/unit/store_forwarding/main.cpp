@@ -0,0 +1,31 @@
+#include <cstdio>
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+#define N 100
+
+int main() {
+  auto seq = memoir_allocate_sequence(memoir_u64_t, N);
+  auto map = memoir_allocate_assoc_array(memoir_u64_t, memoir_u64_t);
+
+  uint64_t sum = 0;
+  for (int i = 0; i < N; ++i) {
+    memoir_index_write(u64, i * i, seq, i);
+    sum += memoir_index_read(u64, seq, i);
+
+    memoir_assoc_insert(map, i);
+    memoir_assoc_write(u64, 2 * i, map, i);
+    sum += memoir_assoc_read(u64, map, i);
+  }
+
+  // If correct, this will print 338250.
+  printf("%lu\n", sum);
+
+  memoir_delete_collection(seq);
+  memoir_delete_collection(map);
+
+  return 0;
+}
@@ -0,0 +1,43 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+// The narrow fields are interleaved with wide ones, the layout should group
+// the i2 fields into a shared bit field word and order the rest by size.
+auto objTy = memoir_define_struct_type("Foo",
+                                       memoir_u8_t,
+                                       memoir_i2_t,
+                                       memoir_u64_t,
+                                       memoir_i2_t,
+                                       memoir_u32_t);
+
+int main() {
+  auto myObj = memoir_allocate_struct(objTy);
+
+  memoir_struct_write(u8, 12, myObj, 0);
+  memoir_struct_write(i2, -1, myObj, 1);
+  memoir_struct_write(u64, 345, myObj, 2);
+  memoir_struct_write(i2, 1, myObj, 3);
+  memoir_struct_write(u32, 678, myObj, 4);
+
+  auto read0 = memoir_struct_read(u8, myObj, 0);
+  auto read1 = memoir_struct_read(i2, myObj, 1);
+  auto read2 = memoir_struct_read(u64, myObj, 2);
+  auto read3 = memoir_struct_read(i2, myObj, 3);
+  auto read4 = memoir_struct_read(u32, myObj, 4);
+
+  printf("Result:\n");
+  printf("%u, %d, %lu, %d, %u\n",
+         (unsigned)read0,
+         (int)read1,
+         read2,
+         (int)read3,
+         read4);
+
+  printf("Expected:\n");
+  printf("12, -1, 345, 1, 678\n");
+
+  return 0;
+}
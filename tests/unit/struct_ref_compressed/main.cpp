@@ -0,0 +1,50 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+// With compressed references, both reference fields of Bar are stored as
+// offsets into the arena of Foo.
+auto innerTy = memoir_define_struct_type("Foo", memoir_u32_t, memoir_u32_t);
+
+auto objTy = memoir_define_struct_type("Bar",
+                                       memoir_u32_t,
+                                       memoir_ref_t(innerTy),
+                                       memoir_ref_t(innerTy));
+
+int main() {
+  // Churn through the arena, so that freed structs are handed out again.
+  for (uint32_t i = 0; i < 1000; ++i) {
+    auto tmpObj = memoir_allocate_struct(innerTy);
+    memoir_struct_write(u32, i, tmpObj, 0);
+    memoir_delete_struct(tmpObj);
+  }
+
+  auto innerObj = memoir_allocate_struct(innerTy);
+
+  auto myObj = memoir_allocate_struct(objTy);
+
+  memoir_struct_write(u32, 123, myObj, 0);
+  memoir_struct_write(struct_ref, innerObj, myObj, 1);
+  memoir_struct_write(struct_ref, nullptr, myObj, 2);
+
+  // Store through the reloaded reference.
+  auto deref = memoir_struct_read(struct_ref, myObj, 1);
+  memoir_struct_write(u32, 456, deref, 0);
+  memoir_struct_write(u32, 789, deref, 1);
+
+  auto read0 = memoir_struct_read(u32, myObj, 0);
+  auto read1 = memoir_struct_read(u32, innerObj, 0);
+  auto read2 = memoir_struct_read(u32, innerObj, 1);
+  auto same = (memoir_struct_read(struct_ref, myObj, 1) == innerObj);
+  auto null = (memoir_struct_read(struct_ref, myObj, 2) == nullptr);
+
+  printf("Result:\n");
+  printf("%u, %u, %u, %d, %d\n", read0, read1, read2, same, null);
+
+  printf("Expected:\n");
+  printf("123, 456, 789, 1, 1\n");
+
+  return 0;
+}
@@ -0,0 +1,38 @@
+#include <iostream>
+
+#include "cmemoir/cmemoir.h"
+
+using namespace memoir;
+
+// Field 0 is accessed in the loop, fields 1 and 2 only once. This test is
+// compiled with the counts of a profiling run, so fields 1 and 2 are cold and
+// split out of line, and their accesses go through the cold struct.
+auto objTy =
+    memoir_define_struct_type("Foo", memoir_u64_t, memoir_u64_t, memoir_u32_t);
+
+int main() {
+  auto *obj = memoir_allocate_struct(objTy);
+
+  memoir_struct_write(u64, 0, obj, 0);
+  memoir_struct_write(u64, 22, obj, 1);
+  memoir_struct_write(u32, 333, obj, 2);
+
+  for (uint64_t i = 0; i < 1000; ++i) {
+    auto read0 = memoir_struct_read(u64, obj, 0);
+    memoir_struct_write(u64, read0 + i, obj, 0);
+  }
+
+  auto read0 = memoir_struct_read(u64, obj, 0);
+  auto read1 = memoir_struct_read(u64, obj, 1);
+  auto read2 = memoir_struct_read(u32, obj, 2);
+
+  memoir_delete_struct(obj);
+
+  printf("Result:\n");
+  printf("%lu, %lu, %u\n", read0, read1, read2);
+
+  printf("Expected:\n");
+  printf("%lu, %lu, %u\n", (uint64_t)499500, (uint64_t)22, (uint32_t)333);
+
+  return 0;
+}